@@ -34,7 +34,7 @@
 #define MAX_KNOWN_SEQUENCES 50      ///< Maximum number of known sequences
 #endif
 #ifndef MAX_HTTP_RESPONSE_SIZE
-#define MAX_HTTP_RESPONSE_SIZE 8192 ///< Maximum HTTP response size
+#define MAX_HTTP_RESPONSE_SIZE 65536 ///< Largest catalog accepted, in decompressed bytes (parsed as it streams, never held whole)
 #endif
 #ifndef AUDIO_FILES_DIR
 #define AUDIO_FILES_DIR "/audio"    ///< Directory for cached audio files
@@ -57,6 +57,24 @@
 #ifndef DOWNLOAD_QUEUE_CHECK_INTERVAL_MS
 #define DOWNLOAD_QUEUE_CHECK_INTERVAL_MS 1000  ///< Interval between download queue processing (milliseconds)
 #endif
+#ifndef DOWNLOAD_PROGRESS_EVENT_MS
+#define DOWNLOAD_PROGRESS_EVENT_MS 500  ///< Interval between download progress events on /events
+#endif
+#ifndef CATALOG_LOAD_TASK_STACK
+#define CATALOG_LOAD_TASK_STACK 8192    ///< Boot-time catalog load (JSON parse of the cached catalog)
+#endif
+#ifndef CATALOG_LOAD_TASK_PRIORITY
+#define CATALOG_LOAD_TASK_PRIORITY 1
+#endif
+#ifndef CATALOG_LOAD_TASK_CORE
+#define CATALOG_LOAD_TASK_CORE 0    ///< Away from setup() and the audio tasks
+#endif
+#ifndef CATALOG_STREAM_TIMEOUT_MS
+#define CATALOG_STREAM_TIMEOUT_MS 5000  ///< A catalog download silent this long is abandoned
+#endif
+#ifndef CATALOG_READ_TIMEOUT_MS
+#define CATALOG_READ_TIMEOUT_MS 100 ///< Longest visitAudioKey()/visitDownloadItem() wait while the catalog is replaced
+#endif
 
 
 // ============================================================================
@@ -74,6 +92,27 @@ struct AudioFile
     const char *path;        ///< Additional path/URL information
 };
 
+/**
+ * @brief Structure for audio download queue items
+ */
+struct AudioDownloadItem
+{
+    char url[256];          ///< Original URL to download
+    char localPath[128];    ///< Local SD card path for the file
+    char description[64];   ///< Description for logging
+    bool inProgress;        ///< Whether download is currently in progress
+};
+
+enum AudioDownloadState
+{
+    AUDIO_DOWNLOAD_PENDING,
+    AUDIO_DOWNLOAD_IN_PROGRESS,
+    AUDIO_DOWNLOAD_DONE         ///< Processed (downloaded, or skipped after an error)
+};
+
+typedef void (*AudioKeyVisitor)(const AudioFile& file, void* context);
+typedef void (*DownloadItemVisitor)(const AudioDownloadItem& item, AudioDownloadState state, void* context);
+
 // ============================================================================
 // FUNCTION DECLARATIONS
 // ============================================================================
@@ -81,29 +120,45 @@ struct AudioFile
 /**
  * @brief Initialize the known sequence processor
  * 
- * Loads cached sequences from SD card if available.
- * Call this during setup().
+ * Starts loading cached sequences from SD card on a background task, so
+ * the rest of setup() can run meanwhile. Call this during setup() once the
+ * SD card is set up (after kit.begin()). Until the load has finished the
+ * task owns the catalog: loop-task code must check waitForAudioCatalog(0)
+ * before using it, and downloadAudio() fails.
  */
 void initializeAudioFileManager();
 
+/**
+ * @brief Wait for the load started by initializeAudioFileManager()
+ * @return true once the load has finished (found a cache or not), false on timeout
+ */
+bool waitForAudioCatalog(uint32_t timeoutMs);
+
 /**
  * @brief Download known sequences from remote server
- * @return true if download successful, false otherwise
+ * @param force Download even if the cached copy is still fresh
+ * @return true if download successful, false otherwise (also while the
+ *         boot-time SD load is still running)
  * 
  * Makes HTTP GET request to configured URL to download sequence definitions.
- * Only downloads if cache is stale and WiFi is connected.
+ * Only downloads if cache is stale (or force is set) and WiFi is connected.
  * Automatically saves to SD card for caching.
  * 
+ * The request accepts gzip; a compressed response is inflated and parsed
+ * as it arrives, one entry at a time (see catalog_stream.h). The current
+ * catalog is only replaced once the new one has parsed completely.
+ * 
  * Expected JSON format:
  * {
+ *   "_base": "<URL prefix>",       (optional, before the entries)
  *   "<DTMF code>": {
  *     "description": "<description>",
  *     "type": "<type>",
- *     "path": "<path>"
+ *     "path": "<path>"             (relative paths are joined to "_base")
  *   }
  * }
  */
-bool downloadAudio();
+bool downloadAudio(bool force = false);
 
 /**
  * @brief Check if a sequence is in the known sequences list
@@ -136,6 +191,15 @@ void listAudioKeys();
  */
 int getAudioKeyCount();
 
+/**
+ * @brief Call visitor with one catalog entry, from any task
+ * @param index Entry index, from 0
+ * @return false past the last entry, or if the catalog stayed locked for
+ *         CATALOG_READ_TIMEOUT_MS while being replaced
+ * The entry is only valid inside the visitor; copy anything kept.
+ */
+bool visitAudioKey(int index, AudioKeyVisitor visitor, void* context);
+
 /**
  * @brief Clear all known sequences from memory and SD card
  * 
@@ -182,6 +246,13 @@ void listDownloadQueue();
  */
 void clearDownloadQueue();
 
+/**
+ * @brief Call visitor with one download queue item and its state, from any task
+ * @param index Item index, from 0 (processed items come first)
+ * @return false past the last item, or if the queue stayed locked for CATALOG_READ_TIMEOUT_MS
+ */
+bool visitDownloadItem(int index, DownloadItemVisitor visitor, void* context);
+
 /**
  * @brief Check if download queue is empty
  * @return true if no items remain to process, false otherwise
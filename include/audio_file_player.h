@@ -17,6 +17,7 @@
 #include <Arduino.h>
 #include "AudioTools/AudioLibs/AudioBoardStream.h"
 #include "AudioTools.h"
+#include "audio_mixer.h"
 
 // ============================================================================
 // CONSTANTS AND CONFIGURATION
@@ -30,30 +31,157 @@
 #define AUDIO_VOLUME_EEPROM_ADDRESS 100  ///< EEPROM address for volume storage
 #endif
 
+#ifndef AUDIO_RING_BUFFER_SIZE
+#define AUDIO_RING_BUFFER_SIZE (32 * 1024)  ///< Mixed PCM ring buffer size in bytes (PSRAM)
+#endif
+
+#ifndef AUDIO_RING_TARGET_BYTES
+#define AUDIO_RING_TARGET_BYTES (16 * 1024) ///< Mixed audio kept ahead of I2S (bounds trigger latency)
+#endif
+
+#ifndef AUDIO_OUTPUT_BLOCK_SIZE
+#define AUDIO_OUTPUT_BLOCK_SIZE (AUDIO_MIX_BLOCK_FRAMES * 4) ///< Bytes handed to I2S per output write
+#endif
+
+#ifndef AUDIO_PREFILL_BYTES
+#define AUDIO_PREFILL_BYTES (8 * 1024)      ///< Bytes buffered before output starts
+#endif
+
+#ifndef AUDIO_TASK_CORE
+#define AUDIO_TASK_CORE 1                   ///< Core for the mixer and output tasks
+#endif
+
+#ifndef AUDIO_OUTPUT_TASK_PRIORITY
+#define AUDIO_OUTPUT_TASK_PRIORITY 10       ///< Output task priority (above loopTask)
+#endif
+
+#ifndef AUDIO_MIX_TASK_PRIORITY
+#define AUDIO_MIX_TASK_PRIORITY 5           ///< Decode/mix task priority (above loopTask)
+#endif
+
+#ifndef AUDIO_OUTPUT_TASK_STACK
+#define AUDIO_OUTPUT_TASK_STACK 4096
+#endif
+
+#ifndef AUDIO_MIX_TASK_STACK
+#define AUDIO_MIX_TASK_STACK 8192
+#endif
+
+#ifndef AUDIO_COMMAND_QUEUE_LENGTH
+#define AUDIO_COMMAND_QUEUE_LENGTH 8        ///< Pending play/stop/volume commands
+#endif
+
+#ifndef AUDIO_CLIP_QUEUE_LENGTH
+#define AUDIO_CLIP_QUEUE_LENGTH 8           ///< Clips waiting in the playback queue
+#endif
+
+#ifndef AUDIO_KEY_QUEUE_LENGTH
+#define AUDIO_KEY_QUEUE_LENGTH 8            ///< Deferred play-by-key requests waiting for loop()
+#endif
+
+#ifndef AUDIO_KEY_MAX_LENGTH
+#define AUDIO_KEY_MAX_LENGTH 32             ///< Max audio key length including terminator
+#endif
+
+#define AUDIO_PRIORITY_LOW 0                ///< Background/ambient clips
+#define AUDIO_PRIORITY_NORMAL 1             ///< Default clip priority
+#define AUDIO_PRIORITY_HIGH 2               ///< Clips that should jump the queue (e.g. results)
+
+#ifndef DEFAULT_AUDIO_MIX_POLICY
+#define DEFAULT_AUDIO_MIX_POLICY AUDIO_MIX_PREEMPT
+#endif
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * @brief What to do with a new clip while another one is playing
+ */
+enum AudioMixPolicy
+{
+    AUDIO_MIX_PREEMPT,  ///< Fade out everything playing and start the new clip now
+    AUDIO_MIX_QUEUE,    ///< Queue the clip; it follows the current one gaplessly
+    AUDIO_MIX_OVERLAY   ///< Mix the new clip on top of what is playing
+};
+
+/**
+ * @brief Runtime counters for the audio pipeline
+ */
+struct AudioPipelineStats
+{
+    uint32_t underruns;         ///< Output blocks that found the ring short while mixing
+    uint32_t blocksWritten;     ///< Blocks written to the I2S output
+    uint32_t ringFillBytes;     ///< Current decoded bytes waiting in the ring
+    uint32_t ringLowWaterBytes; ///< Lowest ring fill seen during playback since last reset
+    uint32_t ringCapacityBytes; ///< Ring buffer capacity
+    bool ringInPsram;           ///< Whether the ring buffer lives in PSRAM
+    uint32_t queuedClips;       ///< Clips waiting in the playback queue
+    uint32_t clipsDropped;      ///< Clips dropped or evicted because the queue was full
+    uint32_t keyRequestsDropped;    ///< Play-by-key requests lost because the key queue was full
+    uint32_t lastInputToEnqueueUs;  ///< Input edge to play request queued (triggerAudioByKey)
+    uint32_t maxInputToEnqueueUs;
+    uint32_t lastEnqueueToSoundUs;  ///< Play request queued to its first sample leaving the ring
+    uint32_t maxEnqueueToSoundUs;
+};
+
 // ============================================================================
 // FUNCTION DECLARATIONS
 // ============================================================================
 
 /**
  * @brief Initialize the audio player system
- * @param kit Reference to the AudioBoardStream
- * @param source Reference to the audio source
- * @param decoder Reference to the audio decoder
- * 
- * Sets up the audio player with the provided source and decoder.
- * Call this after initializeAudioFileManager().
+ * @param source Reference to the audio source (mounts the filesystem voices read from)
+ * @param output Reference to the audio output (e.g. the AudioBoardStream)
+ *
+ * Sets up the mixer and starts the mix and output tasks on AUDIO_TASK_CORE.
+ * Mixed PCM is staged in a PSRAM ring buffer, so playback does not depend
+ * on how often loop() runs.
  */
-void initAudioFilePlayer(AudioSource &source, AudioStream &output, AudioDecoder &decoder);
+void initAudioFilePlayer(AudioSource &source, AudioStream &output);
 
 /**
- * @brief Start playing an audio file
+ * @brief Start playing an audio file with the default mix policy
  * @param filePath Path to the audio file to play
- * @return true if playback started, false otherwise
- * 
- * Non-blocking call. Use copyAudioData() in loop to continue playback.
+ * @return true if the play command was queued, false otherwise
+ *
+ * Non-blocking call. Sends a play command to the audio task.
  */
 bool startAudioPlayback(const char* filePath);
 
+/**
+ * @brief Start playing an audio file
+ * @param filePath Path to the audio file to play
+ * @param policy How to treat clips that are already playing
+ * @param gain Voice gain (0.0 to 1.0), applied before the master volume
+ * @return true if the play command was queued, false otherwise
+ */
+bool startAudioPlayback(const char* filePath, AudioMixPolicy policy, float gain = 1.0f);
+
+/**
+ * @brief Queue an audio file behind what is playing
+ * @param filePath Path to the audio file to play
+ * @param priority Higher priorities are played first; equal priorities in order
+ * @param gain Voice gain (0.0 to 1.0), applied before the master volume
+ * @return true if the play command was queued, false otherwise
+ *
+ * Queued clips are chained onto the running voice when it reaches end of
+ * file, so the decoder and output stay open and there is no restart gap.
+ * The queue holds AUDIO_CLIP_QUEUE_LENGTH clips; when it is full a new clip
+ * only gets in by evicting a lower-priority one.
+ */
+bool queueAudioPlayback(const char* filePath, uint8_t priority = AUDIO_PRIORITY_NORMAL, float gain = 1.0f);
+
+/**
+ * @brief Set the policy used by startAudioPlayback(path) and playAudioByKey(key)
+ */
+void setAudioMixPolicy(AudioMixPolicy policy);
+
+/**
+ * @brief Get the default mix policy
+ */
+AudioMixPolicy getAudioMixPolicy();
+
 /**
  * @brief Stop current audio playback
  */
@@ -69,7 +197,8 @@ bool isAudioPlaying();
  * @brief Set the audio volume
  * @param volume Volume level (0.0 to 1.0)
  * 
- * Sets the volume and saves it to EEPROM for persistence.
+ * Sets the volume and saves it through the write-behind settings store,
+ * so ramping the volume does not write flash on every step.
  */
 void setVolume(float volume);
 
@@ -80,18 +209,58 @@ void setVolume(float volume);
 float getVolume();
 
 /**
- * @brief Copy audio data (call this in main loop during playback)
+ * @brief Start deferred play-by-key requests and poll playback state (call this in main loop)
  * @return true if still playing, false if finished
+ *
+ * Key lookup and SD checks for playAudioByKey()/queueAudioByKey() happen
+ * here, outside whatever code requested the sound. Mixing and output run in
+ * their own tasks.
  */
 bool processAudioFile();
 
+/**
+ * @brief Get a snapshot of the audio pipeline counters
+ */
+AudioPipelineStats getAudioPipelineStats();
+
+/**
+ * @brief Reset the underrun and low-water counters
+ */
+void resetAudioPipelineStats();
+
 /**
  * @brief Play an audio file by key
  * @param key Audio key to look up and play
- * @return true if playback started, false if key not found or error
+ * @return true if the request was queued
  * 
- * Looks up the key in audio_file_manager and plays the associated file.
+ * Only records the request; the next processAudioFile() looks up the key in
+ * audio_file_manager and plays the associated file with the default mix
+ * policy. Cheap enough to call from input handling.
  */
 bool playAudioByKey(const char* key);
 
+/**
+ * @brief Play an audio file by key with an explicit mix policy (deferred, see playAudioByKey(key))
+ */
+bool playAudioByKey(const char* key, AudioMixPolicy policy, float gain = 1.0f);
+
+/**
+ * @brief Play an audio file by key in response to an input event
+ * @param key Audio key to look up and play
+ * @param inputUs esp_timer_get_time() of the input that caused the sound
+ * @return true if the request was queued
+ *
+ * Like playAudioByKey(key), and records input-to-enqueue and
+ * enqueue-to-sound latency in the pipeline stats.
+ */
+bool triggerAudioByKey(const char* key, int64_t inputUs);
+
+/**
+ * @brief Queue an audio file by key (deferred, see queueAudioPlayback())
+ *
+ * e.g. queueAudioByKey("locked_in"); queueAudioByKey("yes") plays the two
+ * back to back without a gap.
+ */
+bool queueAudioByKey(const char* key, uint8_t priority = AUDIO_PRIORITY_NORMAL, float gain = 1.0f);
+
 #endif // AUDIO_FILE_PLAYER_H
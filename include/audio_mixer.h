@@ -0,0 +1,177 @@
+/**
+ * @file audio_mixer.h
+ * @brief Multi-voice fixed-point audio mixer
+ *
+ * Each voice owns an open file, an MP3 decoder and a small decoded PCM
+ * buffer. The mixer sums active voices block by block in Q15 fixed point
+ * (see dsp_kernels.h), with per-voice gain and short linear fades on start
+ * and stop so voices can be preempted without clicks.
+ *
+ * All functions except getAudioMixerStats() must be called from the audio
+ * task that owns the mixer.
+ *
+ * @date 2025
+ */
+
+#ifndef AUDIO_MIXER_H
+#define AUDIO_MIXER_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <SD_MMC.h>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#ifndef AUDIO_MIXER_VOICES
+#define AUDIO_MIXER_VOICES 3                ///< Number of simultaneous voices
+#endif
+
+#ifndef AUDIO_MIXER_FS
+#define AUDIO_MIXER_FS SD_MMC               ///< Filesystem voices open their files from
+#endif
+
+#ifndef AUDIO_MIXER_SAMPLE_RATE
+#define AUDIO_MIXER_SAMPLE_RATE 44100       ///< Mix rate until the first clip reports its own
+#endif
+
+#ifndef AUDIO_MIX_BLOCK_FRAMES
+#define AUDIO_MIX_BLOCK_FRAMES 256          ///< Stereo frames mixed per block
+#endif
+
+#ifndef AUDIO_FADE_MS
+#define AUDIO_FADE_MS 5                     ///< Fade-in/fade-out length for voice start/stop
+#endif
+
+#ifndef AUDIO_VOICE_PCM_BUFFER
+#define AUDIO_VOICE_PCM_BUFFER (16 * 1024)  ///< Decoded PCM buffered per voice
+#endif
+
+#ifndef AUDIO_VOICE_READ_CHUNK
+#define AUDIO_VOICE_READ_CHUNK 512          ///< Most encoded bytes fed to a decoder at a time
+#endif
+
+#ifndef AUDIO_MIX_FRAC_BITS
+#define AUDIO_MIX_FRAC_BITS 4               ///< Extra fraction bits kept on the mix bus
+#endif
+
+#ifndef AUDIO_MIX_DITHER
+#define AUDIO_MIX_DITHER 1                  ///< TPDF-dither the mix bus down to 16 bit
+#endif
+
+#ifndef AUDIO_GAP_SILENCE_THRESHOLD
+#define AUDIO_GAP_SILENCE_THRESHOLD 16      ///< Max |sample| counted as silence when measuring clip gaps
+#endif
+
+#define AUDIO_GAIN_UNITY_Q15 32768          ///< Unity gain in Q15
+
+/**
+ * @brief Supplies the next clip for a chainable voice that reached end of file
+ * @param path Output buffer for the next file path
+ * @param pathLen Size of the path buffer
+ * @param gainQ15 Output gain for the next clip (Q15)
+ * @return true if a clip was supplied
+ */
+typedef bool (*AudioChainCallback)(char* path, size_t pathLen, int32_t* gainQ15);
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * @brief Mixer counters
+ */
+struct AudioMixerStats
+{
+    uint8_t activeVoices;       ///< Voices currently producing audio
+    uint32_t voicesStarted;     ///< Voices started since boot
+    uint32_t voicesStolen;      ///< Voices cut short because every slot was busy
+    uint32_t blocksMixed;       ///< Blocks rendered since boot
+    uint32_t lastMixMicros;     ///< Time spent rendering the last block
+    uint32_t maxMixMicros;      ///< Worst block render time since boot
+    uint32_t voiceBlocksMixed;  ///< Sum of active voices over all rendered blocks
+    uint64_t totalMixMicros;    ///< Total render time since boot
+    uint32_t clipsChained;      ///< Clips started gaplessly on an already running voice
+    uint32_t gapsMeasured;      ///< Clip boundaries whose gap has been measured
+    uint32_t lastGapFrames;     ///< Silent/missing frames at the last clip boundary
+    uint32_t maxGapFrames;      ///< Worst clip boundary gap since boot
+    uint32_t pcmBytesDropped;   ///< Decoded PCM that did not fit a voice buffer
+};
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+/**
+ * @brief Allocate voices and decoders
+ * @return true if every voice was allocated
+ */
+bool initAudioMixer();
+
+/**
+ * @brief Start a clip on a free voice
+ * @param path File path on AUDIO_MIXER_FS
+ * @param gainQ15 Voice gain in Q15 (AUDIO_GAIN_UNITY_Q15 = unity)
+ * @param chainable Continue this voice with clips from the chain callback
+ * @return Voice index, or -1 if the file could not be opened
+ *
+ * If every voice is busy the oldest one is stolen, preferring voices that
+ * are already fading out. Only the most recently started chainable voice
+ * chains; starting a new one clears the flag on the others.
+ */
+int audioMixerStartVoice(const char* path, int32_t gainQ15, bool chainable = false);
+
+/**
+ * @brief Set the callback that supplies gapless follow-on clips
+ *
+ * When a chainable voice reaches end of file it asks the callback for the
+ * next clip and keeps feeding the same decoder, so there is no restart gap.
+ */
+void audioMixerSetChainCallback(AudioChainCallback callback);
+
+/**
+ * @brief Fade out every active voice
+ */
+void audioMixerFadeOutAll();
+
+/**
+ * @brief Set the master gain applied after summing voices
+ * @param gainQ15 Gain in Q15 (AUDIO_GAIN_UNITY_Q15 = unity)
+ */
+void audioMixerSetMasterGain(int32_t gainQ15);
+
+/**
+ * @brief Decode and mix the next block
+ * @param out Interleaved stereo 16-bit output
+ * @param frames Frames to render
+ * @return Frames rendered, or 0 when no voice is active
+ */
+size_t audioMixerRender(int16_t* out, size_t frames);
+
+/**
+ * @brief Check whether any voice is active
+ */
+bool audioMixerIsActive();
+
+/**
+ * @brief Current mix sample rate
+ */
+uint32_t audioMixerSampleRate();
+
+/**
+ * @brief Check and clear the "sample rate changed" flag
+ * @return true if the mix rate changed since the last call
+ *
+ * The mixer adopts the sample rate of a clip that starts while idle.
+ */
+bool audioMixerTakeRateChange();
+
+/**
+ * @brief Get a snapshot of the mixer counters
+ */
+AudioMixerStats getAudioMixerStats();
+
+#endif // AUDIO_MIXER_H
@@ -0,0 +1,82 @@
+/**
+ * @file audio_ring_buffer.h
+ * @brief Lock-free single-producer/single-consumer byte ring buffer
+ *
+ * Used to hand decoded PCM from the decode task to the I2S output task.
+ * The storage is allocated in PSRAM when available so large buffers do not
+ * eat into internal RAM needed by WiFi and the decoder.
+ *
+ * @date 2025
+ */
+
+#ifndef AUDIO_RING_BUFFER_H
+#define AUDIO_RING_BUFFER_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <atomic>
+
+// ============================================================================
+// CLASS DECLARATION
+// ============================================================================
+
+/**
+ * @brief SPSC byte ring buffer
+ *
+ * Exactly one task may call write() and exactly one task may call read()
+ * and reset(). Capacity is rounded up to a power of two so the free-running
+ * head/tail counters can wrap without special handling.
+ */
+class AudioRingBuffer
+{
+public:
+    AudioRingBuffer();
+    ~AudioRingBuffer();
+
+    /**
+     * @brief Allocate the buffer storage
+     * @param capacity Requested capacity in bytes (rounded up to a power of two)
+     * @param preferPsram Allocate from PSRAM when it is available
+     * @return true if the storage was allocated
+     */
+    bool begin(size_t capacity, bool preferPsram = true);
+
+    /**
+     * @brief Release the buffer storage
+     */
+    void end();
+
+    /**
+     * @brief Write bytes into the buffer (producer side)
+     * @return Number of bytes actually written (may be less than len)
+     */
+    size_t write(const uint8_t* data, size_t len);
+
+    /**
+     * @brief Read bytes from the buffer (consumer side)
+     * @return Number of bytes actually read (may be less than len)
+     */
+    size_t read(uint8_t* data, size_t len);
+
+    /**
+     * @brief Drop all buffered data (consumer side)
+     */
+    void reset();
+
+    size_t available() const;
+    size_t availableForWrite() const;
+    size_t capacity() const { return size; }
+    bool isInPsram() const { return psram; }
+
+private:
+    uint8_t* buffer;
+    size_t size;
+    size_t mask;
+    bool psram;
+    std::atomic<size_t> head;  ///< Total bytes written (producer owned)
+    std::atomic<size_t> tail;  ///< Total bytes read (consumer owned)
+};
+
+#endif // AUDIO_RING_BUFFER_H
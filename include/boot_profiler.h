@@ -0,0 +1,67 @@
+/**
+ * @file boot_profiler.h
+ * @brief Timestamps of the startup phases, reported over serial and at /boot
+ *
+ * Each phase records its start and end on the esp_timer clock (microseconds
+ * since reset), so phases running on different tasks at the same time show
+ * up overlapping:
+ *
+ *     int phase = beginBootPhase("codec");
+ *     kit.begin(cfg);
+ *     endBootPhase(phase);
+ *
+ * markBootReady() stamps the moment the game can take its first round and
+ * logs the profile. A phase may end after that (WiFi association usually
+ * does); /boot shows it as running until it ends.
+ *
+ * @date 2025
+ */
+
+#ifndef BOOT_PROFILER_H
+#define BOOT_PROFILER_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#ifndef BOOT_MAX_PHASES
+#define BOOT_MAX_PHASES 16      ///< Phases recorded; later ones are ignored
+#endif
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+/**
+ * @brief Start timing a phase (safe from any task)
+ * @param name Phase name; must outlive the profile (use a literal)
+ * @return Handle for endBootPhase(), or -1 if the table is full
+ */
+int beginBootPhase(const char* name);
+
+/**
+ * @brief Stop timing a phase (ignores -1)
+ */
+void endBootPhase(int phase);
+
+/**
+ * @brief Record that setup is complete and the first round can be played, and log the profile
+ */
+void markBootReady();
+
+/**
+ * @brief Microseconds from reset to markBootReady() (0 until then)
+ */
+int64_t getBootReadyUs();
+
+/**
+ * @brief Write the profile as a text table (served at /boot)
+ */
+void writeBootProfile(Print& out);
+
+#endif // BOOT_PROFILER_H
@@ -0,0 +1,117 @@
+/**
+ * @file button_input.h
+ * @brief Interrupt-driven, timestamped button capture
+ *
+ * GPIO edges are captured in an ISR and stamped with esp_timer_get_time()
+ * microseconds at the moment the edge happens. Debouncing is leading-edge:
+ * the first edge is accepted and further edges on that pin are ignored for
+ * BUTTON_DEBOUNCE_US, so the timestamp is the real press time and not the
+ * time the bounce settled. Accepted edges go into a lock-free SPSC ring
+ * (ISR producer, loop() consumer).
+ *
+ * @date 2025
+ */
+
+#ifndef BUTTON_INPUT_H
+#define BUTTON_INPUT_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#ifndef BUTTON_DEBOUNCE_US
+#define BUTTON_DEBOUNCE_US 20000        ///< Lockout after an accepted edge (microseconds)
+#endif
+
+#ifndef BUTTON_ACTIVE_LEVEL
+#define BUTTON_ACTIVE_LEVEL LOW         ///< Pin level while a button is held
+#endif
+
+#ifndef BUTTON_EVENT_RING_SIZE
+#define BUTTON_EVENT_RING_SIZE 32       ///< Buffered edge events (power of two)
+#endif
+
+#ifndef MAX_BUTTON_PINS
+#define MAX_BUTTON_PINS 16              ///< Maximum pins handled by the capture
+#endif
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * @brief A debounced button edge
+ */
+struct ButtonEvent
+{
+    int64_t timestampUs;    ///< esp_timer_get_time() at the edge
+    uint8_t pin;            ///< GPIO number
+    bool pressed;           ///< true on press, false on release
+};
+
+/**
+ * @brief Button capture counters
+ */
+struct ButtonInputStats
+{
+    uint32_t edges;         ///< Raw edges seen by the ISR
+    uint32_t accepted;      ///< Edges accepted after debouncing
+    uint32_t bounces;       ///< Edges rejected by the debounce lockout
+    uint32_t resyncs;       ///< Level changes recovered after a bounce hid the final edge
+    uint32_t overflows;     ///< Events lost because the ring was full
+};
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+/**
+ * @brief Configure pins and attach edge interrupts
+ * @param pins GPIO numbers to capture
+ * @param count Number of pins (at most MAX_BUTTON_PINS)
+ * @return true if every pin was attached
+ */
+bool initButtonInput(const uint8_t* pins, size_t count);
+
+/**
+ * @brief Take the oldest captured event (call from one task only)
+ * @return true if an event was returned
+ */
+bool popButtonEvent(ButtonEvent& event);
+
+/**
+ * @brief Check for captured events not yet taken (call from the popping task)
+ */
+bool hasButtonEvents();
+
+/**
+ * @brief Recover level changes hidden by a bounce (call this in main loop)
+ *
+ * If a pin's final bounce edge fell inside the lockout, its level differs
+ * from the last accepted state; this emits the missing edge stamped with
+ * the time of that last raw edge. Should the next edge arrive first, the
+ * ISR emits the missing edge itself before handling the new one.
+ */
+void processButtonInput();
+
+/**
+ * @brief Feed an edge through the same debounce path the ISR uses
+ * @param pin GPIO number
+ * @param level Pin level after the edge
+ * @param timestampUs Edge time
+ *
+ * For replaying recorded edge traces and checking the recorded timing.
+ */
+void injectButtonEdge(uint8_t pin, int level, int64_t timestampUs);
+
+/**
+ * @brief Get a snapshot of the capture counters
+ */
+ButtonInputStats getButtonInputStats();
+
+#endif // BUTTON_INPUT_H
@@ -0,0 +1,142 @@
+/**
+ * @file catalog_stream.h
+ * @brief Streaming catalog parser: raw or gzip JSON in, one entry at a time out
+ *
+ * CatalogReader pulls the catalog from a source callback (an HTTP body, an
+ * SD card file) and hands it to ArduinoJson as a custom reader. A gzipped
+ * catalog (Content-Encoding: gzip, or a .gz file) is recognised by its magic
+ * bytes and inflated on the fly, so the compressed body is never held
+ * whole.
+ *
+ * parseCatalogStream() then deserializes one entry at a time instead of
+ * the whole object:
+ *
+ *     {
+ *       "_base": "https://example.com/audio/",       optional, first
+ *       "<key>": { "description": "...", "type": "audio", "path": "a.mp3" },
+ *       ...
+ *     }
+ *
+ * Memory is therefore bounded by one entry plus the reader's buffers
+ * (CATALOG_TEXT_BUFFER, and the 32 KB inflate window for a gzip catalog),
+ * however large the catalog. With "_base" set, a relative path (no scheme,
+ * no leading '/') is resolved against it; paths starting with '/' stay
+ * local SD card paths.
+ *
+ * Nothing here depends on Arduino, so the parser builds and benchmarks on a
+ * host (tools/catalog_bench).
+ *
+ * @date 2025
+ */
+
+#ifndef CATALOG_STREAM_H
+#define CATALOG_STREAM_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "inflate_stream.h"
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#ifndef CATALOG_TEXT_BUFFER
+#define CATALOG_TEXT_BUFFER 8192    ///< Decompressed text staged for the parser
+#endif
+#ifndef CATALOG_WIRE_CHUNK
+#define CATALOG_WIRE_CHUNK 512      ///< Bytes read from the source at a time
+#endif
+#ifndef CATALOG_MAX_KEY
+#define CATALOG_MAX_KEY 64          ///< Longest catalog key
+#endif
+
+#define CATALOG_BASE_KEY "_base"
+
+// One compressed byte completes at most 28 length/distance pairs of 258
+// bytes; the reader feeds the inflater a byte at a time so that always fits
+#if CATALOG_TEXT_BUFFER < 28 * 258
+#error "CATALOG_TEXT_BUFFER must hold the output of one compressed byte (7224 bytes)"
+#endif
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * @brief Supplies the next catalog bytes
+ * @return Bytes read, 0 at the end of the catalog, -1 on an error
+ */
+typedef int (*CatalogSource)(uint8_t* buffer, size_t length, void* context);
+
+/**
+ * @brief Receives one parsed entry; the strings are only valid during the call
+ * @return false to stop parsing (the entries so far are kept)
+ */
+typedef bool (*CatalogEntryVisitor)(const char* key, const char* description, const char* type,
+                                    const char* path, void* context);
+
+// ============================================================================
+// CLASS DECLARATION
+// ============================================================================
+
+class CatalogReader
+{
+public:
+    CatalogReader();
+    ~CatalogReader();
+
+    /**
+     * @brief Start reading a catalog
+     * @param maxText Largest decompressed catalog accepted
+     * @return false if the text buffer could not be allocated
+     */
+    bool begin(CatalogSource source, void* context, uint32_t maxText);
+
+    /**
+     * @brief Release the buffers
+     */
+    void end();
+
+    // ArduinoJson custom reader interface
+    int read();
+    size_t readBytes(char* buffer, size_t length);
+
+    bool isCompressed() const { return inflater != nullptr; }
+    uint32_t wireBytes() const { return wireTotal; }
+    uint32_t textBytes() const { return textTotal; }
+    const char* error() const { return errorText; }
+
+private:
+    bool refill();
+    bool readWire();
+    static bool store(const uint8_t* data, size_t length, void* context);
+
+    CatalogSource source;
+    void* sourceContext;
+    GzipInflater* inflater;     ///< Only allocated for a gzip catalog
+    uint8_t* text;
+    size_t textLength;
+    size_t textPos;
+    uint8_t wire[CATALOG_WIRE_CHUNK];
+    size_t wireLength;
+    size_t wirePos;
+    bool started;
+    bool finished;
+    uint32_t maxTextTotal;
+    uint32_t wireTotal;
+    uint32_t textTotal;
+    const char* errorText;
+};
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+/**
+ * @brief Parse a catalog, calling visitor for each entry as it is read
+ * @return nullptr on success, else what went wrong
+ */
+const char* parseCatalogStream(CatalogReader& reader, CatalogEntryVisitor visitor, void* context);
+
+#endif // CATALOG_STREAM_H
@@ -0,0 +1,115 @@
+/**
+ * @file control_api.h
+ * @brief JSON control endpoints for playback, the catalog and the download queue
+ *
+ * Routes (registered by startWebServer()):
+ *
+ *     POST   /api/play?key=K           queue a sound by key           202 {"key":K,"queued":true}
+ *     GET    /api/volume               current volume                 200 {"volume":0.50}
+ *     POST   /api/volume?value=V       set volume (0..1)              200 {"volume":V}
+ *     GET    /api/catalog              catalog entries                200 {"keys":[...],"count":N}
+ *     POST   /api/catalog/refresh      re-download the catalog        202 job
+ *     GET    /api/downloads            download queue                 200 {"items":[...],"count":N}
+ *     DELETE /api/downloads            clear the download queue       202 job
+ *     GET    /api/jobs[?id=N]          one job, or every remembered job
+ *     POST   /api/ota?url=U&sha256=H[&size=N]&sig=S   pull and flash an image   202 OTA status
+ *     GET    /api/ota                  pull OTA progress              200 {"state":"downloading",...,"nonce":C}
+ *
+ * /api/ota requests must be signed with the OTA password: S is the hex
+ * HMAC-SHA256 of "C\nU\nH\nN" (N as sent, empty if absent), where C is
+ * the nonce from GET /api/ota. The nonce changes whenever a signature is
+ * accepted, so each signature works once. For example:
+ *
+ *     printf '%s\n%s\n%s\n%s' "$C" "$U" "$H" "$N" | openssl dgst -sha256 -hmac "$OTA_PASSWORD"
+ *
+ * Handlers run on the AsyncTCP task. Anything that touches state owned by
+ * loop() is queued as a job instead, and processControlJobs() runs it from
+ * loop(); the reply carries the job ID to poll at /api/jobs?id=N. Bodies are
+ * printed straight into the response parts, never built as a String.
+ *
+ * @date 2025
+ */
+
+#ifndef CONTROL_API_H
+#define CONTROL_API_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#ifndef CONTROL_JOB_SLOTS
+#define CONTROL_JOB_SLOTS 8     ///< Jobs remembered for /api/jobs; a new job needs the oldest one finished
+#endif
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+enum ControlJobType : uint8_t
+{
+    CONTROL_JOB_CATALOG_REFRESH,
+    CONTROL_JOB_CLEAR_DOWNLOADS
+};
+
+enum ControlJobState : uint8_t
+{
+    CONTROL_JOB_QUEUED,
+    CONTROL_JOB_RUNNING,
+    CONTROL_JOB_DONE,
+    CONTROL_JOB_FAILED
+};
+
+/**
+ * @brief Work deferred from a request handler to loop()
+ */
+struct ControlJob
+{
+    uint32_t id;            ///< From 1, in submission order; 0 marks an unused slot
+    ControlJobType type;
+    ControlJobState state;
+    uint32_t queuedMs;
+    uint32_t startedMs;
+    uint32_t finishedMs;
+};
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+/**
+ * @brief Queue a job for processControlJobs() (safe from any task)
+ * @return Job ID, or 0 if CONTROL_JOB_SLOTS jobs are still unfinished
+ * A job of the same type that has not started yet is reused rather than
+ * queued twice.
+ */
+uint32_t queueControlJob(ControlJobType type);
+
+/**
+ * @brief Copy a remembered job (safe from any task)
+ * @return false if the ID is unknown or its slot has been reused
+ */
+bool getControlJob(uint32_t id, ControlJob& job);
+
+/**
+ * @brief Run the next queued job, if any (call this in main loop)
+ */
+void processControlJobs();
+
+void handleApiPlay(AsyncWebServerRequest* request);
+void handleApiGetVolume(AsyncWebServerRequest* request);
+void handleApiSetVolume(AsyncWebServerRequest* request);
+void handleApiCatalog(AsyncWebServerRequest* request);
+void handleApiCatalogRefresh(AsyncWebServerRequest* request);
+void handleApiDownloads(AsyncWebServerRequest* request);
+void handleApiClearDownloads(AsyncWebServerRequest* request);
+void handleApiJobs(AsyncWebServerRequest* request);
+void handleApiStartOta(AsyncWebServerRequest* request);
+void handleApiOtaStatus(AsyncWebServerRequest* request);
+
+#endif // CONTROL_API_H
@@ -0,0 +1,116 @@
+/**
+ * @file dsp_kernels.h
+ * @brief Fixed-point block kernels for the audio output path
+ *
+ * Q15/Q31 gain, linear and exponential fades, saturating mixes and TPDF
+ * dither, all operating on whole blocks of interleaved samples. The mixer
+ * uses these instead of per-sample float math so the output path stays
+ * cheap on a core that also serves WiFi.
+ *
+ * The kernels have no Arduino dependencies and build on a host compiler;
+ * tools/dsp_bench compares them with the equivalent float loops.
+ *
+ * @date 2025
+ */
+
+#ifndef DSP_KERNELS_H
+#define DSP_KERNELS_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#define DSP_Q15_ONE 32768           ///< 1.0 in Q15
+#define DSP_Q31_ONE 0x7FFFFFFF      ///< Largest Q31 value (just below 1.0)
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+/**
+ * @brief Saturate a 32-bit value to 16 bit
+ */
+static inline int16_t dspSaturate16(int32_t x)
+{
+    return (int16_t)(x > 32767 ? 32767 : (x < -32768 ? -32768 : x));
+}
+
+/**
+ * @brief Scale 16-bit samples in place by a Q15 gain (0..DSP_Q15_ONE)
+ */
+void dspGainQ15(int16_t* samples, size_t count, int32_t gainQ15);
+
+/**
+ * @brief Scale 32-bit samples in place by a Q31 gain
+ */
+void dspGainQ31(int32_t* samples, size_t count, int32_t gainQ31);
+
+/**
+ * @brief Linear fade in place
+ * @param samples Interleaved samples
+ * @param frames Number of frames
+ * @param channels Samples per frame
+ * @param gainQ15 Gain at the first frame
+ * @param stepQ15 Gain change per frame (may be negative)
+ * @param targetQ15 Gain the ramp stops at
+ * @return Gain after the last frame
+ */
+int32_t dspFadeLinearQ15(int16_t* samples, size_t frames, int channels,
+                         int32_t gainQ15, int32_t stepQ15, int32_t targetQ15);
+
+/**
+ * @brief Exponential (one-pole) fade in place towards a target gain
+ * @param coeffQ15 Per-frame smoothing coefficient from dspExpFadeCoeffQ15()
+ * @return Gain after the last frame
+ */
+int32_t dspFadeExpQ15(int16_t* samples, size_t frames, int channels,
+                      int32_t gainQ15, int32_t targetQ15, int32_t coeffQ15);
+
+/**
+ * @brief Coefficient for dspFadeExpQ15() with the given time constant
+ */
+int32_t dspExpFadeCoeffQ15(uint32_t sampleRate, float timeConstantMs);
+
+/**
+ * @brief Add src into dst with saturation (dst = sat16(dst + src))
+ */
+void dspMixSaturate16(int16_t* dst, const int16_t* src, size_t count);
+
+/**
+ * @brief Accumulate gained samples into a 32-bit mix bus
+ * @param acc Mix accumulator holding samples with fracBits extra fraction bits
+ * @param in 16-bit input samples
+ * @param count Number of samples
+ * @param gainQ15 Gain applied to the input
+ * @param fracBits Extra fraction bits kept in the accumulator (0..15)
+ */
+void dspMixAccumulateQ15(int32_t* acc, const int16_t* in, size_t count,
+                         int32_t gainQ15, int fracBits);
+
+/**
+ * @brief Accumulate with a linear gain ramp (see dspFadeLinearQ15())
+ * @return Gain after the last frame
+ */
+int32_t dspMixAccumulateRampQ15(int32_t* acc, const int16_t* in, size_t frames, int channels,
+                                int32_t gainQ15, int32_t stepQ15, int32_t targetQ15,
+                                int fracBits);
+
+/**
+ * @brief Reduce a mix bus to 16 bit by rounding and saturation
+ */
+void dspReduceTo16(int16_t* out, const int32_t* acc, size_t count, int fracBits);
+
+/**
+ * @brief Reduce a mix bus to 16 bit with TPDF dither and saturation
+ * @param rngState Dither generator state (any non-zero seed)
+ */
+void dspDitherTpdfTo16(int16_t* out, const int32_t* acc, size_t count, int fracBits,
+                       uint32_t* rngState);
+
+#endif // DSP_KERNELS_H
@@ -0,0 +1,111 @@
+/**
+ * @file event_stream.h
+ * @brief Server-Sent Events at /events: game, playback, download and log events
+ *
+ * Any task can publishEvent(); it formats the JSON payload into a slot of a
+ * fixed ring and wakes the stream task, so the caller never waits on the
+ * network. The stream task forwards new events to every connected client:
+ *
+ *     event: game        id: 17   data: {"event":"round_complete","station":0,...}
+ *     event: playback    id: 18   data: {"event":"play","path":"/audio/yes.mp3"}
+ *     event: download    id: 19   data: {"event":"progress","bytes":40960,"size":81234}
+ *     event: log                  data: {"seq":812,"t":53311,"level":3,"module":"MAIN","msg":"..."}
+ *
+ * Ring events carry their sequence as the SSE id, so a browser that
+ * reconnects with Last-Event-ID is replayed whatever the ring still holds.
+ * Log records are read from the Logger ring directly and keep their own
+ * sequence ("seq"); /logs.json?since=seq fills any gap.
+ *
+ * Each client has a bounded message queue (SSE_MAX_QUEUED_MESSAGES, shared
+ * payloads). A client that stops reading has messages dropped once its queue
+ * is full rather than holding more memory, and at most EVENT_MAX_CLIENTS
+ * clients are accepted.
+ *
+ * @date 2025
+ */
+
+#ifndef EVENT_STREAM_H
+#define EVENT_STREAM_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#ifndef EVENT_RING_SLOTS
+#define EVENT_RING_SLOTS 32         ///< Events kept for forwarding and Last-Event-ID replay
+#endif
+#ifndef EVENT_DATA_LENGTH
+#define EVENT_DATA_LENGTH 192       ///< Longest event payload including terminator
+#endif
+#ifndef EVENT_STRING_LENGTH
+#define EVENT_STRING_LENGTH 128     ///< Longest escaped string field (e.g. a path) including terminator
+#endif
+#ifndef EVENT_MAX_CLIENTS
+#define EVENT_MAX_CLIENTS 4         ///< Further /events connections are refused
+#endif
+#ifndef EVENT_LOG_POLL_MS
+#define EVENT_LOG_POLL_MS 100       ///< How often new log records are picked up
+#endif
+#ifndef EVENT_RETRY_MS
+#define EVENT_RETRY_MS 2000         ///< Reconnect delay suggested to browsers
+#endif
+#ifndef EVENT_TASK_PRIORITY
+#define EVENT_TASK_PRIORITY 1
+#endif
+#ifndef EVENT_TASK_STACK
+#define EVENT_TASK_STACK 4096
+#endif
+#ifndef EVENT_TASK_CORE
+#define EVENT_TASK_CORE 0           ///< With the web server, away from the audio tasks
+#endif
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+enum StreamEventType : uint8_t
+{
+    STREAM_EVENT_GAME,
+    STREAM_EVENT_PLAYBACK,
+    STREAM_EVENT_DOWNLOAD
+};
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+/**
+ * @brief Start the stream task (call once from setup())
+ * @return true if the task is running
+ */
+bool initEventStream();
+
+/**
+ * @brief Register /events with the web server (called by startWebServer())
+ */
+void attachEventStream(AsyncWebServer& server);
+
+/**
+ * @brief Queue an event for every /events client (safe from any task, never blocks)
+ * @param format printf format producing the JSON data; cut at EVENT_DATA_LENGTH - 1
+ */
+void publishEvent(StreamEventType type, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Escape text for a JSON string field of an event payload
+ * @param out Output buffer of EVENT_STRING_LENGTH bytes
+ * @param text Text to escape (e.g. a file path)
+ *
+ * Text that does not fit is cut before the first escape or UTF-8 character
+ * that would not fit whole, so the payload stays valid JSON. The result
+ * goes between quotes in the publishEvent() format.
+ */
+void escapeEventString(char* out, const char* text);
+
+#endif // EVENT_STREAM_H
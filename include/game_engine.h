@@ -0,0 +1,258 @@
+/**
+ * @file game_engine.h
+ * @brief Deterministic game logic driven by timestamped input events
+ *
+ * The engine holds the round state (who pressed what and when) and decides
+ * outcomes. It never reads a clock or plays audio itself: presses arrive
+ * with their own timestamps, the current time comes from an injected clock
+ * (or is passed to update()), and results are reported as GameEvents. The
+ * same input trace therefore always produces the same events, and the
+ * engine builds on a host compiler for trace replay and fuzzing.
+ *
+ * One engine runs several independent stations, each with its own players,
+ * round state and timeout. Round state is kept as bitmasks, so a press is a
+ * constant-time update regardless of how many inputs are wired up, and
+ * update() only visits stations with a round in progress.
+ *
+ * All times are 32-bit milliseconds compared with wrap-safe arithmetic, so
+ * rounds that straddle the millis() rollover behave like any other round.
+ *
+ * @date 2025
+ */
+
+#ifndef GAME_ENGINE_H
+#define GAME_ENGINE_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#ifndef GAME_TIMEOUT_MS
+#define GAME_TIMEOUT_MS 60000   ///< Max time between first and last press of a round
+#endif
+
+#ifndef GAME_PLAYERS
+#define GAME_PLAYERS 2          ///< Default players per station
+#endif
+
+#ifndef GAME_MAX_STATIONS
+#define GAME_MAX_STATIONS 8     ///< Independent stations per engine
+#endif
+
+#define GAME_MAX_PLAYERS 32     ///< Players per station (one bit each in the round masks)
+
+#ifndef GAME_MAX_PINS
+#define GAME_MAX_PINS 64        ///< Size of the pin lookup table (highest pin + 1)
+#endif
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+enum GameState
+{
+    GAME_WAITING_FOR_PLAYERS,   ///< Accepting presses
+    GAME_PLAYING_SOUND          ///< Round decided; waiting for the result sound to finish
+};
+
+enum GameEventType
+{
+    GAME_EVENT_PRESS,           ///< A press was accepted
+    GAME_EVENT_LOCKED_IN,       ///< First press of a round; others still to answer
+    GAME_EVENT_ROUND_COMPLETE,  ///< Outcome decided
+    GAME_EVENT_RESET            ///< Ready for the next round
+};
+
+enum GameOutcome
+{
+    GAME_OUTCOME_NONE,
+    GAME_OUTCOME_YES,           ///< Everyone said YES within the timeout
+    GAME_OUTCOME_NO,            ///< At least one player said NO
+    GAME_OUTCOME_TOO_SLOW,      ///< Everyone said YES but the spread exceeded the timeout
+    GAME_OUTCOME_TIMEOUT        ///< Not everyone answered within the timeout
+};
+
+/**
+ * @brief Event emitted by the engine
+ */
+struct GameEvent
+{
+    GameEventType type;
+    int station;                ///< Station the event belongs to
+    int players;                ///< Players in the station
+    uint32_t timeMs;            ///< Time of the press or decision
+    int player;                 ///< Player index (GAME_EVENT_PRESS)
+    bool answer;                ///< true for YES (GAME_EVENT_PRESS)
+    GameOutcome outcome;        ///< Result (GAME_EVENT_ROUND_COMPLETE)
+    uint32_t spreadMs;          ///< First to last press (GAME_EVENT_ROUND_COMPLETE)
+    uint32_t pressedMask;       ///< Players that answered (GAME_EVENT_ROUND_COMPLETE)
+};
+
+/**
+ * @brief Engine counters (all stations)
+ */
+struct GameStats
+{
+    uint32_t presses;           ///< Presses accepted
+    uint32_t pressesIgnored;    ///< Presses while a sound plays or from unknown inputs
+    uint32_t rounds;            ///< Rounds decided
+    uint32_t yesRounds;         ///< Rounds with outcome YES
+    uint32_t timeouts;          ///< Rounds decided by GAME_OUTCOME_TIMEOUT
+};
+
+/**
+ * @brief One row of the input table: which station/player/answer a pin is
+ */
+struct GameInput
+{
+    uint8_t pin;
+    uint8_t station;
+    uint8_t player;
+    bool answer;                ///< true for YES
+};
+
+typedef void (*GameEventHandler)(const GameEvent& event, void* context);
+typedef uint32_t (*GameClock)(void* context);
+
+// ============================================================================
+// CLASS DEFINITIONS
+// ============================================================================
+
+/**
+ * @brief Constant-time pin to GameInput lookup built from an input table
+ */
+class GameInputMap
+{
+public:
+    GameInputMap();
+
+    /**
+     * @brief Index a table (kept by reference, must outlive the map)
+     * @return false if a pin is out of range or listed twice
+     */
+    bool begin(const GameInput* inputs, size_t count);
+
+    /**
+     * @brief Find the input wired to a pin
+     * @return The table row, or nullptr if the pin is not mapped
+     */
+    const GameInput* find(uint8_t pin) const
+    {
+        return pin < GAME_MAX_PINS && index_[pin] >= 0 ? &inputs_[index_[pin]] : nullptr;
+    }
+
+private:
+    const GameInput* inputs_;
+    int8_t index_[GAME_MAX_PINS];
+};
+
+class GameEngine
+{
+public:
+    explicit GameEngine(uint32_t timeoutMs = GAME_TIMEOUT_MS);
+
+    /**
+     * @brief Set the receiver for emitted events
+     */
+    void setEventHandler(GameEventHandler handler, void* context = nullptr);
+
+    /**
+     * @brief Set the clock used by update()
+     */
+    void setClock(GameClock clock, void* context = nullptr);
+
+    /**
+     * @brief Set how many players a station has and its timeout
+     * @param station Station index (0..GAME_MAX_STATIONS-1)
+     * @param players Players in the station (1..GAME_MAX_PLAYERS; 0 disables it)
+     * @param timeoutMs Round timeout for this station
+     */
+    void configureStation(int station, int players, uint32_t timeoutMs = GAME_TIMEOUT_MS);
+
+    /**
+     * @brief Configure stations from an input table (players = highest player + 1)
+     */
+    void configureStations(const GameInput* inputs, size_t count);
+
+    /**
+     * @brief Feed a press
+     * @param station Station index
+     * @param player Player index within the station
+     * @param answer true for YES, false for NO
+     * @param timestampMs When the press happened
+     */
+    void press(int station, int player, bool answer, uint32_t timestampMs);
+
+    /**
+     * @brief Feed a press from the input table
+     */
+    void press(const GameInput& input, uint32_t timestampMs)
+    {
+        press(input.station, input.player, input.answer, timestampMs);
+    }
+
+    /**
+     * @brief Check round timeouts against the injected clock
+     */
+    void update();
+
+    /**
+     * @brief Check round timeouts against an explicit time
+     */
+    void update(uint32_t nowMs);
+
+    /**
+     * @brief Report that a station's result sound has finished; starts its next round
+     */
+    void soundFinished(int station);
+
+    /**
+     * @brief Abandon the current round of one station
+     */
+    void reset(int station);
+
+    /**
+     * @brief Abandon the current round of every station
+     */
+    void reset();
+
+    GameState state(int station) const;
+    uint32_t waitingMask() const { return waitingMask_; }  ///< Stations with a round in progress
+    uint32_t playingMask() const { return playingMask_; }  ///< Stations in GAME_PLAYING_SOUND
+    const GameStats& stats() const { return stats_; }
+
+private:
+    struct Station
+    {
+        uint8_t players;
+        uint32_t timeoutMs;
+        uint32_t fullMask;      ///< One bit per player
+        uint32_t pressedMask;   ///< Players that pressed this round
+        uint32_t yesMask;       ///< Players whose latest answer is YES
+        uint32_t firstPressMs;
+        uint32_t pressMs[GAME_MAX_PLAYERS];
+    };
+
+    void emit(GameEventType type, int station, uint32_t timeMs, int player = -1,
+              bool answer = false, GameOutcome outcome = GAME_OUTCOME_NONE,
+              uint32_t spreadMs = 0, uint32_t pressedMask = 0);
+    void decide(int station, uint32_t timeMs);
+    void finishRound(int station, GameOutcome outcome, uint32_t timeMs, uint32_t spreadMs);
+
+    Station stations_[GAME_MAX_STATIONS];
+    uint32_t waitingMask_;      ///< Stations with at least one press and no outcome yet
+    uint32_t playingMask_;
+    GameEventHandler handler_;
+    void* handlerContext_;
+    GameClock clock_;
+    void* clockContext_;
+    GameStats stats_;
+};
+
+#endif // GAME_ENGINE_H
@@ -0,0 +1,159 @@
+/**
+ * @file inflate_stream.h
+ * @brief Streaming gzip decompressor (RFC 1952 framing, RFC 1951 inflate)
+ *
+ * Compressed bytes are pushed in with write() in whatever pieces they
+ * arrive (a TCP segment, a file read); decompressed output is handed to a
+ * sink callback in runs of up to the 32 KB history window. Nothing waits for
+ * the whole stream, so a download can be decompressed as it is received:
+ *
+ *     GzipInflater inflater;
+ *     inflater.begin(writeToFlash, &update);
+ *     while (n = read(buffer))  if (inflater.write(buffer, n) == INFLATE_ERROR) ...
+ *     if (inflater.status() != INFLATE_DONE) ...   // truncated
+ *
+ * The trailer's CRC-32 and length are checked before INFLATE_DONE is
+ * reported. Memory is the 32 KB window plus INFLATE_INPUT_BUFFER bytes,
+ * allocated by begin() and released by end().
+ *
+ * The inflater has no Arduino dependencies and builds on a host compiler
+ * (see tools/ota_bench).
+ *
+ * @date 2025
+ */
+
+#ifndef INFLATE_STREAM_H
+#define INFLATE_STREAM_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#ifndef INFLATE_INPUT_BUFFER
+#define INFLATE_INPUT_BUFFER 1024   ///< Must hold the largest unit decoded at once (a dynamic block header)
+#endif
+
+#define INFLATE_WINDOW_SIZE 32768   ///< Deflate history; fixed by the format
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+enum InflateStatus
+{
+    INFLATE_MORE,       ///< Waiting for more input
+    INFLATE_DONE,       ///< Stream complete and verified; later input is ignored
+    INFLATE_ERROR       ///< Corrupt stream, sink refused output, or out of memory
+};
+
+/**
+ * @brief Receives decompressed output
+ * @return false to abort decompression (write() then reports INFLATE_ERROR)
+ */
+typedef bool (*InflateSink)(const uint8_t* data, size_t length, void* context);
+
+/**
+ * @brief Canonical Huffman code with a direct lookup for short codes
+ */
+struct InflateHuffman
+{
+    uint16_t count[16];         ///< Codes of each length
+    uint16_t symbol[288];       ///< Symbols ordered by code
+    uint16_t fast[512];         ///< 9-bit lookup: length << 9 | symbol, 0 for longer codes
+};
+
+// ============================================================================
+// CLASS DECLARATION
+// ============================================================================
+
+class GzipInflater
+{
+public:
+    GzipInflater();
+    ~GzipInflater();
+
+    /**
+     * @brief Allocate the window and start a new stream
+     * @return false if the window could not be allocated
+     */
+    bool begin(InflateSink sink, void* context);
+
+    /**
+     * @brief Release the window
+     */
+    void end();
+
+    /**
+     * @brief Decompress the next piece of the stream
+     */
+    InflateStatus write(const uint8_t* data, size_t length);
+
+    InflateStatus status() const { return state == STATE_DONE ? INFLATE_DONE : state == STATE_ERROR ? INFLATE_ERROR : INFLATE_MORE; }
+    const char* error() const { return errorText; }
+    uint32_t totalIn() const { return inputTotal; }
+    uint32_t totalOut() const { return outputTotal; }
+
+private:
+    enum State
+    {
+        STATE_HEADER,
+        STATE_BLOCK,
+        STATE_STORED,
+        STATE_CODES,
+        STATE_TRAILER,
+        STATE_DONE,
+        STATE_ERROR
+    };
+
+    enum Step
+    {
+        STEP_OK,
+        STEP_NEED_INPUT,
+        STEP_FAIL
+    };
+
+    Step decodeHeader();
+    Step decodeBlockHeader();
+    Step decodeStored();
+    Step decodeCodes();
+    Step decodeTrailer();
+
+    bool fill(int bits);
+    uint32_t take(int bits);
+    int decodeSymbol(const InflateHuffman& huffman);
+    bool buildHuffman(InflateHuffman& huffman, const uint8_t* lengths, int count);
+    void put(uint8_t byte);
+    bool flushWindow();
+    Step fail(const char* text);
+
+    InflateSink sink;
+    void* sinkContext;
+    uint8_t* window;
+    uint32_t windowPos;         ///< Next write position
+    uint32_t windowFlushed;     ///< Start of the output not yet given to the sink
+
+    uint8_t input[INFLATE_INPUT_BUFFER];
+    size_t inputLength;
+    size_t inputPos;
+    uint32_t bitBuffer;
+    int bitCount;
+
+    State state;
+    bool lastBlock;
+    uint32_t storedRemaining;
+    InflateHuffman lengthCode;
+    InflateHuffman distanceCode;
+
+    uint32_t crc;
+    uint32_t inputTotal;
+    uint32_t outputTotal;
+    const char* errorText;
+};
+
+#endif // INFLATE_STREAM_H
@@ -0,0 +1,110 @@
+/**
+ * @file log_sink.h
+ * @brief Persistent, rotating copy of the Logger ring on SD
+ *
+ * A low-priority task follows the Logger ring with a sequence cursor
+ * (LoggerClass::forEachRecordSince), formats new records as text lines into
+ * a LOG_SINK_BATCH_BYTES buffer and appends the buffer to LOG_SINK_FILE in
+ * one write. Logging itself never waits for the sink: if the task falls
+ * behind far enough for the ring to wrap, the overwritten records are
+ * counted as dropped and the file shows a gap marker.
+ *
+ * LOG_SINK_FILE is rotated to LOG_SINK_FILE.1, .2, ... once it reaches
+ * LOG_SINK_MAX_FILE_BYTES; only LOG_SINK_MAX_FILES files are kept.
+ *
+ * @date 2025
+ */
+
+#ifndef LOG_SINK_H
+#define LOG_SINK_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <SD_MMC.h>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#ifndef LOG_SINK_FILE
+#define LOG_SINK_FILE "/log.txt"                    ///< Current log file; rotated files get .1, .2, ...
+#endif
+
+#ifndef LOG_SINK_FS
+#define LOG_SINK_FS SD_MMC                          ///< Filesystem holding the logs (mounted by the audio source)
+#endif
+
+#ifndef LOG_SINK_MAX_FILE_BYTES
+#define LOG_SINK_MAX_FILE_BYTES (256UL * 1024UL)    ///< Rotate the current file beyond this size
+#endif
+
+#ifndef LOG_SINK_MAX_FILES
+#define LOG_SINK_MAX_FILES 4                        ///< Files kept, including the current one
+#endif
+
+#ifndef LOG_SINK_BATCH_BYTES
+#define LOG_SINK_BATCH_BYTES 4096                   ///< Text collected before each write (multiple of 512)
+#endif
+
+#ifndef LOG_SINK_FLUSH_MS
+#define LOG_SINK_FLUSH_MS 2000                      ///< Write a partial batch after this long
+#endif
+
+#ifndef LOG_SINK_POLL_MS
+#define LOG_SINK_POLL_MS 250                        ///< How often the task looks for new records
+#endif
+
+#ifndef LOG_SINK_TASK_PRIORITY
+#define LOG_SINK_TASK_PRIORITY 1                    ///< Same as loopTask, but on core 0 where AsyncTCP, lwIP and WiFi preempt it
+#endif
+
+#ifndef LOG_SINK_TASK_STACK
+#define LOG_SINK_TASK_STACK 4096
+#endif
+
+#ifndef LOG_SINK_TASK_CORE
+#define LOG_SINK_TASK_CORE 0                        ///< Away from the audio tasks
+#endif
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * @brief Sink counters
+ */
+struct LogSinkStats
+{
+    uint32_t records;           ///< Records written to SD
+    uint32_t dropped;           ///< Records overwritten in the ring before the sink read them
+    uint32_t bytes;             ///< Bytes written to SD
+    uint32_t writes;            ///< Batch writes issued
+    uint32_t writeErrors;       ///< Failed opens or short writes
+    uint32_t rotations;         ///< Files rotated
+    uint32_t lastWriteUs;       ///< Duration of the last batch write
+    uint32_t maxWriteUs;        ///< Longest batch write
+};
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+/**
+ * @brief Start the sink task (call after the filesystem is mounted)
+ * @return true if the task was started
+ */
+bool initLogSink();
+
+/**
+ * @brief Ask the sink to write everything it has read as soon as possible
+ */
+void flushLogSink();
+
+/**
+ * @brief Get a snapshot of the sink counters
+ */
+LogSinkStats getLogSinkStats();
+
+#endif // LOG_SINK_H
@@ -3,42 +3,189 @@
 
 #include <Print.h>
 #include <WString.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
-#define LOG_BUFFER_SIZE 100
+// Log lines are kept as binary records in a fixed byte ring:
+//   [uint16 length][uint8 level][uint8 module][uint32 millis][uint32 sequence][message][uint16 length]
+// The trailing length lets readers walk newest-first. Lines are formatted
+// into text only when /logs is read; logging a line copies its bytes once
+// and never touches the heap.
+#define LOG_RING_BYTES 8192                 // Size of the record ring (power of two)
 #define MAX_LOG_MESSAGE_LENGTH 256
+#define LOG_LINE_BUFFERS 4                  // Tasks that can assemble a line at the same time
+
+// Levels are plain numbers so the preprocessor can compare them
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+typedef uint8_t LogLevel;
+
+// Lowest-priority level compiled in; calls above it generate no code and
+// do not evaluate their arguments
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#endif
+
+// Modules with their own runtime level (Logger.setModuleLevel())
+enum LogModule : uint8_t {
+    LOG_MODULE_MAIN,
+    LOG_MODULE_AUDIO,
+    LOG_MODULE_MIXER,
+    LOG_MODULE_FILES,
+    LOG_MODULE_WIFI,
+    LOG_MODULE_SETTINGS,
+    LOG_MODULE_INPUT,
+    LOG_MODULE_HISTORY,
+    LOG_MODULE_SINK,
+    LOG_MODULE_COUNT
+};
+
+// A translation unit picks its module by defining LOG_MODULE before including this header
+#ifndef LOG_MODULE
+#define LOG_MODULE LOG_MODULE_MAIN
+#endif
+
+// Runtime level per module (defaults to LOG_COMPILE_LEVEL)
+extern LogLevel logModuleLevels[LOG_MODULE_COUNT];
+
+// A record copied out of the ring
+struct LogRecord {
+    uint32_t sequence;                      // 1 for the first record since boot, +1 per record
+    uint32_t timestampMs;
+    LogLevel level;
+    LogModule module;
+    uint16_t length;
+    char message[MAX_LOG_MESSAGE_LENGTH];   // NUL-terminated
+};
+
+typedef void (*LogRecordVisitor)(const LogRecord& record, void* context);
+
+// Position in a /logs.json document being produced part by part
+struct LogJsonCursor {
+    uint32_t since;     // Records newer than this are included
+    uint32_t last;      // Newest record written so far
+    uint32_t end;       // Newest record when the document was started
+    uint8_t stage;
+    Print* out;
+};
 
 class LoggerClass : public Print {
 private:
     Print* serialPrint;  // Reference to Serial or other Print object
-    String logBuffer[LOG_BUFFER_SIZE];
-    int logIndex;
+
+    // Record ring; head/tail are free-running byte positions
+    uint8_t ring[LOG_RING_BYTES];
+    uint32_t head;
+    uint32_t tail;
     int logCount;
-    char messageBuffer[MAX_LOG_MESSAGE_LENGTH];
-    int bufferPos;
+    uint32_t totalRecords;
+    uint32_t truncatedRecords;
+    TaskHandle_t readerTask;    // Notified as the ring fills (see setReaderTask())
+    uint32_t readerWakeHead;
+
+    // Per-task line assembly for Print writes (a line often spans several write() calls)
+    struct LineBuffer {
+        TaskHandle_t owner;
+        uint16_t length;
+        char data[MAX_LOG_MESSAGE_LENGTH];
+    };
+    LineBuffer lineBuffers[LOG_LINE_BUFFERS];
 
 public:
     LoggerClass();
-    
+
     // Initialize with a Print object (replaces constructor functionality)
     void addLogger(Print& print);
-    
-    // Print interface implementation
+
+    // Print interface implementation (lines logged at LOG_LEVEL_INFO)
     size_t write(uint8_t byte) override;
     size_t write(const uint8_t* buffer, size_t size) override;
-    
-    // Get log messages for web interface
-    String getLogsAsHtml();
-    String getLogsAsJson();
-    
+
+    // Log one line at the given level (newline optional); normally called through LOG_ERROR() etc.
+    void log(LogModule module, LogLevel level, const char* format, ...) __attribute__((format(printf, 4, 5)));
+
+    // Runtime level overrides
+    void setModuleLevel(LogModule module, LogLevel level);
+    bool setModuleLevel(const char* moduleName, LogLevel level);
+    static const char* moduleName(LogModule module);
+    static const char* levelName(LogLevel level);
+
+    // Notify a task that follows the ring (e.g. the SD sink) each time another
+    // quarter of the ring has been written, so it can read before records are overwritten
+    void setReaderTask(TaskHandle_t task) { readerTask = task; }
+
+    // Visit buffered records, newest first by default; each record is copied out before the call
+    void forEachRecord(LogRecordVisitor visitor, void* context, bool newestFirst = true);
+    // Visit, oldest first, up to limit buffered records with a sequence number above the given one
+    void forEachRecordSince(uint32_t sequence, LogRecordVisitor visitor, void* context, uint32_t limit = UINT32_MAX);
+
+    // Produce the /logs.json document one part (header, one record, footer) per
+    // call, so a response can be streamed with a buffer the size of one record.
+    // The document holds the records newer than since (all with 0) and "last",
+    // the cursor for the next request. writeLogsJsonPart() returns false once it
+    // has written the closing part.
+    void beginLogsJson(LogJsonCursor& cursor, uint32_t since);
+    bool writeLogsJsonPart(Print& out, LogJsonCursor& cursor);
+
     // Buffer management
     void clearLogs();
     int getLogCount() const { return logCount; }
-    
+    uint32_t getTotalRecords() const { return totalRecords; }
+    uint32_t getLastSequence() const { return totalRecords; }
+
 private:
-    void addMessageToBuffer(const String& message);
+    void appendRecord(LogModule module, LogLevel level, const char* message, size_t length);
+    void copyFromRing(uint32_t pos, void* dst, size_t length) const;
+    void copyToRing(uint32_t pos, const void* src, size_t length);
+    void visitRecords(uint32_t pos, uint32_t end, bool newestFirst, LogRecordVisitor visitor, void* context,
+                      uint32_t limit);
+    LineBuffer* lineBufferForCurrentTask();
 };
 
-// Global logger instance (declared in logging.cpp)  
+// Global logger instance (declared in logging.cpp)
 extern LoggerClass Logger;
 
-#endif // LOGGING_H
\ No newline at end of file
+// Write text as the contents of a JSON string (quotes, backslashes and control characters escaped)
+void writeJsonEscaped(Print& out, const char* text, size_t length);
+
+// ============================================================================
+// LOGGING MACROS
+// ============================================================================
+
+#define LOG_AT(level, format, ...)                                          \
+    do {                                                                    \
+        if (logModuleLevels[LOG_MODULE] >= (level)) {                       \
+            Logger.log((LogModule)LOG_MODULE, (level), format, ##__VA_ARGS__); \
+        }                                                                   \
+    } while (0)
+
+#define LOG_DISABLED(format, ...) do {} while (0)
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(format, ...) LOG_AT(LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(format, ...) LOG_DISABLED(format, ##__VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(format, ...) LOG_AT(LOG_LEVEL_WARN, format, ##__VA_ARGS__)
+#else
+#define LOG_WARN(format, ...) LOG_DISABLED(format, ##__VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(format, ...) LOG_AT(LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...) LOG_DISABLED(format, ##__VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(format, ...) LOG_AT(LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(format, ...) LOG_DISABLED(format, ##__VA_ARGS__)
+#endif
+
+#endif // LOGGING_H
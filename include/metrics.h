@@ -0,0 +1,167 @@
+/**
+ * @file metrics.h
+ * @brief Fixed-memory metrics registry (counters, gauges, log2 histograms)
+ *
+ * Metrics are statically allocated objects that link themselves into a
+ * registry when constructed, so defining one is all a module has to do:
+ *
+ *     static MetricHistogram mixTime("audio_mix_block_duration_us", "Time to render one mix block");
+ *     mixTime.record(elapsedUs);
+ *
+ * Recording is a relaxed atomic add (plus a count-leading-zeros for
+ * histograms): no locks, no heap, safe from any task. writeMetrics() renders
+ * the registry in the Prometheus text format for /metrics.
+ *
+ * Histogram bucket i counts values up to 2^i; the last bucket is +Inf.
+ *
+ * @date 2025
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <atomic>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#ifndef METRIC_HISTOGRAM_BUCKETS
+#define METRIC_HISTOGRAM_BUCKETS 24     ///< Buckets per histogram: le 1, 2, 4 ... 2^22, +Inf
+#endif
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+enum MetricType : uint8_t
+{
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+};
+
+/**
+ * @brief Registry entry shared by all metric kinds
+ */
+class Metric
+{
+public:
+    const char* name() const { return metricName; }
+    MetricType type() const { return metricType; }
+    const Metric* next() const { return nextMetric; }
+
+    /**
+     * @brief Write HELP, TYPE and the sample lines in Prometheus text format
+     */
+    void write(Print& out) const;
+
+    /**
+     * @brief First registered metric (walk the rest with next())
+     */
+    static const Metric* first();
+
+protected:
+    Metric(const char* name, const char* help, MetricType type);
+
+    // Not copyable: the registry links the object itself
+    Metric(const Metric&) = delete;
+    Metric& operator=(const Metric&) = delete;
+
+private:
+    const char* metricName;
+    const char* metricHelp;
+    MetricType metricType;
+    Metric* nextMetric;
+};
+
+/**
+ * @brief Monotonic counter; optionally read from a sampler at scrape time
+ */
+class MetricCounter : public Metric
+{
+public:
+    MetricCounter(const char* name, const char* help, uint32_t (*sampler)() = nullptr)
+        : Metric(name, help, METRIC_COUNTER), value(0), sampler(sampler)
+    {
+    }
+
+    void add(uint32_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint32_t get() const { return sampler ? sampler() : value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> value;
+    uint32_t (*sampler)();
+};
+
+/**
+ * @brief Current value; either set by the owner or read from a sampler at scrape time
+ */
+class MetricGauge : public Metric
+{
+public:
+    MetricGauge(const char* name, const char* help, int32_t (*sampler)() = nullptr)
+        : Metric(name, help, METRIC_GAUGE), value(0), sampler(sampler)
+    {
+    }
+
+    void set(int32_t v) { value.store(v, std::memory_order_relaxed); }
+    int32_t get() const { return sampler ? sampler() : value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int32_t> value;
+    int32_t (*sampler)();
+};
+
+/**
+ * @brief Distribution of non-negative values in power-of-two buckets
+ */
+class MetricHistogram : public Metric
+{
+public:
+    MetricHistogram(const char* name, const char* help)
+        : Metric(name, help, METRIC_HISTOGRAM), buckets{}, sumLow(0), sumHigh(0)
+    {
+    }
+
+    void record(uint32_t v)
+    {
+        // Bucket i holds (2^(i-1), 2^i]; __builtin_clz is a single instruction on Xtensa
+        uint32_t index = v <= 1 ? 0 : 32 - __builtin_clz(v - 1);
+        if (index >= METRIC_HISTOGRAM_BUCKETS)
+        {
+            index = METRIC_HISTOGRAM_BUCKETS - 1;
+        }
+        buckets[index].fetch_add(1, std::memory_order_relaxed);
+
+        // 64-bit sum from two 32-bit atomics: carry into the high word on wrap
+        uint32_t old = sumLow.fetch_add(v, std::memory_order_relaxed);
+        if (old + v < old)
+        {
+            sumHigh.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    uint32_t bucket(int index) const { return buckets[index].load(std::memory_order_relaxed); }
+    uint64_t sum() const;
+
+private:
+    std::atomic<uint32_t> buckets[METRIC_HISTOGRAM_BUCKETS];
+    std::atomic<uint32_t> sumLow;
+    std::atomic<uint32_t> sumHigh;
+};
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+/**
+ * @brief Write every registered metric in Prometheus text format
+ */
+void writeMetrics(Print& out);
+
+#endif // METRICS_H
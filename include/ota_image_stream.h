@@ -0,0 +1,117 @@
+/**
+ * @file ota_image_stream.h
+ * @brief Firmware image pipeline: optional gzip inflate, SHA-256, then the flash sink
+ *
+ * The downloader pushes the bytes it receives into write(); the stream
+ * detects a gzip image by its magic bytes (a raw ESP32 image starts with
+ * 0xE9), inflates it on the fly, hashes the decompressed image and hands it
+ * to the sink (Update.write() on the device). finish() only succeeds if the
+ * stream ended cleanly and the digest matches the one published for the
+ * image, so a truncated or tampered download is never marked bootable.
+ *
+ * Nothing here depends on Arduino, so the pipeline builds and benchmarks on
+ * a host (tools/ota_bench).
+ *
+ * @date 2025
+ */
+
+#ifndef OTA_IMAGE_STREAM_H
+#define OTA_IMAGE_STREAM_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "inflate_stream.h"
+#include <mbedtls/sha256.h>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#define OTA_SHA256_LENGTH 32
+
+// ============================================================================
+// CLASS DECLARATION
+// ============================================================================
+
+class OtaImageStream
+{
+public:
+    OtaImageStream();
+    ~OtaImageStream();
+
+    /**
+     * @brief Start a new image
+     * @param sink Receives the decompressed image; returning false aborts
+     * @return false if the inflate window could not be allocated
+     */
+    bool begin(InflateSink sink, void* context);
+
+    /**
+     * @brief Release the inflate window
+     */
+    void end();
+
+    /**
+     * @brief Push the next downloaded bytes
+     * @return false on a corrupt stream or a refused write (see error())
+     */
+    bool write(const uint8_t* data, size_t length);
+
+    /**
+     * @brief true once a gzip stream has reached its verified end (raw images
+     *        have no end marker; the caller knows their length)
+     */
+    bool isComplete() const;
+
+    /**
+     * @brief Check the end of the stream and the image digest
+     * @return true if the image is complete and its SHA-256 matches expected
+     */
+    bool finish(const uint8_t expected[OTA_SHA256_LENGTH]);
+
+    bool isCompressed() const { return format == FORMAT_GZIP; }
+    uint32_t streamBytes() const { return streamTotal; }
+    uint32_t imageBytes() const { return imageTotal; }
+    const char* error() const { return errorText; }
+
+private:
+    enum Format
+    {
+        FORMAT_UNKNOWN,
+        FORMAT_RAW,
+        FORMAT_GZIP
+    };
+
+    static bool hashAndForward(const uint8_t* data, size_t length, void* context);
+
+    GzipInflater inflater;
+    mbedtls_sha256_context sha;
+    InflateSink sink;
+    void* sinkContext;
+    Format format;
+    uint32_t streamTotal;
+    uint32_t imageTotal;
+    const char* errorText;
+};
+
+/**
+ * @brief Parse a 64-digit hex SHA-256
+ * @return false if the text is not exactly 64 hex digits
+ */
+bool parseSha256Hex(const char* text, uint8_t digest[OTA_SHA256_LENGTH]);
+
+/**
+ * @brief HMAC-SHA256 (RFC 2104) of message under key
+ *
+ * Used to sign pull OTA requests with the OTA password (see control_api.h).
+ * @return false if mbedtls could not compute it
+ */
+bool hmacSha256(const char* key, const uint8_t* message, size_t length, uint8_t mac[OTA_SHA256_LENGTH]);
+
+/**
+ * @brief Compare two digests in time that does not depend on where they differ
+ */
+bool digestsEqual(const uint8_t a[OTA_SHA256_LENGTH], const uint8_t b[OTA_SHA256_LENGTH]);
+
+#endif // OTA_IMAGE_STREAM_H
@@ -0,0 +1,118 @@
+/**
+ * @file ota_pull.h
+ * @brief HTTP pull OTA: compressed, resumable, verified while streaming
+ *
+ * startPullOta() downloads a firmware image on its own task and writes it
+ * to the update partition as it arrives. The image may be served gzipped
+ * (gzip -9 -n firmware.bin), in which case it is inflated on the fly and
+ * the transfer shrinks by the compression ratio. The SHA-256 of the
+ * decompressed image is computed while streaming and must match the digest
+ * given with the request before the partition is marked bootable.
+ *
+ * If the connection drops, the download resumes where it stopped with an
+ * HTTP Range request (or, from a server that ignores Range, by skipping the
+ * bytes already received), so a drop near the end does not restart the
+ * image. OTA_PULL_MAX_ATTEMPTS attempts in a row without progress give up.
+ * A raw image served without Content-Length ends when the server closes
+ * the connection; the resume request then gets 416 (nothing past the end),
+ * which completes the download.
+ *
+ * On success the device restarts into the new image.
+ *
+ * @date 2025
+ */
+
+#ifndef OTA_PULL_H
+#define OTA_PULL_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#ifndef OTA_PULL_BUFFER
+#define OTA_PULL_BUFFER 4096            ///< Bytes read from the connection per write into the pipeline
+#endif
+#ifndef OTA_PULL_MAX_ATTEMPTS
+#define OTA_PULL_MAX_ATTEMPTS 8         ///< Consecutive attempts without progress before giving up
+#endif
+#ifndef OTA_PULL_RETRY_MS
+#define OTA_PULL_RETRY_MS 2000          ///< Wait before resuming after a drop
+#endif
+#ifndef OTA_PULL_READ_TIMEOUT_MS
+#define OTA_PULL_READ_TIMEOUT_MS 10000  ///< A connection silent this long is treated as dropped
+#endif
+#ifndef OTA_PULL_PROGRESS_EVENT_MS
+#define OTA_PULL_PROGRESS_EVENT_MS 1000 ///< Interval between progress events on /events
+#endif
+#ifndef OTA_PULL_TASK_STACK
+#define OTA_PULL_TASK_STACK 8192
+#endif
+#ifndef OTA_PULL_TASK_PRIORITY
+#define OTA_PULL_TASK_PRIORITY 1
+#endif
+#ifndef OTA_PULL_TASK_CORE
+#define OTA_PULL_TASK_CORE 0            ///< With the network stack, away from the audio tasks
+#endif
+#ifndef OTA_PULL_URL_LENGTH
+#define OTA_PULL_URL_LENGTH 256
+#endif
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+enum OtaPullState : uint8_t
+{
+    OTA_PULL_IDLE,
+    OTA_PULL_DOWNLOADING,
+    OTA_PULL_DONE,          ///< Verified and bootable; the device is restarting
+    OTA_PULL_FAILED
+};
+
+enum OtaPullStartResult : uint8_t
+{
+    OTA_START_OK,
+    OTA_START_INVALID,      ///< URL or digest not usable
+    OTA_START_BUSY,         ///< A pull or push update is already running
+    OTA_START_FAILED        ///< The download task could not be created
+};
+
+/**
+ * @brief Snapshot of the current (or last) pull OTA
+ */
+struct OtaPullStatus
+{
+    OtaPullState state;
+    bool compressed;        ///< The served image is gzipped
+    uint32_t streamBytes;   ///< Bytes received from the server
+    int32_t streamSize;     ///< Size of the served file, -1 if not known yet
+    uint32_t imageBytes;    ///< Decompressed bytes written to flash
+    uint32_t resumes;       ///< Reconnects after a drop
+    uint32_t elapsedMs;
+    char error[48];
+};
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+/**
+ * @brief Start downloading and flashing an image (safe from any task)
+ * @param url Image URL (http or https), gzipped or raw
+ * @param sha256Hex SHA-256 of the decompressed image, 64 hex digits
+ * @param imageSize Decompressed size if known (lets the update check space up front), else 0
+ * @return OTA_START_OK once the download task is running, else why it did not start
+ */
+OtaPullStartResult startPullOta(const char* url, const char* sha256Hex, uint32_t imageSize);
+
+/**
+ * @brief Get the progress of the current or last pull OTA
+ */
+OtaPullStatus getPullOtaStatus();
+
+#endif // OTA_PULL_H
@@ -0,0 +1,59 @@
+/**
+ * @file response_part.h
+ * @brief Fixed-buffer parts for streamed (chunked) web responses
+ *
+ * A streamed response is produced by a nextPart() function that writes one
+ * part (a header, one record, a footer) into a ResponsePart per call and
+ * returns false once it has written the last one. fill() copies parts into
+ * whatever chunk size the connection asks for, calling nextPart() again
+ * only when the current part has been sent, so the whole body never exists
+ * in RAM at once.
+ *
+ * @date 2025
+ */
+
+#ifndef RESPONSE_PART_H
+#define RESPONSE_PART_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <functional>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#ifndef WEB_PART_BUFFER_SIZE
+#define WEB_PART_BUFFER_SIZE 2048  ///< Largest part of a streamed response (one escaped log record)
+#endif
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * @brief One part of a streamed response, collected in a fixed buffer
+ */
+struct ResponsePart : public Print
+{
+    char data[WEB_PART_BUFFER_SIZE];
+    size_t length = 0;
+    size_t sent = 0;
+    bool more = true;
+
+    size_t write(uint8_t byte) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+
+    /**
+     * @brief Copy the next chunk of the response
+     * @param buffer Chunk buffer
+     * @param maxLength Chunk buffer size
+     * @param nextPart Writes the next part; returns false after the last one
+     * @return Bytes copied; 0 once the response is complete
+     */
+    size_t fill(uint8_t* buffer, size_t maxLength, const std::function<bool(Print&)>& nextPart);
+};
+
+#endif // RESPONSE_PART_H
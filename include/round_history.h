@@ -0,0 +1,176 @@
+/**
+ * @file round_history.h
+ * @brief Round history recorder with batched binary persistence to SD
+ *
+ * Every decided round becomes one fixed-size RoundRecord (press times in
+ * microseconds, answers, outcome). Records are kept in a RAM ring and
+ * appended to ROUND_HISTORY_FILE in whole 512-byte sectors, only while the
+ * game is idle, so SD writes never compete with a round in progress. A
+ * partial sector is written once its oldest record is ROUND_HISTORY_MAX_AGE_MS
+ * old, or before an export; the next write first tops that sector up, so
+ * writes end on sector boundaries again.
+ *
+ * The file is a plain concatenation of RoundRecords (little endian, CRC32 per
+ * record); tools/decode_rounds.py decodes it on a host. RoundHistoryExport
+ * streams the files plus the records still in RAM from another task (the web
+ * server) without forcing a write.
+ *
+ * @date 2025
+ */
+
+#ifndef ROUND_HISTORY_H
+#define ROUND_HISTORY_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+#include <SD_MMC.h>
+#include "game_engine.h"
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#ifndef ROUND_HISTORY_FILE
+#define ROUND_HISTORY_FILE "/rounds.bin"            ///< Current history file
+#endif
+
+#ifndef ROUND_HISTORY_OLD_FILE
+#define ROUND_HISTORY_OLD_FILE "/rounds.old.bin"    ///< Previous file after rotation
+#endif
+
+#ifndef ROUND_HISTORY_FS
+#define ROUND_HISTORY_FS SD_MMC                     ///< Filesystem holding the history (mounted by the audio source)
+#endif
+
+#ifndef ROUND_HISTORY_RAM_RECORDS
+#define ROUND_HISTORY_RAM_RECORDS 32                ///< Records buffered in RAM (power of two)
+#endif
+
+#ifndef ROUND_HISTORY_MAX_AGE_MS
+#define ROUND_HISTORY_MAX_AGE_MS 60000              ///< Write a partial sector after this long
+#endif
+
+#ifndef ROUND_HISTORY_MAX_FILE_BYTES
+#define ROUND_HISTORY_MAX_FILE_BYTES (1024UL * 1024UL) ///< Rotate the file beyond this size
+#endif
+
+#define ROUND_RECORD_MAGIC 0x5244       ///< "DR" little endian
+#define ROUND_RECORD_VERSION 1
+#define ROUND_RECORD_SIZE 64            ///< Bytes per record (divides the sector size)
+#define ROUND_RECORD_MAX_PLAYERS 6      ///< Players with press offsets in a record
+#define ROUND_HISTORY_SECTOR_SIZE 512
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * @brief One decided round as stored on SD (little endian, packed)
+ */
+struct __attribute__((packed)) RoundRecord
+{
+    uint16_t magic;             ///< ROUND_RECORD_MAGIC
+    uint8_t version;            ///< ROUND_RECORD_VERSION
+    uint8_t station;            ///< Station index
+    uint8_t outcome;            ///< GameOutcome
+    uint8_t players;            ///< Players in the station
+    uint16_t bootCount;         ///< Boot the round was played in
+    uint32_t sequence;          ///< Round number within the boot
+    uint32_t pressedMask;       ///< Players that answered
+    uint32_t yesMask;           ///< Players whose final answer was YES
+    int32_t decideOffsetUs;     ///< Decision time relative to startUs
+    int64_t startUs;            ///< First press, esp_timer_get_time() of this boot
+    uint32_t unixTime;          ///< Wall clock seconds at the decision (0 if unknown)
+    int32_t pressOffsetUs[ROUND_RECORD_MAX_PLAYERS]; ///< Final press of each player relative to startUs
+    uint32_t crc32;             ///< CRC-32 (zlib polynomial) of all preceding bytes
+};
+
+/**
+ * @brief Recorder counters
+ */
+struct RoundHistoryStats
+{
+    uint32_t recorded;          ///< Rounds recorded into RAM
+    uint32_t persisted;         ///< Records written to SD
+    uint32_t writes;            ///< Write calls issued (one or more whole sectors each)
+    uint32_t dropped;           ///< Records lost because the RAM ring was full
+    uint32_t writeErrors;       ///< Failed opens or short writes
+    uint8_t pending;            ///< Records waiting in RAM
+};
+
+/**
+ * @brief Snapshot of the history for streaming (rotated file, current file, RAM records)
+ *
+ * begin() fixes the file lengths and copies the records not yet on SD, so the
+ * export neither misses nor repeats a round written while it is being read.
+ * The files are not rotated while an export is open. Safe to use from a task
+ * other than the one calling processRoundHistory().
+ */
+class RoundHistoryExport
+{
+public:
+    RoundHistoryExport();
+    ~RoundHistoryExport();
+
+    /**
+     * @brief Take the snapshot
+     * @return false if the history is busy or not initialized
+     */
+    bool begin();
+
+    /**
+     * @brief Total bytes of the export
+     */
+    size_t size() const;
+
+    /**
+     * @brief Read the next bytes of the export
+     * @return Bytes copied (0 at the end)
+     */
+    size_t read(uint8_t* buffer, size_t length);
+
+private:
+    File files[2];
+    size_t fileBytes[2];
+    RoundRecord pending[ROUND_HISTORY_RAM_RECORDS];
+    uint32_t pendingRecords;
+    size_t position;
+    bool active;
+};
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+/**
+ * @brief Initialize the recorder (call after the filesystem is mounted)
+ */
+void initRoundHistory();
+
+/**
+ * @brief Feed a game event
+ * @param event Event from the GameEngine
+ * @param timeUs Microsecond time of the event (the press time for GAME_EVENT_PRESS)
+ */
+void recordGameEvent(const GameEvent& event, int64_t timeUs);
+
+/**
+ * @brief Write buffered records when due (call this in main loop)
+ * @param idle true when no round is in progress and no press is pending
+ *             (hasButtonEvents() is false)
+ */
+void processRoundHistory(bool idle);
+
+/**
+ * @brief Write every buffered record now
+ */
+void flushRoundHistory();
+
+/**
+ * @brief Get a snapshot of the recorder counters
+ */
+RoundHistoryStats getRoundHistoryStats();
+
+#endif // ROUND_HISTORY_H
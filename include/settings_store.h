@@ -0,0 +1,129 @@
+/**
+ * @file settings_store.h
+ * @brief Write-behind settings store backed by NVS
+ *
+ * Settings are cached in RAM. Writes only mark the key dirty; dirty keys are
+ * committed to NVS in one batch per namespace once they have been quiet for
+ * SETTINGS_FLUSH_DELAY_MS (or dirty for SETTINGS_MAX_DIRTY_MS). Ramping a
+ * value therefore costs one flash write instead of one per step.
+ *
+ * Pending writes are flushed on OTA start and from an ESP shutdown handler,
+ * so ESP.restart() does not lose them.
+ *
+ * @date 2025
+ */
+
+#ifndef SETTINGS_STORE_H
+#define SETTINGS_STORE_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <Arduino.h>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#ifndef SETTINGS_MAX_ENTRIES
+#define SETTINGS_MAX_ENTRIES 16         ///< Distinct namespace/key pairs cached in RAM
+#endif
+
+#ifndef SETTINGS_MAX_STRING
+#define SETTINGS_MAX_STRING 65          ///< Max string value length including terminator
+#endif
+
+#ifndef SETTINGS_FLUSH_DELAY_MS
+#define SETTINGS_FLUSH_DELAY_MS 2000    ///< Flush once no key has changed for this long
+#endif
+
+#ifndef SETTINGS_MAX_DIRTY_MS
+#define SETTINGS_MAX_DIRTY_MS 10000     ///< Flush at the latest this long after the first change
+#endif
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * @brief Settings store counters
+ */
+struct SettingsStats
+{
+    uint32_t puts;          ///< put*() calls
+    uint32_t coalesced;     ///< put*() calls absorbed by RAM (no flash write of their own)
+    uint32_t flushes;       ///< Batched flushes performed
+    uint32_t nvsCommits;    ///< NVS namespace commits (one per namespace per flush)
+    uint32_t nvsKeyWrites;  ///< Individual keys written to NVS
+    uint32_t nvsErrors;     ///< Failed NVS opens or writes
+    uint8_t dirtyKeys;      ///< Keys waiting to be flushed
+};
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+/**
+ * @brief Initialize the store and register the shutdown flush handler
+ */
+void initSettings();
+
+/**
+ * @brief Read a float setting (loaded from NVS on first access)
+ */
+float getSettingFloat(const char* ns, const char* key, float defaultValue);
+
+/**
+ * @brief Read an integer setting (loaded from NVS on first access)
+ */
+int32_t getSettingInt(const char* ns, const char* key, int32_t defaultValue);
+
+/**
+ * @brief Read a string setting (loaded from NVS on first access)
+ */
+String getSettingString(const char* ns, const char* key, const char* defaultValue = "");
+
+/**
+ * @brief Read a binary setting (loaded from NVS on first access)
+ * @return Stored length (0 if missing); at most length bytes are copied
+ */
+size_t getSettingBytes(const char* ns, const char* key, void* buffer, size_t length);
+
+/**
+ * @brief Write a float setting (RAM only until the next flush)
+ */
+void putSettingFloat(const char* ns, const char* key, float value);
+
+/**
+ * @brief Write an integer setting (RAM only until the next flush)
+ */
+void putSettingInt(const char* ns, const char* key, int32_t value);
+
+/**
+ * @brief Write a string setting (RAM only until the next flush)
+ */
+void putSettingString(const char* ns, const char* key, const char* value);
+
+/**
+ * @brief Write a binary setting of up to SETTINGS_MAX_STRING bytes (RAM only until the next flush)
+ * An empty value removes the key from NVS.
+ */
+void putSettingBytes(const char* ns, const char* key, const void* value, size_t length);
+
+/**
+ * @brief Commit all dirty keys to NVS now
+ */
+void flushSettings();
+
+/**
+ * @brief Flush dirty keys when they are due (call this in main loop)
+ * @return true if a flush was performed
+ */
+bool processSettings();
+
+/**
+ * @brief Get a snapshot of the settings counters
+ */
+SettingsStats getSettingsStats();
+
+#endif // SETTINGS_STORE_H
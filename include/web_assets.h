@@ -0,0 +1,153 @@
+/**
+ * @file web_assets.h
+ * @brief Gzipped web assets, generated by tools/gzip_web_assets.py from web/ - do not edit
+ *
+ * @date 2025
+ */
+
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+
+struct WebAsset
+{
+    const char* path;           ///< URL the asset is served at
+    const char* contentType;
+    const char* etag;           ///< Quoted hash of the uncompressed content
+    bool fingerprinted;         ///< The URL carries the hash, so it never changes content
+    const uint8_t* data;        ///< gzip stream (Content-Encoding: gzip)
+    size_t length;
+};
+
+// logs.js: 1155 bytes, 614 gzipped
+static const uint8_t web_logs_js[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xad, 0x53, 0x4d, 0x6f, 0xdb, 0x30,
+    0x0c, 0xbd, 0xfb, 0x57, 0x78, 0x97, 0x5a, 0x42, 0x0c, 0x2d, 0x1d, 0xb0, 0x4b, 0x35, 0xb7, 0x58,
+    0x8b, 0x0e, 0xdb, 0xb0, 0x74, 0x40, 0xdb, 0x3f, 0xa0, 0x5a, 0x74, 0xe2, 0x40, 0x96, 0x3a, 0x49,
+    0x4e, 0x1a, 0xb8, 0xf9, 0xef, 0x23, 0x65, 0xa7, 0x69, 0x37, 0xec, 0xb6, 0x9b, 0xf8, 0x25, 0x3e,
+    0xbe, 0x47, 0x6e, 0x94, 0xcf, 0x8d, 0x0a, 0xb1, 0x9a, 0x97, 0x9d, 0x7a, 0xaa, 0x3e, 0xce, 0xe7,
+    0xe5, 0x43, 0x1f, 0x76, 0x55, 0xa3, 0x4c, 0x80, 0x52, 0x2d, 0x55, 0x6b, 0xa7, 0x37, 0x84, 0xca,
+    0xf6, 0xc6, 0x94, 0x0f, 0xee, 0xa9, 0xd2, 0xae, 0xee, 0x3b, 0xb0, 0x51, 0x2c, 0x21, 0x5e, 0x1b,
+    0xa0, 0xe7, 0xe5, 0xee, 0x9b, 0x66, 0x85, 0x71, 0xcb, 0x50, 0xf0, 0x32, 0x44, 0x15, 0xc3, 0xbf,
+    0xb3, 0x52, 0xb8, 0xe0, 0x32, 0x6b, 0x7a, 0x5b, 0xc7, 0xd6, 0xd9, 0x5c, 0x69, 0xcd, 0x80, 0x0f,
+    0x1b, 0x44, 0xa3, 0x8f, 0x75, 0xb5, 0x07, 0x15, 0x61, 0x2a, 0x65, 0x85, 0x6e, 0x37, 0x58, 0xa4,
+    0x45, 0x8d, 0x80, 0xc3, 0x8d, 0xea, 0xa0, 0xa2, 0x7e, 0xb9, 0x29, 0x66, 0x20, 0x0c, 0x6c, 0xc0,
+    0xc8, 0x4c, 0x8b, 0x08, 0x4f, 0xf1, 0xca, 0xd9, 0x88, 0x15, 0x15, 0x88, 0x38, 0x2b, 0xba, 0x70,
+    0x96, 0x53, 0x46, 0x17, 0x96, 0x12, 0xb1, 0x8b, 0xd6, 0x06, 0xf0, 0xf1, 0x12, 0x1a, 0xe7, 0x81,
+    0x69, 0x1a, 0x47, 0x34, 0xad, 0x0f, 0xf1, 0x6a, 0xd5, 0x1a, 0xcd, 0x65, 0x22, 0x03, 0x44, 0x80,
+    0x5f, 0x32, 0xdb, 0xa2, 0x0b, 0x18, 0x65, 0xd4, 0x14, 0xbc, 0x71, 0x1a, 0x02, 0x76, 0xb2, 0xcb,
+    0xb8, 0x3a, 0x47, 0xb6, 0x4e, 0x4e, 0x28, 0x44, 0x05, 0x63, 0x2d, 0x59, 0x1e, 0x3a, 0xb7, 0x81,
+    0x64, 0xb3, 0xb7, 0x51, 0xb9, 0x3f, 0x8e, 0xfb, 0xe8, 0x8c, 0x61, 0x7c, 0x68, 0x1b, 0x46, 0x64,
+    0xf3, 0x61, 0xe4, 0x39, 0xfa, 0x1e, 0xa4, 0x87, 0xd8, 0x7b, 0x2b, 0xf7, 0x49, 0x85, 0xe4, 0xc9,
+    0x1a, 0x88, 0xf5, 0x8a, 0x15, 0xef, 0x89, 0x5c, 0xb1, 0x0e, 0xce, 0x5e, 0x84, 0xd6, 0xd6, 0x38,
+    0xfd, 0x8c, 0x7e, 0xe7, 0x22, 0xae, 0xc0, 0xb2, 0xc3, 0xdf, 0xcc, 0xf3, 0x61, 0xfc, 0x23, 0xf7,
+    0x82, 0x88, 0xee, 0x43, 0x55, 0x7d, 0x98, 0xcf, 0x2f, 0x7c, 0x2a, 0x65, 0xfc, 0x8c, 0x54, 0x94,
+    0xfb, 0x3f, 0xcb, 0xd6, 0x7c, 0xc8, 0x10, 0xcf, 0xbb, 0x35, 0x9f, 0x10, 0x90, 0xb5, 0x4e, 0xf8,
+    0x3f, 0xa5, 0x36, 0x23, 0x77, 0x16, 0xfc, 0xd7, 0xfb, 0xc5, 0x8f, 0xaa, 0x28, 0x64, 0x86, 0x51,
+    0x42, 0x84, 0x44, 0x5e, 0x2b, 0x04, 0x88, 0x1a, 0x72, 0x49, 0x4b, 0xb4, 0x50, 0x71, 0x25, 0xf0,
+    0x81, 0xe5, 0xb5, 0xeb, 0x6d, 0x2c, 0x4f, 0xf9, 0xff, 0xe6, 0x32, 0x4b, 0x32, 0x8d, 0xf0, 0x64,
+    0x5a, 0xa7, 0x37, 0xc2, 0x17, 0xf7, 0x2e, 0x2a, 0x93, 0x2f, 0x20, 0x04, 0xb5, 0x84, 0xb4, 0x00,
+    0x13, 0x96, 0x59, 0x91, 0x3f, 0xe7, 0x5f, 0x3c, 0x40, 0x7e, 0xfb, 0x79, 0x31, 0xfa, 0x1b, 0xb4,
+    0x6e, 0x55, 0x87, 0x91, 0x87, 0x5d, 0x84, 0x80, 0x83, 0x21, 0x39, 0xb5, 0x22, 0xce, 0x5f, 0xd8,
+    0xe1, 0xc3, 0x5f, 0x84, 0xf1, 0xe1, 0x78, 0x28, 0x12, 0xb9, 0x4a, 0x1a, 0x1e, 0xa4, 0x1c, 0xbd,
+    0xa3, 0xcc, 0x72, 0x0f, 0x68, 0xe4, 0x44, 0x2e, 0x04, 0x1e, 0x20, 0xde, 0xb7, 0x1d, 0xb8, 0x3e,
+    0x32, 0x0a, 0x97, 0x78, 0x71, 0x73, 0x4c, 0xa1, 0xf5, 0xc0, 0x8c, 0x6d, 0x6b, 0xb5, 0xdb, 0x8a,
+    0xeb, 0x0d, 0x4e, 0x71, 0xe7, 0x7a, 0x5f, 0xe3, 0x51, 0xd0, 0xe1, 0xc1, 0x36, 0x7f, 0xe5, 0xc3,
+    0x5d, 0x00, 0xb2, 0xd2, 0x0d, 0x21, 0x8d, 0xc8, 0x7c, 0x8a, 0xfe, 0x68, 0x03, 0x8e, 0x0f, 0x3e,
+    0xdd, 0x61, 0x51, 0xbe, 0x40, 0xed, 0xc6, 0xcb, 0x82, 0xea, 0xfb, 0xdd, 0xcf, 0x1b, 0xf1, 0xa8,
+    0x7c, 0x00, 0xd6, 0x09, 0xad, 0xa2, 0xe2, 0x72, 0xda, 0xc1, 0xe7, 0xe7, 0xb4, 0xf3, 0xe7, 0x44,
+    0xe8, 0xec, 0x94, 0x4f, 0xc8, 0x0f, 0xc0, 0x8f, 0x31, 0x3e, 0x5e, 0x2a, 0x01, 0xa6, 0xce, 0x0e,
+    0xbb, 0x79, 0xe7, 0xab, 0x57, 0xac, 0x50, 0x7a, 0x40, 0xed, 0x94, 0xde, 0xdd, 0xa1, 0x30, 0x80,
+    0xdb, 0x37, 0xce, 0x40, 0x6b, 0x77, 0x60, 0x64, 0x8f, 0xe3, 0x4e, 0xef, 0xec, 0x37, 0xbc, 0x4a,
+    0x44, 0xda, 0x83, 0x04, 0x00, 0x00,
+};
+
+// index.html: 881 bytes, 540 gzipped
+static const uint8_t web_index_html[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x5d, 0x93, 0x5f, 0x8a, 0xdb, 0x30,
+    0x10, 0xc6, 0xdf, 0x7d, 0x0a, 0x55, 0x4b, 0xdf, 0xea, 0xda, 0x49, 0xbb, 0xec, 0xe2, 0x7f, 0x50,
+    0x76, 0x5b, 0x28, 0x14, 0x36, 0x90, 0xa5, 0xa5, 0x8f, 0xb2, 0x24, 0xdb, 0xc3, 0xca, 0x92, 0x2b,
+    0xc9, 0x49, 0x4c, 0xc8, 0x5b, 0x6f, 0xd0, 0x03, 0xf4, 0x0c, 0xbd, 0x59, 0x8f, 0xd0, 0x71, 0xec,
+    0x34, 0xd9, 0xc5, 0x60, 0x90, 0xf9, 0xbe, 0x9f, 0x66, 0xbe, 0x19, 0x67, 0xaf, 0xee, 0x1f, 0xee,
+    0x1e, 0xbf, 0xaf, 0x3e, 0x92, 0xc6, 0xb7, 0xaa, 0xc8, 0xe6, 0xb7, 0x64, 0xa2, 0xc8, 0x3c, 0x78,
+    0x25, 0x8b, 0x6f, 0xf0, 0x09, 0xc8, 0x5a, 0xfa, 0xbe, 0xcb, 0xa2, 0xe9, 0x4b, 0x90, 0xb5, 0xd2,
+    0x33, 0xa2, 0x59, 0x2b, 0x73, 0xba, 0x01, 0xb9, 0xed, 0x8c, 0xf5, 0x94, 0x70, 0xa3, 0xbd, 0xd4,
+    0x3e, 0xa7, 0x5b, 0x10, 0xbe, 0xc9, 0x85, 0xdc, 0x00, 0x97, 0xe1, 0xf1, 0xf0, 0x06, 0x34, 0x78,
+    0x60, 0x2a, 0x74, 0x9c, 0x29, 0x99, 0x2f, 0x28, 0x32, 0x9c, 0x1f, 0x90, 0x55, 0x1a, 0x31, 0xec,
+    0x2b, 0x74, 0x86, 0x15, 0x6b, 0x41, 0x0d, 0xc9, 0x07, 0x8b, 0xba, 0xb4, 0x65, 0xb6, 0x06, 0x9d,
+    0x2c, 0xe3, 0x6e, 0x97, 0x96, 0x8c, 0x3f, 0xd5, 0xd6, 0xf4, 0x5a, 0x24, 0x57, 0x55, 0x3c, 0x3e,
+    0x87, 0xe0, 0x2d, 0xdf, 0xb7, 0x6c, 0x37, 0xc1, 0x93, 0x77, 0xf1, 0x28, 0x9b, 0x2d, 0xac, 0xf7,
+    0xe6, 0xd2, 0xb2, 0x6d, 0xc0, 0xcb, 0xb4, 0x63, 0x42, 0x80, 0xae, 0x67, 0xa0, 0xb1, 0x42, 0xda,
+    0xd0, 0x32, 0x01, 0xbd, 0x4b, 0xae, 0xbb, 0xdd, 0x21, 0x00, 0xdd, 0xf5, 0x7e, 0x3f, 0xe1, 0x16,
+    0x71, 0xfc, 0xfa, 0xbf, 0xe1, 0xf6, 0x4c, 0x46, 0x21, 0x89, 0x67, 0x73, 0xb2, 0xc0, 0x83, 0x33,
+    0x0a, 0x04, 0xb9, 0x12, 0x42, 0x1c, 0x82, 0xb2, 0xf7, 0xde, 0xe8, 0x4b, 0xc2, 0x65, 0xd9, 0x71,
+    0x7c, 0xc3, 0x4b, 0x96, 0x72, 0xa3, 0x8c, 0x7d, 0x51, 0xd1, 0xe2, 0x5c, 0x51, 0xa2, 0x8d, 0x96,
+    0x29, 0xef, 0xad, 0x43, 0x55, 0x67, 0x00, 0xe3, 0xb4, 0xcf, 0x2e, 0xc7, 0xbe, 0x95, 0xa9, 0x5d,
+    0x58, 0x7a, 0xbd, 0xbf, 0xc4, 0x2f, 0x6f, 0xd9, 0xcd, 0xfb, 0xeb, 0xd4, 0xcb, 0x9d, 0x0f, 0x85,
+    0xe4, 0xc6, 0x32, 0x0f, 0x46, 0x4f, 0x38, 0x01, 0xae, 0x53, 0x6c, 0x48, 0x4a, 0x65, 0xf8, 0xd3,
+    0x24, 0x61, 0x0a, 0x6a, 0x9d, 0x70, 0x39, 0xf2, 0x0f, 0x41, 0x16, 0x4d, 0x93, 0xc8, 0xa2, 0x69,
+    0xea, 0xe3, 0x44, 0x8a, 0x4c, 0xc0, 0x86, 0x70, 0xc5, 0x9c, 0xcb, 0x29, 0xa7, 0xb8, 0x10, 0xcb,
+    0xe2, 0xef, 0xef, 0x5f, 0x7f, 0xc8, 0x71, 0x19, 0xee, 0x8c, 0xae, 0xa0, 0x46, 0xfd, 0x12, 0xc7,
+    0x58, 0x19, 0xdb, 0x12, 0xc6, 0xc7, 0x0b, 0x73, 0x1a, 0x39, 0xb6, 0x91, 0x94, 0xe0, 0x7a, 0x34,
+    0x46, 0xe4, 0x74, 0xf5, 0xb0, 0x7e, 0x1c, 0x47, 0x7d, 0x4c, 0x97, 0xf8, 0xa1, 0xc3, 0x7d, 0x19,
+    0x2b, 0xa0, 0xf3, 0xee, 0x38, 0x07, 0x82, 0x12, 0x2c, 0x8f, 0xcb, 0xc6, 0x28, 0x4c, 0x20, 0xa7,
+    0xd3, 0xb6, 0xad, 0x3f, 0xdf, 0x53, 0x62, 0xe5, 0x8f, 0x1e, 0xac, 0x14, 0x2f, 0x00, 0x1d, 0x16,
+    0xb5, 0xc5, 0xbc, 0x4e, 0x90, 0xf3, 0xf9, 0x19, 0x68, 0x75, 0xfa, 0x8c, 0xf6, 0x69, 0x38, 0xb3,
+    0xdf, 0xf5, 0x65, 0x0b, 0x9e, 0x16, 0xd8, 0x85, 0x96, 0x1c, 0xa9, 0xe6, 0xd8, 0x55, 0x16, 0x4d,
+    0x2a, 0xcc, 0x61, 0x6c, 0x09, 0x5d, 0x8c, 0x34, 0x56, 0x56, 0xd8, 0xd4, 0x98, 0x39, 0x3d, 0xa5,
+    0x71, 0x1a, 0x00, 0x99, 0xe4, 0x74, 0xcc, 0xe5, 0x27, 0xf9, 0x8a, 0x7f, 0x01, 0x59, 0x0f, 0xce,
+    0xcb, 0x96, 0x7c, 0x41, 0x45, 0x16, 0x31, 0x24, 0x44, 0x98, 0x22, 0xf2, 0xa6, 0x44, 0xa3, 0xe3,
+    0xaf, 0x15, 0xfc, 0x03, 0x8b, 0x08, 0xee, 0x17, 0x71, 0x03, 0x00, 0x00,
+};
+
+// logs.html: 978 bytes, 533 gzipped
+static const uint8_t web_logs_html[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x93, 0xbb, 0x8e, 0xd4, 0x30,
+    0x14, 0x86, 0xfb, 0x79, 0x0a, 0x13, 0x5a, 0x72, 0x9d, 0x99, 0x55, 0x94, 0x49, 0xd2, 0x00, 0x12,
+    0xc5, 0x4a, 0x20, 0xa0, 0xa1, 0x3c, 0x63, 0x9f, 0x64, 0xcc, 0x3a, 0x76, 0x64, 0x7b, 0xe7, 0xc2,
+    0xb0, 0x1d, 0x3d, 0x05, 0xf4, 0xf0, 0x0a, 0xbc, 0x19, 0x8f, 0x80, 0x9d, 0xcc, 0x55, 0x1a, 0x89,
+    0x26, 0xf2, 0xe5, 0x3f, 0x9f, 0xfd, 0x1f, 0xff, 0x29, 0x9f, 0xbd, 0x7a, 0xfb, 0xf2, 0xe3, 0xa7,
+    0x77, 0xaf, 0xc9, 0xca, 0x76, 0xa2, 0x2e, 0x0f, 0x5f, 0x04, 0x56, 0x97, 0x96, 0x5b, 0x81, 0xf5,
+    0x87, 0x9d, 0xb1, 0xd8, 0x91, 0x7b, 0xd5, 0x9a, 0x32, 0x1e, 0x97, 0x26, 0x65, 0x87, 0x16, 0x88,
+    0x84, 0x0e, 0xab, 0x60, 0xcd, 0x71, 0xd3, 0x2b, 0x6d, 0x03, 0x42, 0x95, 0xb4, 0x28, 0x6d, 0x15,
+    0x6c, 0x38, 0xb3, 0xab, 0x8a, 0xe1, 0x9a, 0x53, 0x0c, 0x87, 0xc9, 0x0b, 0x2e, 0xb9, 0xe5, 0x20,
+    0x42, 0x43, 0x41, 0x60, 0x95, 0x06, 0x8e, 0x61, 0xec, 0xce, 0xb3, 0x96, 0x8a, 0xed, 0xf6, 0x8d,
+    0x2b, 0x0d, 0x1b, 0xe8, 0xb8, 0xd8, 0x15, 0x9d, 0x92, 0xca, 0xf4, 0x40, 0x71, 0xd1, 0x81, 0x6e,
+    0xb9, 0x2c, 0xd2, 0xa4, 0xdf, 0x2e, 0x96, 0x40, 0x1f, 0x5a, 0xad, 0x1e, 0x25, 0x2b, 0x9e, 0x27,
+    0x49, 0xb2, 0xa0, 0x4a, 0x28, 0xed, 0x86, 0x4d, 0xf2, 0x34, 0x89, 0xfc, 0x7d, 0x51, 0xef, 0x2f,
+    0x35, 0xd3, 0xe9, 0xf4, 0xa8, 0x69, 0x9a, 0x66, 0xd1, 0x03, 0x63, 0x5c, 0xb6, 0x23, 0x6b, 0xe4,
+    0x86, 0x4b, 0x65, 0xad, 0xea, 0x0e, 0x78, 0xa5, 0x1d, 0x21, 0xd4, 0xc0, 0xf8, 0xa3, 0x29, 0xa6,
+    0xfd, 0xd6, 0x51, 0x85, 0x6a, 0xaf, 0x90, 0x69, 0x9a, 0x9e, 0x38, 0xf3, 0x13, 0xa6, 0xc8, 0xfa,
+    0x2d, 0x49, 0x8e, 0x00, 0x81, 0x8d, 0xf5, 0xe5, 0xc4, 0x28, 0xc1, 0x19, 0xf1, 0xf7, 0x5b, 0x0c,
+    0xe6, 0x0c, 0xff, 0x82, 0x45, 0xea, 0xb4, 0x8b, 0x8d, 0x53, 0x86, 0x1b, 0x0d, 0x7d, 0xb1, 0xd4,
+    0x08, 0x0f, 0xa1, 0x9f, 0xfb, 0xd3, 0xd2, 0xfd, 0x05, 0x23, 0x3c, 0xde, 0xfd, 0x6c, 0xb5, 0xb9,
+    0xbb, 0x7b, 0x8a, 0x44, 0x76, 0x53, 0x05, 0x67, 0x15, 0xf5, 0xaa, 0xd9, 0xfe, 0x30, 0xcd, 0xf3,
+    0xdc, 0xb1, 0x25, 0xac, 0xaf, 0x9c, 0xcc, 0x66, 0xb3, 0xff, 0x76, 0xc4, 0xe2, 0xd6, 0x86, 0x20,
+    0x78, 0x2b, 0x0b, 0xea, 0x5e, 0x15, 0xf5, 0xc8, 0x21, 0xb0, 0x3f, 0xb5, 0xbe, 0x19, 0x45, 0x0c,
+    0xa9, 0xd2, 0x60, 0xb9, 0x92, 0x85, 0x54, 0xf2, 0xf4, 0x6c, 0x09, 0xf1, 0x1c, 0x57, 0x65, 0x2c,
+    0x58, 0x73, 0x75, 0x7e, 0x96, 0x65, 0xb7, 0x1e, 0xe7, 0xa2, 0xa9, 0xf3, 0xa1, 0xa9, 0x17, 0x9d,
+    0x4b, 0x3d, 0xaa, 0x8c, 0xc7, 0xd0, 0x94, 0xf1, 0x98, 0x50, 0x9f, 0x1d, 0x97, 0x24, 0xc6, 0xd7,
+    0x84, 0x0a, 0x30, 0xa6, 0x0a, 0xc6, 0x24, 0x04, 0x2e, 0xc2, 0x59, 0xfd, 0xf7, 0xd7, 0x8f, 0x3f,
+    0xe4, 0x2a, 0xbe, 0x6e, 0xb1, 0x8c, 0x9d, 0xfa, 0xba, 0xc6, 0xb9, 0xf2, 0x79, 0x04, 0xb2, 0xd2,
+    0xd8, 0x54, 0x41, 0x1c, 0xb8, 0xca, 0xef, 0xbf, 0xc9, 0x1b, 0xd5, 0x61, 0x19, 0x43, 0x4d, 0xbe,
+    0x92, 0xf3, 0x9e, 0xcb, 0x84, 0xf1, 0xfb, 0x3f, 0xbf, 0x91, 0xf7, 0xd8, 0x68, 0x34, 0x2b, 0x2f,
+    0x99, 0xdc, 0xa0, 0x0e, 0xae, 0x03, 0xc2, 0xd9, 0x71, 0x58, 0xdf, 0x2b, 0xf0, 0x36, 0xa3, 0x28,
+    0x1a, 0xe5, 0x83, 0xda, 0xef, 0x8f, 0xd0, 0x23, 0xc3, 0x50, 0xcd, 0x7b, 0x4b, 0x8c, 0xa6, 0x87,
+    0xf3, 0xa2, 0x24, 0x5b, 0xe2, 0x3c, 0xcb, 0x73, 0x48, 0x58, 0x4e, 0x13, 0x9a, 0x46, 0x9f, 0x07,
+    0xf9, 0x28, 0x74, 0x83, 0xa1, 0x0d, 0xce, 0x9d, 0xff, 0x77, 0x27, 0xff, 0x00, 0x35, 0x02, 0xd9,
+    0xe0, 0xd2, 0x03, 0x00, 0x00,
+};
+
+static const WebAsset webAssets[] = {
+    {"/logs.02be5288a0d8c0c1.js", "application/javascript", "\"02be5288a0d8c0c1\"", true, web_logs_js, sizeof(web_logs_js)},
+    {"/", "text/html", "\"521ef8dc409d1f75\"", false, web_index_html, sizeof(web_index_html)},
+    {"/logs", "text/html", "\"8b580ec090bddbad\"", false, web_logs_html, sizeof(web_logs_html)},
+};
+
+#define WEB_ASSET_LOGS_JS 0
+#define WEB_ASSET_INDEX_HTML 1
+#define WEB_ASSET_LOGS_HTML 2
+#define WEB_ASSET_COUNT 3
+
+#endif // WEB_ASSETS_H
@@ -2,10 +2,10 @@
 #define WIFI_MANAGER_H
 
 #include <WiFi.h>
-#include <WebServer.h>
+#include <ESPAsyncWebServer.h>
 #include <DNSServer.h>
-#include <Preferences.h>
 #include <ArduinoOTA.h>
+#include <functional>
 
 // Type definition for WiFi connection callback
 typedef void (*WiFiConnectedCallback)();
@@ -23,6 +23,47 @@ typedef void (*WiFiConnectedCallback)();
 #define WIFI_PORTAL_TIMEOUT 180
 #endif
 
+// Config portal bring-up pacing; handleWiFiLoop() returns between steps
+#ifndef WIFI_PORTAL_OFF_SETTLE_MS
+#define WIFI_PORTAL_OFF_SETTLE_MS 2000  // After WiFi off, before switching to AP mode
+#endif
+
+#ifndef WIFI_PORTAL_SETTLE_MS
+#define WIFI_PORTAL_SETTLE_MS 1000      // After each successful step
+#endif
+
+#ifndef WIFI_PORTAL_RETRY_MS
+#define WIFI_PORTAL_RETRY_MS 1000       // Before retrying a failed step
+#endif
+
+#ifndef WIFI_PORTAL_RETRIES
+#define WIFI_PORTAL_RETRIES 3
+#endif
+
+#ifndef WIFI_FAST_CONNECT_TIMEOUT_MS
+#define WIFI_FAST_CONNECT_TIMEOUT_MS 4000  // Give up on the saved BSSID/channel and scan
+#endif
+
+// Reconnect with the last DHCP lease as a static address, skipping DHCP. Off
+// by default: the device never renews that lease, so only enable it if the
+// router reserves the address for this device.
+#ifndef WIFI_REUSE_LEASE
+#define WIFI_REUSE_LEASE 0
+#endif
+
+// Optional static address, e.g. -DWIFI_STATIC_IP=\"192.168.1.50\" -DWIFI_STATIC_GATEWAY=\"192.168.1.1\"
+#ifdef WIFI_STATIC_IP
+#ifndef WIFI_STATIC_GATEWAY
+#error "WIFI_STATIC_IP needs WIFI_STATIC_GATEWAY"
+#endif
+#ifndef WIFI_STATIC_SUBNET
+#define WIFI_STATIC_SUBNET "255.255.255.0"
+#endif
+#ifndef WIFI_STATIC_DNS
+#define WIFI_STATIC_DNS WIFI_STATIC_GATEWAY
+#endif
+#endif
+
 // OTA configuration - Use build flags or defaults
 #ifndef OTA_HOSTNAME
 #define OTA_HOSTNAME "espaudio"
@@ -36,8 +77,24 @@ typedef void (*WiFiConnectedCallback)();
 #define OTA_PORT 3232
 #endif
 
+// Fingerprinted assets (/logs.<hash>.js) never change; pages revalidate against their ETag
+#ifndef WEB_ASSET_CACHE_CONTROL
+#define WEB_ASSET_CACHE_CONTROL "public, max-age=31536000, immutable"
+#endif
+
+#ifndef WEB_PAGE_CACHE_CONTROL
+#define WEB_PAGE_CACHE_CONTROL "no-cache"
+#endif
+
 // Function declarations
-void handleLogs();
+AsyncWebServerResponse* beginPartResponse(AsyncWebServerRequest* request, const char* contentType,
+                                          std::function<bool(Print&)> nextPart);
+void handleLogs(AsyncWebServerRequest* request);
+void handleLogsJson(AsyncWebServerRequest* request);
+void handleRounds(AsyncWebServerRequest* request);
+void handleMetrics(AsyncWebServerRequest* request);
+void handleBoot(AsyncWebServerRequest* request);
+void startWebServer();
 void initWiFi(WiFiConnectedCallback onConnected = nullptr);
 void initOTA();
 void startOTA();
@@ -46,14 +103,13 @@ bool connectToWiFi();
 void saveWiFiCredentials(const String& ssid, const String& password);
 void startConfigPortal();
 bool startConfigPortalSafe();
-void handleRoot();
-void handleSave();
+void handleRoot(AsyncWebServerRequest* request);
+void handleSave(AsyncWebServerRequest* request);
 void handleWiFiLoop();
 
 // External variables (defined in wifi_manager.cpp)
-extern WebServer server;
+extern AsyncWebServer server;
 extern DNSServer dnsServer;
-extern Preferences wifiPrefs;
 extern bool isConfigMode;
 extern unsigned long portalStartTime;
 
@@ -7,27 +7,20 @@
  * @date 2025
  */
 
+#define LOG_MODULE LOG_MODULE_FILES
 #include "audio_file_manager.h"
+#include "logging.h"
+#include "metrics.h"
+#include "event_stream.h"
+#include "boot_profiler.h"
+#include "catalog_stream.h"
 #include <WiFi.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <SD.h>
 #include <FS.h>
-
-// ============================================================================
-// STRUCTURES
-// ============================================================================
-
-/**
- * @brief Structure for audio download queue items
- */
-struct AudioDownloadItem
-{
-    char url[256];          ///< Original URL to download
-    char localPath[128];    ///< Local SD card path for the file
-    char description[64];   ///< Description for logging
-    bool inProgress;        ///< Whether download is currently in progress
-};
+#include <esp_timer.h>
+#include <new>
 
 // ============================================================================
 // GLOBAL VARIABLES
@@ -43,10 +36,66 @@ static AudioDownloadItem downloadQueue[MAX_DOWNLOAD_QUEUE];
 static int downloadQueueCount = 0;
 static int downloadQueueIndex = 0; // Current processing index
 
+// The boot load task fills the catalog first; once it gives catalogLoaded
+// the loop task owns the catalog and the download queue. Loop-task callers
+// wait for that (waitForAudioCatalog(0)) before touching the catalog, and
+// downloadAudio() refuses to run before it. The mutex keeps readers on other
+// tasks (visitAudioKey, visitDownloadItem) from seeing an entry while it is
+// freed or reused
+static SemaphoreHandle_t catalogMutex = nullptr;
+
+// Given once the boot-time catalog load has finished
+static SemaphoreHandle_t catalogLoaded = nullptr;
+
+// Exported at /metrics
+static MetricCounter downloadBytes("download_bytes_total", "Bytes downloaded (audio files and catalog)");
+static MetricCounter downloadFailures("download_failures_total", "Downloads that did not return HTTP 200");
+static MetricHistogram downloadTtfb("download_ttfb_ms", "Request start to response headers received");
+static MetricGauge downloadRate("download_last_bytes_per_second", "Throughput of the last audio file download");
+static MetricCounter catalogLookups("catalog_lookups_total", "Audio key lookups in the catalog");
+static MetricCounter catalogMisses("catalog_lookup_misses_total", "Audio key lookups that found no entry");
+static MetricHistogram catalogLookupTime("catalog_lookup_duration_us", "Time to find an audio key in the catalog");
+static MetricGauge catalogWireBytes("catalog_last_download_bytes", "Bytes on the wire for the last catalog download");
+static MetricGauge catalogLoadTime("catalog_last_download_ms", "Time to receive and parse the last catalog download");
+
 // ============================================================================
 // HELPER FUNCTIONS
 // ============================================================================
 
+// Before initializeAudioFileManager() creates the mutex only setup() is running
+static bool lockCatalog(TickType_t timeout = portMAX_DELAY)
+{
+    return !catalogMutex || xSemaphoreTake(catalogMutex, timeout) == pdTRUE;
+}
+
+static void unlockCatalog()
+{
+    if (catalogMutex)
+    {
+        xSemaphoreGive(catalogMutex);
+    }
+}
+
+static void freeAudioFiles(AudioFile* files, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        free((void*)files[i].audioKey);
+        free((void*)files[i].description);
+        free((void*)files[i].type);
+        free((void*)files[i].path);
+    }
+}
+
+/**
+ * @brief Free the catalog strings and empty it (caller holds the catalog lock)
+ */
+static void freeAudioKeys()
+{
+    freeAudioFiles(knownFiles, knownSequenceCount);
+    knownSequenceCount = 0;
+}
+
 /**
  * @brief Initialize SD card if not already done
  * @return true if SD card is ready, false otherwise
@@ -58,22 +107,22 @@ static bool initializeSDCard()
         return true;
     }
     
-    Serial.println("🔧 Initializing SD card...");
+    LOG_INFO("🔧 Initializing SD card...");
     
     if (!SD.begin(SD_CS_PIN))
     {
-        Serial.println("❌ SD card initialization failed");
+        LOG_ERROR("❌ SD card initialization failed");
         return false;
     }
     
     uint8_t cardType = SD.cardType();
     if (cardType == CARD_NONE)
     {
-        Serial.println("❌ No SD card attached");
+        LOG_ERROR("❌ No SD card attached");
         return false;
     }
     
-    Serial.printf("✅ SD card initialized (Type: %s)\n", 
+    LOG_INFO("✅ SD card initialized (Type: %s)\n", 
                  cardType == CARD_MMC ? "MMC" : 
                  cardType == CARD_SD ? "SDSC" : 
                  cardType == CARD_SDHC ? "SDHC" : "Unknown");
@@ -159,7 +208,7 @@ static bool urlToFilename(const char* url, char* filename)
             }
             
             // Too many collisions, just use the base name and overwrite
-            Serial.println("⚠️ Too many hash collisions, using base filename");
+            LOG_WARN("⚠️ Too many hash collisions, using base filename");
         }
     }
     
@@ -221,7 +270,7 @@ static bool addToDownloadQueue(const char* url, const char* description)
 {
     if (downloadQueueCount >= MAX_DOWNLOAD_QUEUE)
     {
-        Serial.println("⚠️ Download queue is full, cannot add more items");
+        LOG_WARN("⚠️ Download queue is full, cannot add more items");
         return false;
     }
     
@@ -230,7 +279,7 @@ static bool addToDownloadQueue(const char* url, const char* description)
     {
         if (strcmp(downloadQueue[i].url, url) == 0)
         {
-            Serial.printf("ℹ️ URL already in download queue: %s\n", url);
+            LOG_INFO("ℹ️ URL already in download queue: %s\n", url);
             return true; // Already queued, consider it success
         }
     }
@@ -242,7 +291,7 @@ static bool addToDownloadQueue(const char* url, const char* description)
     
     if (!getLocalAudioPath(url, item->localPath))
     {
-        Serial.printf("❌ Failed to generate local path for: %s\n", url);
+        LOG_ERROR("❌ Failed to generate local path for: %s\n", url);
         return false;
     }
     
@@ -250,12 +299,28 @@ static bool addToDownloadQueue(const char* url, const char* description)
     item->description[sizeof(item->description) - 1] = '\0';
     
     item->inProgress = false;
+    
+    // Publish the entry only once it is complete
+    lockCatalog();
     downloadQueueCount++;
+    unlockCatalog();
     
-    Serial.printf("📥 Added to download queue: %s -> %s\n", item->description, item->localPath);
+    LOG_INFO("📥 Added to download queue: %s -> %s\n", item->description, item->localPath);
     return true;
 }
 
+/**
+ * @brief Mark the current queue item processed and report it on /events
+ * @param status HTTP status, or 0 if the request was never made or the file could not be written
+ */
+static void finishDownload(bool ok, int status)
+{
+    downloadQueue[downloadQueueIndex].inProgress = false;
+    publishEvent(STREAM_EVENT_DOWNLOAD, "{\"event\":\"%s\",\"index\":%d,\"status\":%d}",
+                 ok ? "done" : "failed", downloadQueueIndex, status);
+    downloadQueueIndex++;
+}
+
 /**
  * @brief Download next item in queue (non-blocking)
  * @return true if download started or completed, false if error or queue empty
@@ -269,13 +334,13 @@ static bool processDownloadQueue()
     
     if (WiFi.status() != WL_CONNECTED)
     {
-        Serial.println("⚠️ WiFi not connected, skipping download queue processing");
+        LOG_WARN("⚠️ WiFi not connected, skipping download queue processing");
         return false;
     }
     
     if (!initializeSDCard())
     {
-        Serial.println("⚠️ SD card not available, skipping download queue processing");
+        LOG_WARN("⚠️ SD card not available, skipping download queue processing");
         return false;
     }
     
@@ -286,20 +351,23 @@ static bool processDownloadQueue()
         return false; // Already processing this item
     }
     
-    Serial.printf("📥 Downloading audio file: %s\n", item->description);
-    Serial.printf("    URL: %s\n", item->url);
-    Serial.printf("    Local: %s\n", item->localPath);
+    LOG_INFO("📥 Downloading audio file: %s\n", item->description);
+    LOG_INFO("    URL: %s\n", item->url);
+    LOG_INFO("    Local: %s\n", item->localPath);
     
     item->inProgress = true;
+    char path[EVENT_STRING_LENGTH];
+    escapeEventString(path, item->localPath);
+    publishEvent(STREAM_EVENT_DOWNLOAD, "{\"event\":\"start\",\"index\":%d,\"path\":\"%s\"}",
+                 downloadQueueIndex, path);
     
     // Ensure audio directory exists
     if (!SD.exists(AUDIO_FILES_DIR))
     {
         if (!SD.mkdir(AUDIO_FILES_DIR))
         {
-            Serial.println("❌ Failed to create audio directory");
-            item->inProgress = false;
-            downloadQueueIndex++; // Skip this item
+            LOG_ERROR("❌ Failed to create audio directory");
+            finishDownload(false, 0); // Skip this item
             return false;
         }
     }
@@ -309,21 +377,23 @@ static bool processDownloadQueue()
     http.begin(item->url);
     http.addHeader("User-Agent", USER_AGENT_HEADER);
 
+    unsigned long requestStart = millis();
     int httpCode = http.GET();
+    downloadTtfb.record(millis() - requestStart);
     
     if (httpCode == 200)
     {
         // Get content length for progress tracking
         int contentLength = http.getSize();
+        int fileSize = contentLength;
         
         // Create file for writing
         File audioFile = SD.open(item->localPath, FILE_WRITE);
         if (!audioFile)
         {
-            Serial.printf("❌ Failed to create file: %s\n", item->localPath);
+            LOG_ERROR("❌ Failed to create file: %s\n", item->localPath);
             http.end();
-            item->inProgress = false;
-            downloadQueueIndex++;
+            finishDownload(false, 0);
             return false;
         }
         
@@ -331,6 +401,7 @@ static bool processDownloadQueue()
         WiFiClient* stream = http.getStreamPtr();
         uint8_t buffer[1024];
         int totalBytes = 0;
+        unsigned long lastProgressEvent = millis();
         
         while (http.connected() && (contentLength > 0 || contentLength == -1))
         {
@@ -349,6 +420,13 @@ static bool processDownloadQueue()
                     {
                         contentLength -= bytesRead;
                     }
+                    
+                    if (millis() - lastProgressEvent >= DOWNLOAD_PROGRESS_EVENT_MS)
+                    {
+                        publishEvent(STREAM_EVENT_DOWNLOAD, "{\"event\":\"progress\",\"index\":%d,\"bytes\":%d,\"size\":%d}",
+                                     downloadQueueIndex, totalBytes, fileSize);
+                        lastProgressEvent = millis();
+                    }
                 }
             }
             else
@@ -358,16 +436,19 @@ static bool processDownloadQueue()
         }
         
         audioFile.close();
-        Serial.printf("✅ Downloaded %d bytes to: %s\n", totalBytes, item->localPath);
+        unsigned long bodyMs = max(millis() - requestStart, 1UL);
+        downloadBytes.add(totalBytes);
+        downloadRate.set((int32_t)((uint64_t)totalBytes * 1000 / bodyMs));
+        LOG_INFO("✅ Downloaded %d bytes to: %s\n", totalBytes, item->localPath);
     }
     else
     {
-        Serial.printf("❌ HTTP download failed: %d for %s\n", httpCode, item->url);
+        downloadFailures.add();
+        LOG_ERROR("❌ HTTP download failed: %d for %s\n", httpCode, item->url);
     }
     
     http.end();
-    item->inProgress = false;
-    downloadQueueIndex++;
+    finishDownload(httpCode == 200, httpCode);
     
     return (httpCode == 200);
 }
@@ -385,7 +466,7 @@ static bool isCacheStale()
     
     if (!initializeSDCard())
     {
-        Serial.println("⚠️ Cannot check cache age without SD card");
+        LOG_WARN("⚠️ Cannot check cache age without SD card");
         return false; // Assume cache is valid if we can't check
     }
     
@@ -393,7 +474,7 @@ static bool isCacheStale()
     File timestampFile = SD.open(CACHE_TIMESTAMP_FILE, FILE_READ);
     if (!timestampFile)
     {
-        Serial.println("ℹ️ No cache timestamp file found");
+        LOG_INFO("ℹ️ No cache timestamp file found");
         return true; // No timestamp file means stale cache
     }
     
@@ -419,17 +500,149 @@ static bool isCacheStale()
     return (cacheAge > maxAge);
 }
 
+/**
+ * @brief Catalog entries parsed so far, swapped in once the whole catalog has parsed
+ */
+struct StagedCatalog
+{
+    AudioFile files[MAX_KNOWN_SEQUENCES];
+    int count;
+};
+
+static bool stageCatalogEntry(const char* key, const char* description, const char* type, const char* path,
+                              void* context)
+{
+    StagedCatalog* staged = (StagedCatalog*)context;
+    if (staged->count >= MAX_KNOWN_SEQUENCES)
+    {
+        LOG_WARN("⚠️ Maximum known sequences limit reached");
+        return false;
+    }
+
+    AudioFile& file = staged->files[staged->count++];
+    file.audioKey = strdup(key);
+    file.description = strdup(description);
+    file.type = strdup(type);
+    file.path = strdup(path);
+    LOG_DEBUG("📝 Added sequence: %s -> %s (%s)\n", key, description, type);
+    return true;
+}
+
+/**
+ * @brief Response body of a catalog download
+ */
+struct CatalogBody
+{
+    WiFiClient* stream;
+    int32_t remaining;      ///< -1 without a Content-Length
+};
+
+static int readCatalogBody(uint8_t* buffer, size_t length, void* context)
+{
+    CatalogBody* body = (CatalogBody*)context;
+    if (body->remaining == 0)
+    {
+        return 0;
+    }
+    if (body->remaining > 0 && length > (size_t)body->remaining)
+    {
+        length = body->remaining;
+    }
+
+    unsigned long waitStart = millis();
+    int available;
+    while ((available = body->stream->available()) <= 0)
+    {
+        if (!body->stream->connected())
+        {
+            return body->remaining > 0 ? -1 : 0;
+        }
+        if (millis() - waitStart > CATALOG_STREAM_TIMEOUT_MS)
+        {
+            return -1;
+        }
+        delay(1);
+    }
+
+    int n = body->stream->read(buffer, min((size_t)available, length));
+    if (n > 0)
+    {
+        downloadBytes.add(n);
+        if (body->remaining > 0)
+        {
+            body->remaining -= n;
+        }
+    }
+    return n;
+}
+
+static int readCatalogFile(uint8_t* buffer, size_t length, void* context)
+{
+    return ((File*)context)->read(buffer, length);
+}
+
+/**
+ * @brief Parse a catalog as it is read and replace the current one with it
+ * @param origin Where the catalog comes from, for the log
+ * @param wireBytes If not null, set to the bytes read from source
+ * @return Entries loaded, or -1 if the catalog could not be parsed (the current one is kept)
+ */
+static int loadCatalog(CatalogSource source, void* context, const char* origin, uint32_t* wireBytes)
+{
+    CatalogReader* reader = new (std::nothrow) CatalogReader();
+    StagedCatalog* staged = new (std::nothrow) StagedCatalog();
+    const char* failure = "out of memory";
+    if (reader && staged)
+    {
+        staged->count = 0;
+        failure = reader->begin(source, context, MAX_HTTP_RESPONSE_SIZE)
+                      ? parseCatalogStream(*reader, stageCatalogEntry, staged)
+                      : reader->error();
+    }
+
+    int count = -1;
+    if (failure)
+    {
+        LOG_ERROR("❌ Catalog from %s not loaded: %s\n", origin, failure);
+        if (staged)
+        {
+            freeAudioFiles(staged->files, staged->count);
+        }
+    }
+    else
+    {
+        lockCatalog();
+        freeAudioKeys();
+        memcpy(knownFiles, staged->files, staged->count * sizeof(AudioFile));
+        knownSequenceCount = staged->count;
+        unlockCatalog();
+
+        count = staged->count;
+        LOG_INFO("📦 Catalog from %s: %lu bytes (%s) -> %lu bytes JSON, %d entries\n", origin,
+                 (unsigned long)reader->wireBytes(), reader->isCompressed() ? "gzip" : "raw",
+                 (unsigned long)reader->textBytes(), count);
+    }
+
+    if (wireBytes)
+    {
+        *wireBytes = reader ? reader->wireBytes() : 0;
+    }
+    delete reader;
+    delete staged;
+    return count;
+}
+
 /**
  * @brief Save known sequences to SD card
  * @return true if successful, false otherwise
  */
 static bool saveKnownSequencesToSDCard()
 {
-    Serial.println("💾 Saving known sequences to SD card...");
+    LOG_INFO("💾 Saving known sequences to SD card...");
     
     if (!initializeSDCard())
     {
-        Serial.println("❌ SD card not available for writing");
+        LOG_ERROR("❌ SD card not available for writing");
         return false;
     }
     
@@ -449,7 +662,7 @@ static bool saveKnownSequencesToSDCard()
     File sequenceFile = SD.open(AUDIO_JSON_FILE, FILE_WRITE);
     if (!sequenceFile)
     {
-        Serial.println("❌ Failed to open sequences file for writing");
+        LOG_ERROR("❌ Failed to open sequences file for writing");
         return false;
     }
     
@@ -459,7 +672,7 @@ static bool saveKnownSequencesToSDCard()
     
     if (bytesWritten == 0)
     {
-        Serial.println("❌ Failed to write sequences to file");
+        LOG_ERROR("❌ Failed to write sequences to file");
         return false;
     }
     
@@ -473,10 +686,10 @@ static bool saveKnownSequencesToSDCard()
     }
     else
     {
-        Serial.println("⚠️ Failed to save cache timestamp");
+        LOG_WARN("⚠️ Failed to save cache timestamp");
     }
     
-    Serial.printf("✅ Saved %d known sequences to SD card (%d bytes)\n", 
+    LOG_INFO("✅ Saved %d known sequences to SD card (%d bytes)\n", 
                  knownSequenceCount, bytesWritten);
     
     return true;
@@ -488,18 +701,18 @@ static bool saveKnownSequencesToSDCard()
  */
 static bool loadKnownSequencesFromSDCard()
 {
-    Serial.println("📖 Loading known sequences from SD card...");
+    LOG_INFO("📖 Loading known sequences from SD card...");
     
     if (!initializeSDCard())
     {
-        Serial.println("❌ SD card not available for reading");
+        LOG_ERROR("❌ SD card not available for reading");
         return false;
     }
     
     // Check if sequences file exists
     if (!SD.exists(AUDIO_JSON_FILE))
     {
-        Serial.println("ℹ️ No cached sequences found on SD card");
+        LOG_INFO("ℹ️ No cached sequences found on SD card");
         return false;
     }
     
@@ -507,17 +720,16 @@ static bool loadKnownSequencesFromSDCard()
     File sequenceFile = SD.open(AUDIO_JSON_FILE, FILE_READ);
     if (!sequenceFile)
     {
-        Serial.println("❌ Failed to open sequences file for reading");
+        LOG_ERROR("❌ Failed to open sequences file for reading");
         return false;
     }
     
-    // Read file content
-    String jsonString = sequenceFile.readString();
+    // Parse straight from the file
+    int count = loadCatalog(readCatalogFile, &sequenceFile, "SD card", nullptr);
     sequenceFile.close();
     
-    if (jsonString.length() == 0)
+    if (count < 0)
     {
-        Serial.println("❌ Empty sequences file on SD card");
         return false;
     }
     
@@ -532,46 +744,45 @@ static bool loadKnownSequencesFromSDCard()
     else
     {
         lastCacheTime = 0;
-        Serial.println("⚠️ No cache timestamp found");
-    }
-    
-    // Parse JSON
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, jsonString);
-    
-    if (error)
-    {
-        Serial.printf("❌ JSON parse error: %s\n", error.c_str());
-        return false;
+        LOG_WARN("⚠️ No cache timestamp found");
     }
     
-    // Clear existing sequences
-    knownSequenceCount = 0;
+    LOG_INFO("✅ Loaded %d known sequences from SD card\n", knownSequenceCount);
+    return true;
+}
+
+/**
+ * @brief Load the SD card catalog cache and signal waitForAudioCatalog()
+ */
+static void loadCatalogAtBoot()
+{
+    int phase = beginBootPhase("catalog");
     
-    // Load sequences from JSON
-    JsonObject root = doc.as<JsonObject>();
-    for (JsonPair kv : root)
+    // Try to load from SD card first
+    if (loadKnownSequencesFromSDCard())
     {
-        if (knownSequenceCount >= MAX_KNOWN_SEQUENCES)
+        LOG_INFO("✅ Known sequences loaded from SD card cache");
+        
+        // Check if cache is stale
+        if (isCacheStale())
         {
-            Serial.println("⚠️ Maximum known sequences limit reached");
-            break;
+            LOG_INFO("⏰ Cache is stale, will refresh when WiFi is available");
         }
-        
-        const char* sequence = kv.key().c_str();
-        JsonObject seqData = kv.value().as<JsonObject>();
-        
-        // Allocate and copy strings
-        knownFiles[knownSequenceCount].audioKey = strdup(sequence);
-        knownFiles[knownSequenceCount].description = strdup(seqData["description"] | "Unknown");
-        knownFiles[knownSequenceCount].type = strdup(seqData["type"] | "unknown");
-        knownFiles[knownSequenceCount].path = strdup(seqData["path"] | "");
-        
-        knownSequenceCount++;
+        listAudioKeys();
+    }
+    else
+    {
+        LOG_INFO("ℹ️ No cached sequences found, will download when WiFi is available");
     }
     
-    Serial.printf("✅ Loaded %d known sequences from SD card\n", knownSequenceCount);
-    return true;
+    endBootPhase(phase);
+    xSemaphoreGive(catalogLoaded);
+}
+
+static void catalogLoadTask(void* parameter)
+{
+    loadCatalogAtBoot();
+    vTaskDelete(nullptr);
 }
 
 // ============================================================================
@@ -580,133 +791,114 @@ static bool loadKnownSequencesFromSDCard()
 
 void initializeAudioFileManager()
 {
-    Serial.println("🔧 Initializing Known Sequence Processor...");
+    LOG_INFO("🔧 Initializing Known Sequence Processor...");
     
     // Initialize variables
+    if (!catalogMutex)
+    {
+        catalogMutex = xSemaphoreCreateMutex();
+    }
+    if (!catalogLoaded)
+    {
+        catalogLoaded = xSemaphoreCreateBinary();
+    }
     knownSequenceCount = 0;
     lastCacheTime = 0;
     sdCardInitialized = false;
     
-    // Try to load from SD card first
-    if (loadKnownSequencesFromSDCard())
+    if (xTaskCreatePinnedToCore(catalogLoadTask, "catalogLoad", CATALOG_LOAD_TASK_STACK, nullptr,
+                                CATALOG_LOAD_TASK_PRIORITY, nullptr, CATALOG_LOAD_TASK_CORE) != pdPASS)
     {
-        Serial.println("✅ Known sequences loaded from SD card cache");
-        
-        // Check if cache is stale
-        if (isCacheStale())
-        {
-            Serial.println("⏰ Cache is stale, will refresh when WiFi is available");
-        }
-        listAudioKeys();
+        LOG_WARN("⚠️ Failed to start the catalog load task, loading inline");
+        loadCatalogAtBoot();
     }
-    else
+}
+
+bool waitForAudioCatalog(uint32_t timeoutMs)
+{
+    if (catalogLoaded && uxSemaphoreGetCount(catalogLoaded) > 0)
     {
-        Serial.println("ℹ️ No cached sequences found, will download when WiFi is available");
+        return true; // Already signalled; checked without taking it
+    }
+    if (!catalogLoaded || xSemaphoreTake(catalogLoaded, pdMS_TO_TICKS(timeoutMs)) != pdTRUE)
+    {
+        return false;
     }
+    xSemaphoreGive(catalogLoaded); // Stay signalled for later waits
+    return true;
 }
 
-bool downloadAudio()
+bool downloadAudio(bool force)
 {
-    Serial.println("🌐 Downloading known sequences from server...");
+    // The boot load would replace a newer catalog with the SD cache
+    if (!waitForAudioCatalog(0))
+    {
+        LOG_WARN("⚠️ Catalog still loading from SD card, not downloading");
+        return false;
+    }
+
+    LOG_INFO("🌐 Downloading known sequences from server...");
     
     // Check WiFi connection
     if (WiFi.status() != WL_CONNECTED)
     {
-        Serial.println("❌ WiFi not connected, cannot download sequences");
+        LOG_ERROR("❌ WiFi not connected, cannot download sequences");
         return false;
     }
     
     // Check if cache is still valid
-    if (!isCacheStale())
+    if (!force && !isCacheStale())
     {
-        Serial.println("✅ Cache is still valid, skipping download");
+        LOG_INFO("✅ Cache is still valid, skipping download");
         return true;
     }
     
     HTTPClient http;
+    // HTTP/1.0: an unchunked body read straight off the socket, and no
+    // "Accept-Encoding: identity" from HTTPClient, so the server may gzip it
+    http.useHTTP10(true);
+    http.setTimeout(CATALOG_STREAM_TIMEOUT_MS);
     http.begin(KNOWN_FILES_URL);
-    http.addHeader("Content-Type", "application/json");
+    http.addHeader("Accept-Encoding", "gzip");
     http.addHeader("User-Agent", USER_AGENT_HEADER);
 
-    Serial.printf("📡 Making GET request to: %s\n", KNOWN_FILES_URL);
+    LOG_INFO("📡 Making GET request to: %s\n", KNOWN_FILES_URL);
     
+    unsigned long requestStart = millis();
     int httpResponseCode = http.GET();
+    downloadTtfb.record(millis() - requestStart);
     
     if (httpResponseCode != 200)
     {
-        Serial.printf("❌ HTTP request failed: %d\n", httpResponseCode);
+        downloadFailures.add();
+        LOG_ERROR("❌ HTTP request failed: %d\n", httpResponseCode);
         http.end();
         return false;
     }
     
-    String payload = http.getString();
+    // Inflate and parse as the body arrives, one entry at a time
+    CatalogBody body = {http.getStreamPtr(), http.getSize()};
+    uint32_t wireBytes = 0;
+    int count = loadCatalog(readCatalogBody, &body, "server", &wireBytes);
     http.end();
+    catalogWireBytes.set((int32_t)wireBytes);
+    catalogLoadTime.set((int32_t)(millis() - requestStart));
     
-    Serial.printf("✅ Received response (%d bytes)\n", payload.length());
-    
-    if (payload.length() > MAX_HTTP_RESPONSE_SIZE)
+    if (count < 0)
     {
-        Serial.println("❌ Response too large");
         return false;
     }
     
-    // Parse JSON response
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, payload);
-    
-    if (error)
-    {
-        Serial.printf("❌ JSON parse error: %s\n", error.c_str());
-        return false;
-    }
-    
-    // Clear existing sequences (free memory first)
-    for (int i = 0; i < knownSequenceCount; i++)
-    {
-        free((void*)knownFiles[i].audioKey);
-        free((void*)knownFiles[i].description);
-        free((void*)knownFiles[i].type);
-        free((void*)knownFiles[i].path);
-    }
-    knownSequenceCount = 0;
-    
-    // Load new sequences
-    JsonObject root = doc.as<JsonObject>();
-    for (JsonPair kv : root)
-    {
-        if (knownSequenceCount >= MAX_KNOWN_SEQUENCES)
-        {
-            Serial.println("⚠️ Maximum known sequences limit reached");
-            break;
-        }
-        
-        const char* sequence = kv.key().c_str();
-        JsonObject seqData = kv.value().as<JsonObject>();
-        
-        // Allocate and copy strings
-        knownFiles[knownSequenceCount].audioKey = strdup(sequence);
-        knownFiles[knownSequenceCount].description = strdup(seqData["description"] | "Unknown");
-        knownFiles[knownSequenceCount].type = strdup(seqData["type"] | "unknown");
-        knownFiles[knownSequenceCount].path = strdup(seqData["path"] | "");
-        
-        Serial.printf("📝 Added sequence: %s -> %s (%s)\n", 
-                     knownFiles[knownSequenceCount].audioKey,
-                     knownFiles[knownSequenceCount].description,
-                     knownFiles[knownSequenceCount].type);
-        
-        knownSequenceCount++;
-    }
-    
-    Serial.printf("✅ Downloaded and parsed %d known sequences\n", knownSequenceCount);
+    LOG_INFO("✅ Downloaded and parsed %d known sequences\n", knownSequenceCount);
     
     // Save to SD card for caching
     if (saveKnownSequencesToSDCard())
     {
-        Serial.println("💾 Sequences cached to SD card");
+        LOG_INFO("💾 Sequences cached to SD card");
     }
     else
     {
-        Serial.println("⚠️ Failed to cache sequences to SD card");
+        LOG_WARN("⚠️ Failed to cache sequences to SD card");
     }
     
     return true;
@@ -734,13 +926,14 @@ const char* processAudioKey(const char *sequence)
 {
     if (!sequence)
     {
-        Serial.println("❌ Invalid sequence pointer");
+        LOG_ERROR("❌ Invalid sequence pointer");
         return nullptr;
     }
     
-    Serial.printf("🔍 Processing known sequence: %s\n", sequence);
+    LOG_DEBUG("🔍 Processing known sequence: %s\n", sequence);
     
     // Find the sequence
+    int64_t lookupStart = esp_timer_get_time();
     AudioFile *found = nullptr;
     for (int i = 0; i < knownSequenceCount; i++)
     {
@@ -750,34 +943,37 @@ const char* processAudioKey(const char *sequence)
             break;
         }
     }
+    catalogLookupTime.record((uint32_t)(esp_timer_get_time() - lookupStart));
+    catalogLookups.add();
     
     if (!found)
     {
-        Serial.printf("❌ Sequence not found in known sequences: %s\n", sequence);
+        catalogMisses.add();
+        LOG_ERROR("❌ Sequence not found in known sequences: %s\n", sequence);
         return nullptr;
     }
     
     // Process based on type
-    Serial.printf("📋 Sequence Info:\n");
-    Serial.printf("   Sequence: %s\n", found->audioKey);
-    Serial.printf("   Description: %s\n", found->description);
-    Serial.printf("   Type: %s\n", found->type);
-    Serial.printf("   Path: %s\n", found->path);
+    LOG_DEBUG("📋 Sequence Info:\n");
+    LOG_DEBUG("   Sequence: %s\n", found->audioKey);
+    LOG_DEBUG("   Description: %s\n", found->description);
+    LOG_DEBUG("   Type: %s\n", found->type);
+    LOG_DEBUG("   Path: %s\n", found->path);
     
     // Handle different sequence types
     if (!found->type)
     {
-        Serial.println("❌ Sequence type is NULL");
+        LOG_ERROR("❌ Sequence type is NULL");
         return nullptr;
     }
     
     if (strcmp(found->type, "audio") == 0)
     {
-        Serial.printf("🔊 Processing audio sequence: %s\n", found->description);
+        LOG_DEBUG("🔊 Processing audio sequence: %s\n", found->description);
         
         if (!found->path || strlen(found->path) == 0)
         {
-            Serial.println("❌ No audio path specified");
+            LOG_ERROR("❌ No audio path specified");
             return nullptr;
         }
         
@@ -791,87 +987,86 @@ const char* processAudioKey(const char *sequence)
                 static char localPath[128];
                 if (getLocalAudioPath(found->path, localPath))
                 {
-                    Serial.printf("🎵 Audio file found locally: %s\n", localPath);
+                    LOG_DEBUG("🎵 Audio file found locally: %s\n", localPath);
                     return localPath;
                 }
                 else
                 {
-                    Serial.println("❌ Failed to generate local path");
+                    LOG_ERROR("❌ Failed to generate local path");
                     return nullptr;
                 }
             }
             else
             {
                 // File doesn't exist - add to download queue
-                Serial.printf("📥 Audio file not cached, adding to download queue\n");
+                LOG_INFO("📥 Audio file not cached, adding to download queue\n");
                 if (addToDownloadQueue(found->path, found->description))
                 {
-                    Serial.printf("✅ Added to download queue: %s\n", found->description);
+                    LOG_INFO("✅ Added to download queue: %s\n", found->description);
                 }
                 else
                 {
-                    Serial.printf("❌ Failed to add to download queue: %s\n", found->description);
+                    LOG_ERROR("❌ Failed to add to download queue: %s\n", found->description);
                 }
                 
                 // For now, we could stream it or skip playback
-                Serial.printf("ℹ️ Audio will be available for local playback after download\n");
+                LOG_INFO("ℹ️ Audio will be available for local playback after download\n");
                 return nullptr;
             }
         }
         else
         {
             // It's a local path - return for direct playback
-            Serial.printf("🎵 Local audio path found: %s\n", found->path);
+            LOG_DEBUG("🎵 Local audio path found: %s\n", found->path);
             return found->path;
         }
     }
     else if (strcmp(found->type, "service") == 0)
     {
-        Serial.printf("🔧 Accessing service: %s\n", found->description);
+        LOG_INFO("🔧 Accessing service: %s\n", found->description);
         // TODO: Implement service access logic
         return nullptr;
     }
     else if (strcmp(found->type, "shortcut") == 0)
     {
-        Serial.printf("⚡ Executing shortcut: %s\n", found->description);
+        LOG_INFO("⚡ Executing shortcut: %s\n", found->description);
         // TODO: Implement shortcut execution logic
         return nullptr;
     }
     else if (strcmp(found->type, "url") == 0)
     {
-        Serial.printf("🌐 Opening URL: %s\n", found->path ? found->path : "NULL");
+        LOG_INFO("🌐 Opening URL: %s\n", found->path ? found->path : "NULL");
         // TODO: Implement URL opening logic
         return nullptr;
     }
     else
     {
-        Serial.printf("❓ Unknown sequence type: %s\n", found->type);
+        LOG_WARN("❓ Unknown sequence type: %s\n", found->type);
         return nullptr;
     }
 }
 
 void listAudioKeys()
 {
-    Serial.printf("📋 Known Sequences (%d total):\n", knownSequenceCount);
-    Serial.println("============================================================");
+    LOG_INFO("📋 Known Sequences (%d total):\n", knownSequenceCount);
+    LOG_INFO("============================================================");
     
     if (knownSequenceCount == 0)
     {
-        Serial.println("   No known sequences loaded.");
-        Serial.println("   Try downloading with downloadKnownSequences()");
+        LOG_INFO("   No known sequences loaded.");
+        LOG_INFO("   Try downloading with downloadKnownSequences()");
         return;
     }
     
     for (int i = 0; i < knownSequenceCount; i++)
     {
-        Serial.printf("%2d. %s\n", i + 1, knownFiles[i].audioKey);
-        Serial.printf("    Description: %s\n", knownFiles[i].description);
-        Serial.printf("    Type: %s\n", knownFiles[i].type);
+        LOG_INFO("%2d. %s\n", i + 1, knownFiles[i].audioKey);
+        LOG_INFO("    Description: %s\n", knownFiles[i].description);
+        LOG_INFO("    Type: %s\n", knownFiles[i].type);
         if (strlen(knownFiles[i].path) > 0)
         {
-            Serial.printf("    Path: %s\n", knownFiles[i].path);
+            LOG_INFO("    Path: %s\n", knownFiles[i].path);
         }
-        Serial.println();
     }
 }
 
@@ -880,21 +1075,31 @@ int getAudioKeyCount()
     return knownSequenceCount;
 }
 
-void clearAudioKeys()
+bool visitAudioKey(int index, AudioKeyVisitor visitor, void* context)
 {
-    Serial.println("🗑️ Clearing known sequences...");
-    
-    // Free allocated memory
-    for (int i = 0; i < knownSequenceCount; i++)
+    if (!lockCatalog(pdMS_TO_TICKS(CATALOG_READ_TIMEOUT_MS)))
     {
-        free((void*)knownFiles[i].audioKey);
-        free((void*)knownFiles[i].description);
-        free((void*)knownFiles[i].type);
-        free((void*)knownFiles[i].path);
+        return false;
+    }
+    bool found = index >= 0 && index < knownSequenceCount;
+    if (found)
+    {
+        visitor(knownFiles[index], context);
     }
+    unlockCatalog();
+    return found;
+}
+
+void clearAudioKeys()
+{
+    LOG_INFO("🗑️ Clearing known sequences...");
     
     int clearedCount = knownSequenceCount;
-    knownSequenceCount = 0;
+    
+    // Free allocated memory
+    lockCatalog();
+    freeAudioKeys();
+    unlockCatalog();
     lastCacheTime = 0;
     
     // Clear SD card cache files
@@ -923,19 +1128,19 @@ void clearAudioKeys()
         
         if (sequencesRemoved && timestampRemoved)
         {
-            Serial.println("✅ Cleared SD card cache files");
+            LOG_INFO("✅ Cleared SD card cache files");
         }
         else
         {
-            Serial.println("⚠️ Some SD card files could not be removed");
+            LOG_WARN("⚠️ Some SD card files could not be removed");
         }
     }
     else
     {
-        Serial.println("⚠️ SD card not available for cache cleanup");
+        LOG_WARN("⚠️ SD card not available for cache cleanup");
     }
     
-    Serial.printf("✅ Cleared %d known sequences from memory\n", clearedCount);
+    LOG_INFO("✅ Cleared %d known sequences from memory\n", clearedCount);
 }
 
 // ============================================================================
@@ -968,13 +1173,13 @@ int getTotalDownloadQueueSize()
 
 void listDownloadQueue()
 {
-    Serial.printf("📥 Audio Download Queue (%d items, %d processed):\n", 
+    LOG_INFO("📥 Audio Download Queue (%d items, %d processed):\n", 
                  downloadQueueCount, downloadQueueIndex);
-    Serial.println("========================================================");
+    LOG_INFO("========================================================");
     
     if (downloadQueueCount == 0)
     {
-        Serial.println("   No items in download queue.");
+        LOG_INFO("   No items in download queue.");
         return;
     }
     
@@ -984,19 +1189,38 @@ void listDownloadQueue()
         const char* status = i < downloadQueueIndex ? "✅ Downloaded" : 
                            item->inProgress ? "🔄 In Progress" : "⏳ Pending";
         
-        Serial.printf("%2d. %s %s\n", i + 1, status, item->description);
-        Serial.printf("    URL: %s\n", item->url);
-        Serial.printf("    Local: %s\n", item->localPath);
-        Serial.println();
+        LOG_INFO("%2d. %s %s\n", i + 1, status, item->description);
+        LOG_INFO("    URL: %s\n", item->url);
+        LOG_INFO("    Local: %s\n", item->localPath);
     }
 }
 
 void clearDownloadQueue()
 {
-    Serial.println("🗑️ Clearing download queue...");
+    LOG_INFO("🗑️ Clearing download queue...");
+    lockCatalog();
     downloadQueueCount = 0;
     downloadQueueIndex = 0;
-    Serial.println("✅ Download queue cleared");
+    unlockCatalog();
+    LOG_INFO("✅ Download queue cleared");
+}
+
+bool visitDownloadItem(int index, DownloadItemVisitor visitor, void* context)
+{
+    if (!lockCatalog(pdMS_TO_TICKS(CATALOG_READ_TIMEOUT_MS)))
+    {
+        return false;
+    }
+    bool found = index >= 0 && index < downloadQueueCount;
+    if (found)
+    {
+        const AudioDownloadItem& item = downloadQueue[index];
+        AudioDownloadState state = index < downloadQueueIndex ? AUDIO_DOWNLOAD_DONE :
+                                   item.inProgress ? AUDIO_DOWNLOAD_IN_PROGRESS : AUDIO_DOWNLOAD_PENDING;
+        visitor(item, state, context);
+    }
+    unlockCatalog();
+    return found;
 }
 
 bool isDownloadQueueEmpty()
@@ -1,108 +1,596 @@
 /**
  * @file audio_file_player.cpp
- * 
+ *
  * This file implements audio playback functionality using the AudioTools library.
  * It consumes the audio_file_manager for file management.
- * 
+ *
+ * Playback runs in two tasks pinned to AUDIO_TASK_CORE: a mix task that
+ * decodes and mixes voices into a PSRAM ring buffer, and a higher priority
+ * output task that drains the ring into I2S. loop() only sends commands.
+ *
  * @date 2025
  */
 
+#define LOG_MODULE LOG_MODULE_AUDIO
 #include "audio_file_player.h"
+#include "logging.h"
 #include "audio_file_manager.h"
+#include "audio_mixer.h"
+#include "audio_ring_buffer.h"
 #include "AudioTools.h"
-#include <Preferences.h>
+#include "settings_store.h"
+#include "metrics.h"
+#include "event_stream.h"
+#include <atomic>
+#include <esp_timer.h>
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+enum AudioCommandType
+{
+    AUDIO_CMD_PLAY,
+    AUDIO_CMD_STOP,
+    AUDIO_CMD_VOLUME
+};
+
+/**
+ * @brief Command sent from loop() to the mix task
+ */
+struct AudioCommand
+{
+    AudioCommandType type;
+    AudioMixPolicy policy;
+    uint8_t priority;
+    float volume;
+    float gain;
+    int64_t enqueueUs;      ///< When the originating key request was queued (0 if none)
+    char path[128];
+};
+
+/**
+ * @brief Deferred play-by-key request, resolved in processAudioFile()
+ */
+struct AudioKeyRequest
+{
+    char key[AUDIO_KEY_MAX_LENGTH];
+    bool queued;            ///< queueAudioByKey() rather than playAudioByKey()
+    AudioMixPolicy policy;
+    uint8_t priority;
+    float gain;
+    int64_t enqueueUs;
+};
 
 // ============================================================================
 // GLOBAL VARIABLES
 // ============================================================================
 
 // Audio playback components
-static AudioPlayer* audioPlayer = nullptr;
-static bool isPlayingAudio = false;
+static bool playerInitialized = false;
+static AudioStream* audioOutput = nullptr;
+static AudioRingBuffer pcmRing;
+static volatile bool isPlayingAudio = false;
 static unsigned long audioStartTime = 0;
 static float currentVolume = DEFAULT_AUDIO_VOLUME;
-static Preferences volumePrefs;
+static AudioMixPolicy defaultMixPolicy = DEFAULT_AUDIO_MIX_POLICY;
+
+// Pipeline tasks and shared state
+static TaskHandle_t mixTaskHandle = nullptr;
+static TaskHandle_t outputTaskHandle = nullptr;
+static QueueHandle_t audioCommandQueue = nullptr;
+static QueueHandle_t audioKeyQueue = nullptr;
+static std::atomic<int> pendingCommands(0);
+static std::atomic<bool> mixerActive(false);
+static std::atomic<bool> audioInfoChanged(false);
+static std::atomic<uint32_t> pendingSampleRate(AUDIO_MIXER_SAMPLE_RATE);
+
+// Clips held back by the QUEUE policy, highest priority first (owned by the mix task)
+static AudioCommand clipQueue[AUDIO_CLIP_QUEUE_LENGTH];
+static uint32_t clipQueueOrder[AUDIO_CLIP_QUEUE_LENGTH];
+static uint32_t clipQueueCounter = 0;
+static std::atomic<int> clipQueueCount(0);
+static std::atomic<uint32_t> clipsDroppedCount(0);
+
+// Pipeline counters
+static std::atomic<uint32_t> underrunCount(0);
+static std::atomic<uint32_t> blocksWrittenCount(0);
+static std::atomic<uint32_t> ringLowWater(UINT32_MAX);
+static std::atomic<uint32_t> keyRequestsDropped(0);
+
+// Latency measurement: the mix task marks the ring byte position where a
+// requested clip starts; the output task reports when reading passes it
+static uint32_t bytesMixed = 0;                 // Mix task only
+static uint32_t bytesOutput = 0;                // Output task only
+static std::atomic<bool> soundMarkPending(false);
+static uint32_t soundMarkBytes = 0;
+static int64_t soundMarkEnqueueUs = 0;
+static std::atomic<uint32_t> lastInputToEnqueueUs(0);
+static std::atomic<uint32_t> maxInputToEnqueueUs(0);
+static std::atomic<uint32_t> lastEnqueueToSoundUs(0);
+static std::atomic<uint32_t> maxEnqueueToSoundUs(0);
+
+// Exported at /metrics; unlike the counters above these are never reset
+static MetricHistogram mixBlockTime("audio_mix_block_duration_us", "Time to decode and mix one block");
+static MetricCounter underrunMetric("audio_underruns_total", "Output blocks that found the ring short while mixing");
+static MetricHistogram inputToEnqueueTime("audio_input_to_enqueue_us", "Input edge to play request queued");
+static MetricHistogram enqueueToSoundTime("audio_enqueue_to_sound_us", "Play request queued to its first sample output");
 
 // ============================================================================
 // HELPER FUNCTIONS
 // ============================================================================
 
 /**
- * @brief Load volume from EEPROM/Preferences
+ * @brief Load volume from the settings store
  * @return Volume value from storage, or default if not found
  */
 static float loadVolumeFromStorage()
 {
-    if (!volumePrefs.begin("audio", true)) // Read-only
-    {
-        Serial.println("⚠️ Failed to open volume preferences for reading");
-        return DEFAULT_AUDIO_VOLUME;
-    }
-    
-    float volume = volumePrefs.getFloat("volume", DEFAULT_AUDIO_VOLUME);
-    volumePrefs.end();
-    
+    float volume = getSettingFloat("audio", "volume", DEFAULT_AUDIO_VOLUME);
+
     // Validate range
     if (volume < 0.0f || volume > 1.0f)
     {
-        Serial.printf("⚠️ Invalid volume in storage: %.2f, using default\n", volume);
+        LOG_WARN("⚠️ Invalid volume in storage: %.2f, using default\n", volume);
         return DEFAULT_AUDIO_VOLUME;
     }
-    
-    Serial.printf("📖 Loaded volume from storage: %.2f\n", volume);
+
+    LOG_INFO("📖 Loaded volume from storage: %.2f\n", volume);
     return volume;
 }
 
 /**
- * @brief Save volume to EEPROM/Preferences
+ * @brief Save volume to the settings store
  * @param volume Volume value to save
+ *
+ * Only updates RAM; the store batches the NVS write once the value settles.
  */
 static void saveVolumeToStorage(float volume)
 {
-    if (!volumePrefs.begin("audio", false)) // Read-write
+    putSettingFloat("audio", "volume", volume);
+}
+
+/**
+ * @brief Queue a command for the mix task
+ * @return true if the command was queued
+ */
+static bool sendAudioCommand(const AudioCommand& cmd)
+{
+    if (!audioCommandQueue)
     {
-        Serial.println("❌ Failed to open volume preferences for writing");
-        return;
+        return false;
+    }
+
+    pendingCommands++;
+    if (xQueueSend(audioCommandQueue, &cmd, 0) != pdTRUE)
+    {
+        pendingCommands--;
+        LOG_WARN("⚠️ Audio command queue full, command dropped");
+        return false;
+    }
+
+    xTaskNotifyGive(mixTaskHandle);
+    return true;
+}
+
+/**
+ * @brief Record a latency sample as last/max
+ */
+static void recordLatency(std::atomic<uint32_t>& last, std::atomic<uint32_t>& max,
+                          MetricHistogram& histogram, int64_t us)
+{
+    uint32_t value = us < 0 ? 0 : (us > UINT32_MAX ? UINT32_MAX : (uint32_t)us);
+    histogram.record(value);
+    last.store(value);
+    if (value > max.load())
+    {
+        max.store(value);
     }
-    
-    volumePrefs.putFloat("volume", volume);
-    volumePrefs.end();
-    
-    Serial.printf("💾 Saved volume to storage: %.2f\n", volume);
+}
+
+/**
+ * @brief Build and queue a play command
+ */
+static bool sendPlayCommand(const char* filePath, AudioMixPolicy policy, uint8_t priority, float gain,
+                            int64_t enqueueUs = 0)
+{
+    if (!playerInitialized || !filePath)
+    {
+        return false;
+    }
+
+    AudioCommand cmd = {};
+    cmd.type = AUDIO_CMD_PLAY;
+    cmd.policy = policy;
+    cmd.priority = priority;
+    cmd.gain = gain;
+    cmd.enqueueUs = enqueueUs;
+    strncpy(cmd.path, filePath, sizeof(cmd.path) - 1);
+
+    LOG_INFO("🎵 Starting audio playback: %s\n", filePath);
+    if (!sendAudioCommand(cmd))
+    {
+        return false;
+    }
+    // Only once queued: a dropped command must not leave callers waiting for a clip that never plays
+    isPlayingAudio = true;
+    audioStartTime = millis();
+    LOG_DEBUG("🎵 Audio playback started");
+    char path[EVENT_STRING_LENGTH];
+    escapeEventString(path, cmd.path);
+    publishEvent(STREAM_EVENT_PLAYBACK, "{\"event\":\"play\",\"path\":\"%s\"}", path);
+
+    return true;
+}
+
+/**
+ * @brief Add a clip to the priority queue (mix task only)
+ * @return true if queued; a full queue evicts its newest lowest-priority
+ *         clip only for a higher-priority one
+ */
+static bool pushClip(const AudioCommand& cmd)
+{
+    int slot = clipQueueCount.load();
+    if (slot >= AUDIO_CLIP_QUEUE_LENGTH)
+    {
+        int victim = 0;
+        for (int i = 1; i < AUDIO_CLIP_QUEUE_LENGTH; i++)
+        {
+            if (clipQueue[i].priority < clipQueue[victim].priority ||
+                (clipQueue[i].priority == clipQueue[victim].priority && clipQueueOrder[i] > clipQueueOrder[victim]))
+            {
+                victim = i;
+            }
+        }
+
+        clipsDroppedCount++;
+        if (clipQueue[victim].priority >= cmd.priority)
+        {
+            LOG_WARN("⚠️ Clip queue full, dropping: %s\n", cmd.path);
+            return false;
+        }
+        LOG_WARN("⚠️ Clip queue full, evicting: %s\n", clipQueue[victim].path);
+        slot = victim;
+    }
+    else
+    {
+        clipQueueCount++;
+    }
+
+    clipQueue[slot] = cmd;
+    clipQueueOrder[slot] = clipQueueCounter++;
+    return true;
+}
+
+/**
+ * @brief Take the highest-priority (then oldest) clip from the queue (mix task only)
+ */
+static bool popClip(AudioCommand& out)
+{
+    int count = clipQueueCount.load();
+    if (count == 0)
+    {
+        return false;
+    }
+
+    int best = 0;
+    for (int i = 1; i < count; i++)
+    {
+        if (clipQueue[i].priority > clipQueue[best].priority ||
+            (clipQueue[i].priority == clipQueue[best].priority && clipQueueOrder[i] < clipQueueOrder[best]))
+        {
+            best = i;
+        }
+    }
+
+    out = clipQueue[best];
+    clipQueue[best] = clipQueue[count - 1];
+    clipQueueOrder[best] = clipQueueOrder[count - 1];
+    clipQueueCount--;
+    return true;
+}
+
+static int32_t clipGainQ15(const AudioCommand& cmd)
+{
+    return (int32_t)(constrain(cmd.gain, 0.0f, 1.0f) * AUDIO_GAIN_UNITY_Q15);
+}
+
+/**
+ * @brief Mixer chain callback: hands the next queued clip to the running voice
+ */
+static bool nextChainedClip(char* path, size_t pathLen, int32_t* gainQ15)
+{
+    AudioCommand next;
+    if (!popClip(next))
+    {
+        return false;
+    }
+
+    strlcpy(path, next.path, pathLen);
+    *gainQ15 = clipGainQ15(next);
+    return true;
+}
+
+/**
+ * @brief Start a clip on a mixer voice (mix task only)
+ */
+static void startClip(const AudioCommand& cmd)
+{
+    bool chainable = cmd.policy != AUDIO_MIX_OVERLAY;
+    if (audioMixerStartVoice(cmd.path, clipGainQ15(cmd), chainable) >= 0)
+    {
+        mixerActive.store(true);
+
+        // The clip's first samples land in the next rendered block
+        if (cmd.enqueueUs != 0 && !soundMarkPending.load())
+        {
+            soundMarkBytes = bytesMixed;
+            soundMarkEnqueueUs = cmd.enqueueUs;
+            soundMarkPending.store(true);
+        }
+    }
+}
+
+/**
+ * @brief Apply the clip's mix policy (mix task only)
+ */
+static void handlePlayCommand(const AudioCommand& cmd)
+{
+    switch (cmd.policy)
+    {
+    case AUDIO_MIX_PREEMPT:
+        audioMixerFadeOutAll();
+        startClip(cmd);
+        break;
+
+    case AUDIO_MIX_QUEUE:
+        // Queued clips chain onto the running voice at end of file, or start when idle
+        if (!audioMixerIsActive() && clipQueueCount.load() == 0)
+        {
+            startClip(cmd);
+        }
+        else if (pushClip(cmd))
+        {
+            mixerActive.store(true);
+        }
+        break;
+
+    case AUDIO_MIX_OVERLAY:
+        startClip(cmd);
+        break;
+    }
+}
+
+/**
+ * @brief Mix task: handles commands and keeps the PCM ring topped up
+ */
+static void audioMixTask(void* param)
+{
+    static int16_t mixBlock[AUDIO_MIX_BLOCK_FRAMES * 2];
+    AudioCommand cmd;
+
+    for (;;)
+    {
+        // Block until a command arrives when idle, otherwise just poll
+        bool busy = audioMixerIsActive() || clipQueueCount.load() > 0;
+        if (!busy)
+        {
+            mixerActive.store(false);
+            xTaskNotifyGive(outputTaskHandle);
+        }
+        if (xQueueReceive(audioCommandQueue, &cmd, busy ? 0 : portMAX_DELAY) == pdTRUE)
+        {
+            switch (cmd.type)
+            {
+            case AUDIO_CMD_PLAY:
+                handlePlayCommand(cmd);
+                break;
+
+            case AUDIO_CMD_STOP:
+                clipQueueCount.store(0);
+                audioMixerFadeOutAll();
+                break;
+
+            case AUDIO_CMD_VOLUME:
+                audioMixerSetMasterGain((int32_t)(cmd.volume * AUDIO_GAIN_UNITY_Q15));
+                break;
+            }
+            pendingCommands--;
+            xTaskNotifyGive(outputTaskHandle);
+            continue;
+        }
+
+        // Nothing left to chain onto (e.g. the queued clip came after an overlay): start it
+        AudioCommand next;
+        if (!audioMixerIsActive() && popClip(next))
+        {
+            startClip(next);
+        }
+
+        if (!audioMixerIsActive())
+        {
+            continue;
+        }
+
+        // Only stay AUDIO_RING_TARGET_BYTES ahead so preemption is heard quickly
+        if (pcmRing.available() >= AUDIO_RING_TARGET_BYTES ||
+            pcmRing.availableForWrite() < sizeof(mixBlock))
+        {
+            ulTaskNotifyTake(pdTRUE, 1);
+            continue;
+        }
+
+        int64_t renderStart = esp_timer_get_time();
+        size_t frames = audioMixerRender(mixBlock, AUDIO_MIX_BLOCK_FRAMES);
+        mixBlockTime.record((uint32_t)(esp_timer_get_time() - renderStart));
+        if (audioMixerTakeRateChange())
+        {
+            pendingSampleRate.store(audioMixerSampleRate());
+            audioInfoChanged.store(true);
+        }
+        if (frames > 0)
+        {
+            bytesMixed += pcmRing.write((const uint8_t*)mixBlock, frames * 2 * sizeof(int16_t));
+            xTaskNotifyGive(outputTaskHandle);
+        }
+    }
+}
+
+/**
+ * @brief Output task: drains the PCM ring into the I2S output
+ */
+static void audioOutputTask(void* param)
+{
+    static uint8_t block[AUDIO_OUTPUT_BLOCK_SIZE];
+    bool started = false;
+
+    for (;;)
+    {
+        if (audioInfoChanged.exchange(false))
+        {
+            audioOutput->setAudioInfo(AudioInfo(pendingSampleRate.load(), 2, 16));
+        }
+
+        size_t filled = pcmRing.available();
+        bool mixing = mixerActive.load();
+
+        if (!started)
+        {
+            // Prefill before starting so a slow SD read does not underrun immediately
+            if (filled >= AUDIO_PREFILL_BYTES || (!mixing && filled > 0))
+            {
+                started = true;
+            }
+            else
+            {
+                if (!mixing && filled == 0 && pendingCommands.load() == 0 && isPlayingAudio)
+                {
+                    isPlayingAudio = false;
+                    publishEvent(STREAM_EVENT_PLAYBACK, "{\"event\":\"idle\"}");
+                }
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+                continue;
+            }
+        }
+
+        if (filled < AUDIO_OUTPUT_BLOCK_SIZE && mixing)
+        {
+            // Mixer fell behind: count it and rebuffer
+            underrunCount++;
+            underrunMetric.add();
+            started = false;
+            continue;
+        }
+
+        if (filled == 0)
+        {
+            started = false;
+            continue;
+        }
+
+        size_t n = pcmRing.read(block, min(filled, sizeof(block)));
+        audioOutput->write(block, n);
+        blocksWrittenCount++;
+        bytesOutput += n;
+
+        // Wrap-safe: has output passed the start of the requested clip?
+        if (soundMarkPending.load() && (int32_t)(bytesOutput - soundMarkBytes) > 0)
+        {
+            recordLatency(lastEnqueueToSoundUs, maxEnqueueToSoundUs, enqueueToSoundTime,
+                          esp_timer_get_time() - soundMarkEnqueueUs);
+            soundMarkPending.store(false);
+        }
+
+        uint32_t remaining = pcmRing.available();
+        if (mixing && remaining < ringLowWater.load())
+        {
+            ringLowWater.store(remaining);
+        }
+    }
+}
+
+/**
+ * @brief Record a play-by-key request for processAudioFile()
+ * @return Enqueue time in microseconds, or 0 if the request was not queued
+ */
+static int64_t enqueueKeyRequest(const char* key, bool queued, AudioMixPolicy policy,
+                                 uint8_t priority, float gain)
+{
+    if (!playerInitialized || !key)
+    {
+        return 0;
+    }
+
+    AudioKeyRequest request = {};
+    strlcpy(request.key, key, sizeof(request.key));
+    request.queued = queued;
+    request.policy = policy;
+    request.priority = priority;
+    request.gain = gain;
+    request.enqueueUs = esp_timer_get_time();
+
+    // Counted as pending so the output task does not report idle before it is resolved
+    pendingCommands++;
+    if (xQueueSend(audioKeyQueue, &request, 0) != pdTRUE)
+    {
+        pendingCommands--;
+        keyRequestsDropped++;
+        return 0;
+    }
+    isPlayingAudio = true;
+    return request.enqueueUs;
 }
 
 // ============================================================================
 // PUBLIC FUNCTIONS
 // ============================================================================
 
-void initAudioFilePlayer(AudioSource &source, AudioStream &output, AudioDecoder &decoder)
+void initAudioFilePlayer(AudioSource &source, AudioStream &output)
 {
     // Check if already initialized
-    if (audioPlayer != nullptr)
+    if (playerInitialized)
     {
-        Serial.println("⚠️ Audio player already initialized, skipping...");
+        LOG_WARN("⚠️ Audio player already initialized, skipping...");
         return;
     }
-    
-    Serial.println("🔧 Initializing audio player...");
-    
-    // Create audio player with provided source and decoder
-    audioPlayer = new AudioPlayer(source, output, decoder);
 
-    // Initialize audio file manager
-    initializeAudioFileManager();
-    
-    // Load volume from storage
-    currentVolume = loadVolumeFromStorage();
-    
-    // Set the volume on the player
-    if (audioPlayer)
+    LOG_INFO("🔧 Initializing audio player...");
+
+    if (!pcmRing.begin(AUDIO_RING_BUFFER_SIZE))
+    {
+        LOG_ERROR("❌ Failed to allocate audio ring buffer");
+        return;
+    }
+    LOG_INFO("✅ Audio ring buffer: %u bytes in %s\n",
+                 (unsigned)pcmRing.capacity(), pcmRing.isInPsram() ? "PSRAM" : "internal RAM");
+
+    // Mount the filesystem voices read from, and allocate the voices
+    source.begin();
+    if (!initAudioMixer())
     {
-        audioPlayer->setVolume(currentVolume);
-        Serial.printf("🔊 Initial volume set to %.2f\n", currentVolume);
+        LOG_ERROR("❌ Failed to initialize audio mixer");
+        return;
     }
-    audioPlayer->begin();
-    Serial.println("✅ Audio player initialized");
+
+    audioMixerSetChainCallback(nextChainedClip);
+
+    audioOutput = &output;
+    audioOutput->setAudioInfo(AudioInfo(AUDIO_MIXER_SAMPLE_RATE, 2, 16));
+
+    // Load volume from storage
+    currentVolume = loadVolumeFromStorage();
+    audioMixerSetMasterGain((int32_t)(currentVolume * AUDIO_GAIN_UNITY_Q15));
+    LOG_INFO("🔊 Initial volume set to %.2f\n", currentVolume);
+
+    audioCommandQueue = xQueueCreate(AUDIO_COMMAND_QUEUE_LENGTH, sizeof(AudioCommand));
+    audioKeyQueue = xQueueCreate(AUDIO_KEY_QUEUE_LENGTH, sizeof(AudioKeyRequest));
+    xTaskCreatePinnedToCore(audioOutputTask, "audioOut", AUDIO_OUTPUT_TASK_STACK, nullptr,
+                            AUDIO_OUTPUT_TASK_PRIORITY, &outputTaskHandle, AUDIO_TASK_CORE);
+    xTaskCreatePinnedToCore(audioMixTask, "audioMix", AUDIO_MIX_TASK_STACK, nullptr,
+                            AUDIO_MIX_TASK_PRIORITY, &mixTaskHandle, AUDIO_TASK_CORE);
+
+    playerInitialized = true;
+    LOG_INFO("✅ Audio player initialized");
 }
 
 void setVolume(float volume)
@@ -110,15 +598,18 @@ void setVolume(float volume)
     // Clamp volume to valid range
     if (volume < 0.0f) volume = 0.0f;
     if (volume > 1.0f) volume = 1.0f;
-    
+
     currentVolume = volume;
-    
-    if (audioPlayer)
+
+    if (playerInitialized)
     {
-        audioPlayer->setVolume(volume);
-        Serial.printf("🔊 Volume set to %.2f\n", volume);
+        AudioCommand cmd = {};
+        cmd.type = AUDIO_CMD_VOLUME;
+        cmd.volume = volume;
+        sendAudioCommand(cmd);
+        LOG_DEBUG("🔊 Volume set to %.2f\n", volume);
     }
-    
+
     // Save to storage for persistence
     saveVolumeToStorage(volume);
 }
@@ -127,41 +618,44 @@ float getVolume()
 {
     return currentVolume;
 }
+
 bool startAudioPlayback(const char* filePath)
 {
-    if (!audioPlayer || !filePath || isPlayingAudio)
-    {
-        return false;
-    }
-    
-    Serial.printf("🎵 Starting audio playback: %s\n", filePath);
-    audioPlayer->playPath(filePath);
-    isPlayingAudio = true;
-    audioStartTime = millis();
-    Serial.println("🎵 Audio playback started");
-    
-    return true;
+    return startAudioPlayback(filePath, defaultMixPolicy);
+}
+
+bool startAudioPlayback(const char* filePath, AudioMixPolicy policy, float gain)
+{
+    return sendPlayCommand(filePath, policy, AUDIO_PRIORITY_NORMAL, gain);
+}
+
+bool queueAudioPlayback(const char* filePath, uint8_t priority, float gain)
+{
+    return sendPlayCommand(filePath, AUDIO_MIX_QUEUE, priority, gain);
+}
+
+void setAudioMixPolicy(AudioMixPolicy policy)
+{
+    defaultMixPolicy = policy;
+}
+
+AudioMixPolicy getAudioMixPolicy()
+{
+    return defaultMixPolicy;
 }
 
 void stopAudioPlayback()
 {
-    if (!audioPlayer)
-    {
-        return;
-    }
-    
-    if (audioPlayer->isActive())
-    {
-        audioPlayer->end();
-    }
-    
-    if (!isPlayingAudio)
+    if (!playerInitialized || !isPlayingAudio)
     {
         return;
     }
-    
-    isPlayingAudio = false;
-    Serial.println("🔇 Audio playback stopped");
+
+    AudioCommand cmd = {};
+    cmd.type = AUDIO_CMD_STOP;
+    sendAudioCommand(cmd);
+    LOG_INFO("🔇 Audio playback stopped");
+    publishEvent(STREAM_EVENT_PLAYBACK, "{\"event\":\"stop\"}");
 }
 
 bool isAudioPlaying()
@@ -171,40 +665,89 @@ bool isAudioPlaying()
 
 bool processAudioFile()
 {
-    if (!audioPlayer || !isPlayingAudio)
+    if (!playerInitialized)
     {
         return false;
     }
-    
-    audioPlayer->copy();
-    
-    // Check if playback finished
-    if (!audioPlayer->isActive())
+
+    // Resolve deferred key requests here, away from the code that asked for
+    // them; while the boot-time catalog load runs they wait in the queue
+    AudioKeyRequest request;
+    while (waitForAudioCatalog(0) && xQueueReceive(audioKeyQueue, &request, 0) == pdTRUE)
     {
-        stopAudioPlayback();
-        return false;
+        const char* filePath = nullptr;
+        if (!hasAudioKey(request.key))
+        {
+            LOG_ERROR("❌ Audio key not found: %s\n", request.key);
+        }
+        else if (!(filePath = processAudioKey(request.key)))
+        {
+            LOG_WARN("⚠️ Audio file not available for key: %s\n", request.key);
+        }
+        else
+        {
+            AudioMixPolicy policy = request.queued ? AUDIO_MIX_QUEUE : request.policy;
+            sendPlayCommand(filePath, policy, request.priority, request.gain, request.enqueueUs);
+        }
+
+        // The play command (if any) is now pending in its own right
+        pendingCommands--;
     }
-    
-    return true;
+
+    return isPlayingAudio;
+}
+
+AudioPipelineStats getAudioPipelineStats()
+{
+    AudioPipelineStats stats;
+    uint32_t lowWater = ringLowWater.load();
+
+    stats.underruns = underrunCount.load();
+    stats.blocksWritten = blocksWrittenCount.load();
+    stats.ringFillBytes = pcmRing.available();
+    stats.ringLowWaterBytes = lowWater == UINT32_MAX ? 0 : lowWater;
+    stats.ringCapacityBytes = pcmRing.capacity();
+    stats.ringInPsram = pcmRing.isInPsram();
+    stats.queuedClips = clipQueueCount.load();
+    stats.clipsDropped = clipsDroppedCount.load();
+    stats.keyRequestsDropped = keyRequestsDropped.load();
+    stats.lastInputToEnqueueUs = lastInputToEnqueueUs.load();
+    stats.maxInputToEnqueueUs = maxInputToEnqueueUs.load();
+    stats.lastEnqueueToSoundUs = lastEnqueueToSoundUs.load();
+    stats.maxEnqueueToSoundUs = maxEnqueueToSoundUs.load();
+    return stats;
+}
+
+void resetAudioPipelineStats()
+{
+    underrunCount.store(0);
+    ringLowWater.store(UINT32_MAX);
+    maxInputToEnqueueUs.store(0);
+    maxEnqueueToSoundUs.store(0);
 }
 
 bool playAudioByKey(const char* key)
 {
-    if (!key || !hasAudioKey(key))
-    {
-        Serial.printf("❌ Audio key not found: %s\n", key ? key : "NULL");
-        return false;
-    }
-    
-    // Process the audio key to get the file path
-    const char* filePath = processAudioKey(key);
-    
-    if (!filePath)
+    return playAudioByKey(key, defaultMixPolicy);
+}
+
+bool playAudioByKey(const char* key, AudioMixPolicy policy, float gain)
+{
+    return enqueueKeyRequest(key, false, policy, AUDIO_PRIORITY_NORMAL, gain) != 0;
+}
+
+bool triggerAudioByKey(const char* key, int64_t inputUs)
+{
+    int64_t enqueueUs = enqueueKeyRequest(key, false, defaultMixPolicy, AUDIO_PRIORITY_NORMAL, 1.0f);
+    if (enqueueUs == 0)
     {
-        Serial.printf("⚠️ Audio file not available for key: %s\n", key);
         return false;
     }
-    
-    // Start playback
-    return startAudioPlayback(filePath);
+    recordLatency(lastInputToEnqueueUs, maxInputToEnqueueUs, inputToEnqueueTime, enqueueUs - inputUs);
+    return true;
+}
+
+bool queueAudioByKey(const char* key, uint8_t priority, float gain)
+{
+    return enqueueKeyRequest(key, true, AUDIO_MIX_QUEUE, priority, gain) != 0;
 }
@@ -0,0 +1,572 @@
+/**
+ * @file audio_mixer.cpp
+ *
+ * This file implements the multi-voice Q15 mixer used by the audio task.
+ * Voices decode ahead into their own PCM buffers; audioMixerRender() tops
+ * them up, then sums one block of every active voice with per-frame gain
+ * ramps and saturates the result to 16 bit.
+ *
+ * A chainable voice that reaches end of file opens the next clip from the
+ * chain callback and keeps feeding the same decoder. The gap at each such
+ * boundary is measured as the trailing silence of the old clip, plus any
+ * frames the voice could not supply, plus the leading silence of the new one.
+ *
+ * @date 2025
+ */
+
+#define LOG_MODULE LOG_MODULE_MIXER
+#include "audio_mixer.h"
+#include "logging.h"
+#include "audio_ring_buffer.h"
+#include "dsp_kernels.h"
+#include "AudioTools.h"
+#include "AudioTools/AudioCodecs/CodecMP3Helix.h"
+#include <esp_timer.h>
+
+// Bounds on the stereo PCM a decoder write can produce. The densest Layer III
+// stream (MPEG-2, 8 kbit/s at 24 kHz) packs 576 samples into 24-byte frames,
+// i.e. 96 PCM bytes per encoded byte; on top of that the decoder may complete
+// one frame (up to 1152 samples) from input it buffered on the previous write.
+#define VOICE_PCM_PER_ENCODED_BYTE (576 * 4 / 24)
+#define VOICE_MAX_FRAME_PCM (1152 * 4)
+#define VOICE_MIN_FEED 32   // Smallest encoded write worth making
+
+#if AUDIO_VOICE_PCM_BUFFER < VOICE_MAX_FRAME_PCM + VOICE_MIN_FEED * VOICE_PCM_PER_ENCODED_BYTE
+#error "AUDIO_VOICE_PCM_BUFFER is too small to hold a worst-case decoder write"
+#endif
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+enum VoiceState
+{
+    VOICE_IDLE,
+    VOICE_PLAYING,
+    VOICE_FADING_OUT
+};
+
+struct MixerVoice;
+
+/**
+ * @brief Decoder output for a voice: expands mono to stereo into the voice PCM buffer
+ */
+class VoicePcmSink : public AudioStream
+{
+public:
+    MixerVoice* voice = nullptr;
+
+    size_t write(const uint8_t* data, size_t len) override;
+    void setAudioInfo(AudioInfo newInfo) override;
+};
+
+/**
+ * @brief State for one mixer voice
+ */
+struct MixerVoice
+{
+    VoiceState state = VOICE_IDLE;
+    File file;
+    MP3DecoderHelix decoder;
+    VoicePcmSink sink;
+    AudioRingBuffer pcm;
+    uint8_t channels = 2;
+    bool fileDone = true;
+    int32_t gain = 0;        ///< Current gain (Q15)
+    int32_t targetGain = 0;  ///< Gain the ramp is heading to (Q15)
+    int32_t gainStep = 1;    ///< Per-frame ramp step (Q15)
+    uint32_t startOrder = 0; ///< Monotonic start counter, used to pick voices to steal
+    bool chainable = false;  ///< Continue with clips from the chain callback at end of file
+
+    // Clip boundary gap measurement (positions are byte offsets in the voice PCM stream)
+    uint64_t pcmWritten = 0; ///< Total PCM bytes produced by the decoder
+    uint64_t pcmRead = 0;    ///< Total PCM bytes consumed by the mixer
+    uint32_t silentRun = 0;  ///< Consecutive silent frames at the write position
+    bool gapPending = false; ///< A clip boundary has not been measured yet
+    bool gapLeadFound = false;
+    uint64_t gapStart = 0;   ///< Where the old clip's trailing silence begins
+    uint64_t gapEnd = 0;     ///< Where the new clip's first audible frame is
+    uint32_t gapStarved = 0; ///< Frames the voice could not supply inside the gap
+};
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static MixerVoice* voices = nullptr;
+static uint32_t startCounter = 0;
+static int32_t masterGain = AUDIO_GAIN_UNITY_Q15;
+static uint32_t mixSampleRate = AUDIO_MIXER_SAMPLE_RATE;
+static bool rateChanged = false;
+static AudioMixerStats mixerStats = {};
+static AudioChainCallback chainCallback = nullptr;
+static uint32_t ditherState = 0x2545F491;
+
+// Scratch buffers for one block
+static int32_t mixAccumulator[AUDIO_MIX_BLOCK_FRAMES * 2];
+static int16_t voiceBlock[AUDIO_MIX_BLOCK_FRAMES * 2];
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Per-frame ramp step that moves a gain of `span` to its target in AUDIO_FADE_MS
+ */
+static int32_t fadeStep(int32_t span)
+{
+    int32_t fadeFrames = (int32_t)(mixSampleRate * AUDIO_FADE_MS / 1000);
+    if (fadeFrames < 1)
+    {
+        fadeFrames = 1;
+    }
+    int32_t step = span / fadeFrames;
+    return step > 0 ? step : 1;
+}
+
+static int countPlayingVoices()
+{
+    int count = 0;
+    for (int i = 0; i < AUDIO_MIXER_VOICES; i++)
+    {
+        if (voices[i].state == VOICE_PLAYING)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Append stereo PCM to a voice and track silence for gap measurement
+ */
+static void appendVoicePcm(MixerVoice& v, const int16_t* stereo, size_t frames)
+{
+    for (size_t f = 0; f < frames; f++)
+    {
+        int16_t l = stereo[2 * f];
+        int16_t r = stereo[2 * f + 1];
+        if (abs(l) <= AUDIO_GAP_SILENCE_THRESHOLD && abs(r) <= AUDIO_GAP_SILENCE_THRESHOLD)
+        {
+            v.silentRun++;
+            continue;
+        }
+        if (v.gapPending && !v.gapLeadFound)
+        {
+            v.gapEnd = v.pcmWritten + f * 4;
+            v.gapLeadFound = true;
+        }
+        v.silentRun = 0;
+    }
+
+    size_t bytes = frames * 4;
+    size_t written = v.pcm.write((const uint8_t*)stereo, bytes);
+    v.pcmWritten += written;
+    if (written < bytes)
+    {
+        // pumpVoice() sizes each feed so this cannot happen; count it if it does
+        mixerStats.pcmBytesDropped += bytes - written;
+    }
+}
+
+size_t VoicePcmSink::write(const uint8_t* data, size_t len)
+{
+    if (voice->channels == 2)
+    {
+        appendVoicePcm(*voice, (const int16_t*)data, len / 4);
+        return len;
+    }
+
+    // Mono: duplicate each sample into both channels
+    int16_t stereo[128];
+    const int16_t* samples = (const int16_t*)data;
+    size_t count = len / sizeof(int16_t);
+    for (size_t i = 0; i < count; i += 64)
+    {
+        size_t n = min(count - i, (size_t)64);
+        for (size_t j = 0; j < n; j++)
+        {
+            stereo[2 * j] = samples[i + j];
+            stereo[2 * j + 1] = samples[i + j];
+        }
+        appendVoicePcm(*voice, stereo, n);
+    }
+    return len;
+}
+
+void VoicePcmSink::setAudioInfo(AudioInfo newInfo)
+{
+    AudioStream::setAudioInfo(newInfo);
+    voice->channels = newInfo.channels == 1 ? 1 : 2;
+
+    // A clip that starts while nothing else is playing sets the mix rate
+    if (newInfo.sample_rate != mixSampleRate && countPlayingVoices() <= 1)
+    {
+        mixSampleRate = newInfo.sample_rate;
+        rateChanged = true;
+    }
+    else if (newInfo.sample_rate != mixSampleRate)
+    {
+        LOG_WARN("⚠️ Voice sample rate %d differs from mix rate %u\n",
+                     newInfo.sample_rate, (unsigned)mixSampleRate);
+    }
+}
+
+/**
+ * @brief Stop a voice immediately and release its file and decoder
+ */
+static void releaseVoice(MixerVoice& v)
+{
+    if (!v.fileDone)
+    {
+        v.decoder.end();
+        v.file.close();
+        v.fileDone = true;
+    }
+    v.pcm.reset();
+    v.state = VOICE_IDLE;
+    v.gain = 0;
+    v.chainable = false;
+    v.gapPending = false;
+}
+
+/**
+ * @brief Switch a chainable voice at end of file to the next clip, keeping the decoder open
+ * @return true if the voice continues with a new clip
+ */
+static bool chainNextClip(MixerVoice& v)
+{
+    char path[128];
+    int32_t gain = v.targetGain;
+
+    while (v.chainable && chainCallback && chainCallback(path, sizeof(path), &gain))
+    {
+        File next = AUDIO_MIXER_FS.open(path);
+        if (!next)
+        {
+            LOG_ERROR("❌ Failed to open chained audio file: %s\n", path);
+            continue;
+        }
+
+        v.file.close();
+        v.file = next;
+        if (gain != v.targetGain)
+        {
+            v.gainStep = fadeStep(abs(gain - v.gain));
+            v.targetGain = gain;
+        }
+
+        v.gapPending = true;
+        v.gapLeadFound = false;
+        v.gapStart = v.pcmWritten - (uint64_t)v.silentRun * 4;
+        v.gapStarved = 0;
+        mixerStats.clipsChained++;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Feed encoded data to a voice's decoder until it has wantBytes of PCM
+ *
+ * Each read is limited to what the voice buffer can take at the worst-case
+ * decode ratio, so the decoder output always fits and no frame is cut short.
+ */
+static void pumpVoice(MixerVoice& v, size_t wantBytes)
+{
+    static uint8_t chunk[AUDIO_VOICE_READ_CHUNK];
+    int budget = 8; // Bound the work done per block
+
+    while (!v.fileDone && v.pcm.available() < wantBytes && budget-- > 0)
+    {
+        size_t space = v.pcm.availableForWrite();
+        if (space < VOICE_MAX_FRAME_PCM + VOICE_MIN_FEED * VOICE_PCM_PER_ENCODED_BYTE)
+        {
+            break;
+        }
+        size_t feed = (space - VOICE_MAX_FRAME_PCM) / VOICE_PCM_PER_ENCODED_BYTE;
+        if (feed > sizeof(chunk))
+        {
+            feed = sizeof(chunk);
+        }
+
+        int n = v.file.read(chunk, feed);
+        if (n <= 0 && chainNextClip(v))
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            v.decoder.end();
+            v.file.close();
+            v.fileDone = true;
+            break;
+        }
+        v.decoder.write(chunk, n);
+    }
+}
+
+/**
+ * @brief Add one voice's block onto the mix bus with its gain ramp applied
+ */
+static void mixVoice(MixerVoice& v, const int16_t* in, size_t frames)
+{
+    if (v.gain == v.targetGain)
+    {
+        dspMixAccumulateQ15(mixAccumulator, in, frames * 2, v.gain, AUDIO_MIX_FRAC_BITS);
+        return;
+    }
+
+    int32_t step = v.gain < v.targetGain ? v.gainStep : -v.gainStep;
+    v.gain = dspMixAccumulateRampQ15(mixAccumulator, in, frames, 2, v.gain, step,
+                                     v.targetGain, AUDIO_MIX_FRAC_BITS);
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+bool initAudioMixer()
+{
+    if (voices)
+    {
+        return true;
+    }
+
+    voices = new MixerVoice[AUDIO_MIXER_VOICES];
+    for (int i = 0; i < AUDIO_MIXER_VOICES; i++)
+    {
+        if (!voices[i].pcm.begin(AUDIO_VOICE_PCM_BUFFER))
+        {
+            LOG_ERROR("❌ Failed to allocate PCM buffer for voice %d\n", i);
+            return false;
+        }
+        voices[i].sink.voice = &voices[i];
+        voices[i].decoder.setOutput(voices[i].sink);
+    }
+
+    LOG_INFO("✅ Audio mixer ready: %d voices\n", AUDIO_MIXER_VOICES);
+    return true;
+}
+
+int audioMixerStartVoice(const char* path, int32_t gainQ15, bool chainable)
+{
+    if (!voices || !path)
+    {
+        return -1;
+    }
+
+    // Pick a free voice; otherwise steal the oldest, preferring ones already fading out
+    int slot = -1;
+    for (int i = 0; i < AUDIO_MIXER_VOICES && slot < 0; i++)
+    {
+        if (voices[i].state == VOICE_IDLE)
+        {
+            slot = i;
+        }
+    }
+    if (slot < 0)
+    {
+        for (int i = 0; i < AUDIO_MIXER_VOICES; i++)
+        {
+            bool fading = voices[i].state == VOICE_FADING_OUT;
+            bool slotFading = slot >= 0 && voices[slot].state == VOICE_FADING_OUT;
+            if (slot < 0 || (fading && !slotFading) ||
+                (fading == slotFading && voices[i].startOrder < voices[slot].startOrder))
+            {
+                slot = i;
+            }
+        }
+        releaseVoice(voices[slot]);
+        mixerStats.voicesStolen++;
+    }
+
+    MixerVoice& v = voices[slot];
+    v.file = AUDIO_MIXER_FS.open(path);
+    if (!v.file)
+    {
+        LOG_ERROR("❌ Failed to open audio file: %s\n", path);
+        return -1;
+    }
+
+    if (chainable)
+    {
+        for (int i = 0; i < AUDIO_MIXER_VOICES; i++)
+        {
+            voices[i].chainable = false;
+        }
+    }
+
+    v.pcm.reset();
+    v.pcmWritten = 0;
+    v.pcmRead = 0;
+    v.silentRun = 0;
+    v.gapPending = false;
+    v.chainable = chainable;
+    v.fileDone = false;
+    v.channels = 2;
+    v.decoder.begin();
+    v.gain = 0;
+    v.targetGain = gainQ15;
+    v.gainStep = fadeStep(gainQ15);
+    v.state = VOICE_PLAYING;
+    v.startOrder = ++startCounter;
+    mixerStats.voicesStarted++;
+
+    // Prime the decoder so the first mixed block is not starved
+    pumpVoice(v, AUDIO_MIX_BLOCK_FRAMES * 4 * 2);
+    return slot;
+}
+
+void audioMixerFadeOutAll()
+{
+    if (!voices)
+    {
+        return;
+    }
+
+    for (int i = 0; i < AUDIO_MIXER_VOICES; i++)
+    {
+        MixerVoice& v = voices[i];
+        v.chainable = false;
+        if (v.state == VOICE_PLAYING)
+        {
+            v.state = VOICE_FADING_OUT;
+            v.targetGain = 0;
+            v.gainStep = fadeStep(v.gain);
+        }
+    }
+}
+
+void audioMixerSetChainCallback(AudioChainCallback callback)
+{
+    chainCallback = callback;
+}
+
+void audioMixerSetMasterGain(int32_t gainQ15)
+{
+    masterGain = constrain(gainQ15, 0, AUDIO_GAIN_UNITY_Q15);
+}
+
+size_t audioMixerRender(int16_t* out, size_t frames)
+{
+    if (!voices)
+    {
+        return 0;
+    }
+
+    if (frames > AUDIO_MIX_BLOCK_FRAMES)
+    {
+        frames = AUDIO_MIX_BLOCK_FRAMES;
+    }
+
+    int64_t start = esp_timer_get_time();
+    size_t blockBytes = frames * 2 * sizeof(int16_t);
+    int active = 0;
+
+    memset(mixAccumulator, 0, frames * 2 * sizeof(int32_t));
+
+    for (int i = 0; i < AUDIO_MIXER_VOICES; i++)
+    {
+        MixerVoice& v = voices[i];
+        if (v.state == VOICE_IDLE)
+        {
+            continue;
+        }
+
+        pumpVoice(v, blockBytes);
+        size_t got = v.pcm.read((uint8_t*)voiceBlock, blockBytes) / (2 * sizeof(int16_t));
+        mixVoice(v, voiceBlock, got);
+        active++;
+
+        if (v.gapPending)
+        {
+            if (got < frames && v.pcmRead + got * 4 >= v.gapStart)
+            {
+                v.gapStarved += frames - got;
+            }
+            if (v.gapLeadFound && v.pcmRead + got * 4 >= v.gapEnd)
+            {
+                uint32_t gap = (uint32_t)((v.gapEnd - v.gapStart) / 4) + v.gapStarved;
+                mixerStats.gapsMeasured++;
+                mixerStats.lastGapFrames = gap;
+                if (gap > mixerStats.maxGapFrames)
+                {
+                    mixerStats.maxGapFrames = gap;
+                }
+                v.gapPending = false;
+            }
+        }
+        v.pcmRead += got * 4;
+
+        bool fadedOut = v.state == VOICE_FADING_OUT && v.gain == 0;
+        bool drained = v.fileDone && v.pcm.available() == 0;
+        if (fadedOut || drained)
+        {
+            releaseVoice(v);
+        }
+    }
+
+    if (active == 0)
+    {
+        mixerStats.activeVoices = 0;
+        return 0;
+    }
+
+    // Master volume on the bus, then back to 16 bit
+    if (masterGain < AUDIO_GAIN_UNITY_Q15)
+    {
+        dspGainQ31(mixAccumulator, frames * 2, masterGain << 16);
+    }
+#if AUDIO_MIX_DITHER
+    dspDitherTpdfTo16(out, mixAccumulator, frames * 2, AUDIO_MIX_FRAC_BITS, &ditherState);
+#else
+    dspReduceTo16(out, mixAccumulator, frames * 2, AUDIO_MIX_FRAC_BITS);
+#endif
+
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+    mixerStats.activeVoices = active;
+    mixerStats.blocksMixed++;
+    mixerStats.voiceBlocksMixed += active;
+    mixerStats.lastMixMicros = elapsed;
+    mixerStats.totalMixMicros += elapsed;
+    if (elapsed > mixerStats.maxMixMicros)
+    {
+        mixerStats.maxMixMicros = elapsed;
+    }
+    return frames;
+}
+
+bool audioMixerIsActive()
+{
+    if (!voices)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < AUDIO_MIXER_VOICES; i++)
+    {
+        if (voices[i].state != VOICE_IDLE)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t audioMixerSampleRate()
+{
+    return mixSampleRate;
+}
+
+bool audioMixerTakeRateChange()
+{
+    bool changed = rateChanged;
+    rateChanged = false;
+    return changed;
+}
+
+AudioMixerStats getAudioMixerStats()
+{
+    return mixerStats;
+}
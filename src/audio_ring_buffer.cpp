@@ -0,0 +1,130 @@
+/**
+ * @file audio_ring_buffer.cpp
+ *
+ * This file implements the lock-free SPSC byte ring buffer used by the
+ * audio pipeline.
+ *
+ * @date 2025
+ */
+
+#include "audio_ring_buffer.h"
+#include <esp_heap_caps.h>
+
+AudioRingBuffer::AudioRingBuffer()
+    : buffer(nullptr), size(0), mask(0), psram(false), head(0), tail(0)
+{
+}
+
+AudioRingBuffer::~AudioRingBuffer()
+{
+    end();
+}
+
+bool AudioRingBuffer::begin(size_t capacity, bool preferPsram)
+{
+    end();
+
+    size_t rounded = 1;
+    while (rounded < capacity)
+    {
+        rounded <<= 1;
+    }
+
+    if (preferPsram && psramFound())
+    {
+        buffer = (uint8_t*)heap_caps_malloc(rounded, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        psram = (buffer != nullptr);
+    }
+
+    if (!buffer)
+    {
+        buffer = (uint8_t*)heap_caps_malloc(rounded, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        psram = false;
+    }
+
+    if (!buffer)
+    {
+        return false;
+    }
+
+    size = rounded;
+    mask = rounded - 1;
+    head.store(0);
+    tail.store(0);
+    return true;
+}
+
+void AudioRingBuffer::end()
+{
+    if (buffer)
+    {
+        heap_caps_free(buffer);
+        buffer = nullptr;
+    }
+    size = 0;
+    mask = 0;
+    psram = false;
+}
+
+size_t AudioRingBuffer::write(const uint8_t* data, size_t len)
+{
+    if (!buffer || !data)
+    {
+        return 0;
+    }
+
+    size_t h = head.load(std::memory_order_relaxed);
+    size_t t = tail.load(std::memory_order_acquire);
+    size_t space = size - (h - t);
+    if (len > space)
+    {
+        len = space;
+    }
+
+    size_t offset = h & mask;
+    size_t first = min(len, size - offset);
+    memcpy(buffer + offset, data, first);
+    memcpy(buffer, data + first, len - first);
+
+    head.store(h + len, std::memory_order_release);
+    return len;
+}
+
+size_t AudioRingBuffer::read(uint8_t* data, size_t len)
+{
+    if (!buffer || !data)
+    {
+        return 0;
+    }
+
+    size_t t = tail.load(std::memory_order_relaxed);
+    size_t h = head.load(std::memory_order_acquire);
+    size_t filled = h - t;
+    if (len > filled)
+    {
+        len = filled;
+    }
+
+    size_t offset = t & mask;
+    size_t first = min(len, size - offset);
+    memcpy(data, buffer + offset, first);
+    memcpy(data + first, buffer, len - first);
+
+    tail.store(t + len, std::memory_order_release);
+    return len;
+}
+
+void AudioRingBuffer::reset()
+{
+    tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+size_t AudioRingBuffer::available() const
+{
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+}
+
+size_t AudioRingBuffer::availableForWrite() const
+{
+    return size - available();
+}
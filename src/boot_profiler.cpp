@@ -0,0 +1,150 @@
+/**
+ * @file boot_profiler.cpp
+ *
+ * This file implements the boot phase table and its serial and text reports.
+ *
+ * @date 2025
+ */
+
+#define LOG_MODULE LOG_MODULE_MAIN
+#include "boot_profiler.h"
+#include "logging.h"
+#include "metrics.h"
+#include <esp_timer.h>
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+struct BootPhase
+{
+    const char* name;
+    int64_t startUs;
+    int64_t endUs;      ///< 0 while the phase is running
+};
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static BootPhase phases[BOOT_MAX_PHASES];
+static int phaseCount = 0;
+static int64_t readyUs = 0;
+static portMUX_TYPE phaseMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Exported at /metrics
+static MetricGauge bootReadyTime("boot_ready_ms", "Reset to ready for the first round",
+                                 []() { return (int32_t)(getBootReadyUs() / 1000); });
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+// Copy the table so formatting never happens inside the critical section
+static int snapshotPhases(BootPhase* copy, int64_t& ready)
+{
+    portENTER_CRITICAL(&phaseMux);
+    int count = phaseCount;
+    memcpy(copy, phases, count * sizeof(BootPhase));
+    ready = readyUs;
+    portEXIT_CRITICAL(&phaseMux);
+    return count;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+int beginBootPhase(const char* name)
+{
+    int64_t now = esp_timer_get_time();
+    int phase = -1;
+
+    portENTER_CRITICAL(&phaseMux);
+    if (phaseCount < BOOT_MAX_PHASES)
+    {
+        phase = phaseCount++;
+        phases[phase].name = name;
+        phases[phase].startUs = now;
+        phases[phase].endUs = 0;
+    }
+    portEXIT_CRITICAL(&phaseMux);
+    return phase;
+}
+
+void endBootPhase(int phase)
+{
+    if (phase < 0 || phase >= BOOT_MAX_PHASES)
+    {
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&phaseMux);
+    phases[phase].endUs = now;
+    portEXIT_CRITICAL(&phaseMux);
+}
+
+void markBootReady()
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&phaseMux);
+    readyUs = now;
+    portEXIT_CRITICAL(&phaseMux);
+
+    BootPhase copy[BOOT_MAX_PHASES];
+    int64_t ready;
+    int count = snapshotPhases(copy, ready);
+
+    LOG_INFO("⏱️ Ready for the first round %.1f ms after reset\n", ready / 1000.0f);
+    for (int i = 0; i < count; i++)
+    {
+        if (copy[i].endUs)
+        {
+            LOG_INFO("⏱️   %-12s %8.1f ms + %8.1f ms\n", copy[i].name, copy[i].startUs / 1000.0f,
+                     (copy[i].endUs - copy[i].startUs) / 1000.0f);
+        }
+        else
+        {
+            LOG_INFO("⏱️   %-12s %8.1f ms   (running)\n", copy[i].name, copy[i].startUs / 1000.0f);
+        }
+    }
+}
+
+int64_t getBootReadyUs()
+{
+    portENTER_CRITICAL(&phaseMux);
+    int64_t ready = readyUs;
+    portEXIT_CRITICAL(&phaseMux);
+    return ready;
+}
+
+void writeBootProfile(Print& out)
+{
+    BootPhase copy[BOOT_MAX_PHASES];
+    int64_t ready;
+    int count = snapshotPhases(copy, ready);
+
+    out.printf("%-12s %10s %10s\n", "phase", "start_ms", "ms");
+    for (int i = 0; i < count; i++)
+    {
+        if (copy[i].endUs)
+        {
+            out.printf("%-12s %10.1f %10.1f\n", copy[i].name, copy[i].startUs / 1000.0f,
+                       (copy[i].endUs - copy[i].startUs) / 1000.0f);
+        }
+        else
+        {
+            out.printf("%-12s %10.1f %10s\n", copy[i].name, copy[i].startUs / 1000.0f, "running");
+        }
+    }
+
+    if (ready)
+    {
+        out.printf("%-12s %10.1f\n", "ready", ready / 1000.0f);
+    }
+    else
+    {
+        out.printf("%-12s %10s\n", "ready", "pending");
+    }
+}
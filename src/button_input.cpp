@@ -0,0 +1,241 @@
+/**
+ * @file button_input.cpp
+ *
+ * This file implements the ISR edge capture, leading-edge debounce and the
+ * SPSC event ring.
+ *
+ * @date 2025
+ */
+
+#define LOG_MODULE LOG_MODULE_INPUT
+#include "button_input.h"
+#include "logging.h"
+#include <atomic>
+#include <esp_timer.h>
+#include <hal/gpio_ll.h>
+
+static_assert((BUTTON_EVENT_RING_SIZE & (BUTTON_EVENT_RING_SIZE - 1)) == 0,
+              "BUTTON_EVENT_RING_SIZE must be a power of two");
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * @brief Debounce state of one pin (written by the ISR)
+ */
+struct ButtonPinState
+{
+    uint8_t pin;
+    volatile uint8_t stableLevel;       ///< Level of the last accepted edge
+    volatile uint8_t rawLevel;          ///< Level after the last raw edge
+    volatile int64_t acceptedUs;        ///< Time of the last accepted edge
+    volatile int64_t lastEdgeUs;        ///< Time of the last raw edge (accepted or not)
+};
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static ButtonPinState pinStates[MAX_BUTTON_PINS];
+static size_t pinCount = 0;
+
+static ButtonEvent eventRing[BUTTON_EVENT_RING_SIZE];
+static std::atomic<uint32_t> ringHead(0);  // Written by the producer (ISR)
+static std::atomic<uint32_t> ringTail(0);  // Written by the consumer (loop)
+
+static volatile ButtonInputStats stats = {};
+static portMUX_TYPE buttonMux = portMUX_INITIALIZER_UNLOCKED;
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static void IRAM_ATTR pushEvent(uint8_t pin, bool pressed, int64_t timestampUs)
+{
+    uint32_t head = ringHead.load(std::memory_order_relaxed);
+    if (head - ringTail.load(std::memory_order_acquire) >= BUTTON_EVENT_RING_SIZE)
+    {
+        stats.overflows++;
+        return;
+    }
+
+    ButtonEvent& slot = eventRing[head & (BUTTON_EVENT_RING_SIZE - 1)];
+    slot.timestampUs = timestampUs;
+    slot.pin = pin;
+    slot.pressed = pressed;
+    ringHead.store(head + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Debounce one edge and queue it if accepted
+ *
+ * Shared by the ISR and injectButtonEdge(); callers hold buttonMux.
+ */
+static void IRAM_ATTR handleEdge(ButtonPinState& state, int level, int64_t timestampUs)
+{
+    stats.edges++;
+    int64_t previousEdgeUs = state.lastEdgeUs;
+    bool hidden = state.rawLevel != state.stableLevel;
+    state.lastEdgeUs = timestampUs;
+    state.rawLevel = (uint8_t)level;
+
+    if (timestampUs - state.acceptedUs < BUTTON_DEBOUNCE_US)
+    {
+        stats.bounces++;
+        return;
+    }
+
+    if (level == state.stableLevel)
+    {
+        if (!hidden || timestampUs - previousEdgeUs < BUTTON_DEBOUNCE_US)
+        {
+            stats.bounces++;
+            return;
+        }
+
+        // The line settled away from the accepted level inside the lockout and
+        // stayed there; report that change before this edge undoes it, the way
+        // processButtonInput() would have if loop() had run in between
+        state.stableLevel = (uint8_t)!level;
+        stats.resyncs++;
+        pushEvent(state.pin, state.stableLevel == BUTTON_ACTIVE_LEVEL, previousEdgeUs);
+    }
+
+    state.stableLevel = (uint8_t)level;
+    state.acceptedUs = timestampUs;
+    stats.accepted++;
+    pushEvent(state.pin, level == BUTTON_ACTIVE_LEVEL, timestampUs);
+}
+
+static void IRAM_ATTR buttonIsr(void* arg)
+{
+    // Stamp first: everything after this line is latency we do not want in the timestamp
+    int64_t now = esp_timer_get_time();
+    ButtonPinState& state = *(ButtonPinState*)arg;
+    int level = gpio_ll_get_level(&GPIO, (gpio_num_t)state.pin);
+
+    portENTER_CRITICAL_ISR(&buttonMux);
+    handleEdge(state, level, now);
+    portEXIT_CRITICAL_ISR(&buttonMux);
+}
+
+static ButtonPinState* findPin(uint8_t pin)
+{
+    for (size_t i = 0; i < pinCount; i++)
+    {
+        if (pinStates[i].pin == pin)
+        {
+            return &pinStates[i];
+        }
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+bool initButtonInput(const uint8_t* pins, size_t count)
+{
+    if (count > MAX_BUTTON_PINS)
+    {
+        LOG_WARN("⚠️ Only %d of %u button pins will be captured\n", MAX_BUTTON_PINS, (unsigned)count);
+        count = MAX_BUTTON_PINS;
+    }
+
+    bool ok = true;
+    pinCount = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        uint8_t pin = pins[i];
+        if (!GPIO_IS_VALID_GPIO(pin) || findPin(pin))
+        {
+            LOG_ERROR("❌ Invalid or duplicate button pin %d\n", pin);
+            ok = false;
+            continue;
+        }
+
+        // GPIO34-39 are input-only without internal pull-ups; the board pulls them up
+        pinMode(pin, GPIO_IS_VALID_OUTPUT_GPIO(pin) ? INPUT_PULLUP : INPUT);
+
+        ButtonPinState& state = pinStates[pinCount++];
+        state.pin = pin;
+        state.stableLevel = (uint8_t)digitalRead(pin);
+        state.rawLevel = state.stableLevel;
+        state.acceptedUs = -BUTTON_DEBOUNCE_US;
+        state.lastEdgeUs = 0;
+
+        attachInterruptArg(digitalPinToInterrupt(pin), buttonIsr, &state, CHANGE);
+    }
+
+    LOG_INFO("🔘 Button capture on %u pins (debounce %d us)\n", (unsigned)pinCount, BUTTON_DEBOUNCE_US);
+    return ok;
+}
+
+bool popButtonEvent(ButtonEvent& event)
+{
+    uint32_t tail = ringTail.load(std::memory_order_relaxed);
+    if (tail == ringHead.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    event = eventRing[tail & (BUTTON_EVENT_RING_SIZE - 1)];
+    ringTail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool hasButtonEvents()
+{
+    return ringTail.load(std::memory_order_relaxed) != ringHead.load(std::memory_order_acquire);
+}
+
+void processButtonInput()
+{
+    int64_t now = esp_timer_get_time();
+    for (size_t i = 0; i < pinCount; i++)
+    {
+        ButtonPinState& state = pinStates[i];
+        int level = digitalRead(state.pin);
+
+        portENTER_CRITICAL(&buttonMux);
+        // Only once the lockout has expired and the line has been quiet for a full debounce period
+        if (level != state.stableLevel &&
+            now - state.acceptedUs >= BUTTON_DEBOUNCE_US &&
+            now - state.lastEdgeUs >= BUTTON_DEBOUNCE_US)
+        {
+            state.stableLevel = (uint8_t)level;
+            state.acceptedUs = state.lastEdgeUs;
+            stats.resyncs++;
+            pushEvent(state.pin, level == BUTTON_ACTIVE_LEVEL, state.lastEdgeUs);
+        }
+        portEXIT_CRITICAL(&buttonMux);
+    }
+}
+
+void injectButtonEdge(uint8_t pin, int level, int64_t timestampUs)
+{
+    ButtonPinState* state = findPin(pin);
+    if (!state)
+    {
+        return;
+    }
+
+    portENTER_CRITICAL(&buttonMux);
+    handleEdge(*state, level, timestampUs);
+    portEXIT_CRITICAL(&buttonMux);
+}
+
+ButtonInputStats getButtonInputStats()
+{
+    portENTER_CRITICAL(&buttonMux);
+    ButtonInputStats snapshot;
+    snapshot.edges = stats.edges;
+    snapshot.accepted = stats.accepted;
+    snapshot.bounces = stats.bounces;
+    snapshot.resyncs = stats.resyncs;
+    snapshot.overflows = stats.overflows;
+    portEXIT_CRITICAL(&buttonMux);
+    return snapshot;
+}
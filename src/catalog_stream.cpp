@@ -0,0 +1,361 @@
+/**
+ * @file catalog_stream.cpp
+ *
+ * This file implements the streaming catalog reader and parser. The parser
+ * walks the outer object by hand ('{', ':', ',', '}') and lets ArduinoJson
+ * deserialize each entry on its own; deserializeJson() stops at the end
+ * of a value, so the stream is left at the next separator.
+ *
+ * @date 2025
+ */
+
+#include "catalog_stream.h"
+#include <ArduinoJson.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+// ============================================================================
+// CLASS IMPLEMENTATION
+// ============================================================================
+
+CatalogReader::CatalogReader()
+    : source(nullptr), sourceContext(nullptr), inflater(nullptr), text(nullptr), textLength(0), textPos(0),
+      wireLength(0), wirePos(0), started(false), finished(false), maxTextTotal(0), wireTotal(0), textTotal(0),
+      errorText(nullptr)
+{
+}
+
+CatalogReader::~CatalogReader()
+{
+    end();
+}
+
+bool CatalogReader::begin(CatalogSource catalogSource, void* context, uint32_t maxText)
+{
+    end();
+    source = catalogSource;
+    sourceContext = context;
+    textLength = 0;
+    textPos = 0;
+    wireLength = 0;
+    wirePos = 0;
+    started = false;
+    finished = false;
+    maxTextTotal = maxText;
+    wireTotal = 0;
+    textTotal = 0;
+    errorText = nullptr;
+
+    text = (uint8_t*)malloc(CATALOG_TEXT_BUFFER);
+    if (!text)
+    {
+        errorText = "out of memory";
+        return false;
+    }
+    return true;
+}
+
+void CatalogReader::end()
+{
+    delete inflater;
+    inflater = nullptr;
+    free(text);
+    text = nullptr;
+}
+
+bool CatalogReader::store(const uint8_t* data, size_t length, void* context)
+{
+    CatalogReader* self = (CatalogReader*)context;
+    if (self->textLength + length > CATALOG_TEXT_BUFFER)
+    {
+        self->errorText = "text buffer overflow";
+        return false;
+    }
+    memcpy(self->text + self->textLength, data, length);
+    self->textLength += length;
+    return true;
+}
+
+bool CatalogReader::readWire()
+{
+    int n = source(wire, sizeof(wire), sourceContext);
+    if (n < 0)
+    {
+        errorText = "read failed";
+        return false;
+    }
+    wireLength = n;
+    wirePos = 0;
+    wireTotal += n;
+    return n > 0;
+}
+
+bool CatalogReader::refill()
+{
+    if (errorText || finished || !text)
+    {
+        return false;
+    }
+    textLength = 0;
+    textPos = 0;
+
+    if (!started)
+    {
+        if (!readWire())
+        {
+            finished = true;
+            return false;
+        }
+        started = true;
+
+        // A JSON document never starts with the gzip magic byte
+        if (wire[0] == 0x1F)
+        {
+            inflater = new (std::nothrow) GzipInflater();
+            if (!inflater || !inflater->begin(store, this))
+            {
+                errorText = "out of memory";
+                return false;
+            }
+        }
+    }
+
+    if (!inflater)
+    {
+        if (wirePos == wireLength && !readWire())
+        {
+            finished = true;
+            return false;
+        }
+        textLength = wireLength - wirePos;
+        memcpy(text, wire + wirePos, textLength);
+        wirePos = wireLength;
+    }
+    else
+    {
+        // One byte at a time keeps each write's output within the text buffer
+        while (textLength == 0)
+        {
+            if (inflater->status() == INFLATE_DONE)
+            {
+                finished = true;
+                return false;
+            }
+            if (wirePos == wireLength && !readWire())
+            {
+                if (!errorText)
+                {
+                    errorText = "compressed catalog truncated";
+                }
+                return false;
+            }
+            if (inflater->write(wire + wirePos++, 1) == INFLATE_ERROR)
+            {
+                if (!errorText)
+                {
+                    errorText = inflater->error();
+                }
+                return false;
+            }
+        }
+    }
+
+    textTotal += textLength;
+    if (textTotal > maxTextTotal)
+    {
+        errorText = "catalog too large";
+        return false;
+    }
+    return true;
+}
+
+int CatalogReader::read()
+{
+    if (textPos == textLength && !refill())
+    {
+        return -1;
+    }
+    return text[textPos++];
+}
+
+size_t CatalogReader::readBytes(char* buffer, size_t length)
+{
+    size_t done = 0;
+    while (done < length)
+    {
+        if (textPos == textLength && !refill())
+        {
+            break;
+        }
+        size_t n = textLength - textPos;
+        if (n > length - done)
+        {
+            n = length - done;
+        }
+        memcpy(buffer + done, text + textPos, n);
+        textPos += n;
+        done += n;
+    }
+    return done;
+}
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Skip whitespace, then consume the next byte
+ * @return The byte, or -1 at the end of the stream
+ */
+static int nextToken(CatalogReader& reader)
+{
+    int c;
+    do
+    {
+        c = reader.read();
+    } while (c == ' ' || c == '\t' || c == '\r' || c == '\n');
+    return c;
+}
+
+static bool isRelativePath(const char* path)
+{
+    return path[0] != '\0' && path[0] != '/' && !strstr(path, "://");
+}
+
+/**
+ * @brief Join base and path into *joined, growing it as needed
+ * @return The joined path, or nullptr if out of memory
+ */
+static const char* joinPath(const char* base, const char* path, char** joined, size_t* capacity)
+{
+    size_t baseLength = strlen(base);
+    bool slash = baseLength > 0 && base[baseLength - 1] != '/';
+    size_t length = baseLength + slash + strlen(path) + 1;
+    if (length > *capacity)
+    {
+        char* grown = (char*)realloc(*joined, length);
+        if (!grown)
+        {
+            return nullptr;
+        }
+        *joined = grown;
+        *capacity = length;
+    }
+    memcpy(*joined, base, baseLength);
+    if (slash)
+    {
+        (*joined)[baseLength] = '/';
+    }
+    strcpy(*joined + baseLength + slash, path);
+    return *joined;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+const char* parseCatalogStream(CatalogReader& reader, CatalogEntryVisitor visitor, void* context)
+{
+    JsonDocument doc;
+    char key[CATALOG_MAX_KEY];
+    char* base = nullptr;
+    char* joined = nullptr;
+    size_t joinedCapacity = 0;
+    const char* failure = nullptr;
+
+    int c = nextToken(reader);
+    if (c != '{')
+    {
+        failure = c < 0 ? "empty catalog" : "catalog is not a JSON object";
+    }
+    else if ((c = nextToken(reader)) != '}')
+    {
+        for (;;)
+        {
+            // Key: catalog keys are plain strings, so no escapes to undo
+            if (c != '"')
+            {
+                failure = c < 0 ? "catalog truncated" : "expected a key in catalog";
+                break;
+            }
+            size_t length = 0;
+            while ((c = reader.read()) >= 0 && c != '"' && c != '\\' && length + 1 < sizeof(key))
+            {
+                key[length++] = (char)c;
+            }
+            if (c != '"')
+            {
+                failure = c < 0 ? "catalog truncated" : "unsupported catalog key";
+                break;
+            }
+            key[length] = '\0';
+            if (nextToken(reader) != ':')
+            {
+                failure = "expected ':' in catalog";
+                break;
+            }
+
+            // Value: one entry, deserialized on its own
+            DeserializationError error = deserializeJson(doc, reader);
+            if (error)
+            {
+                failure = error.c_str();
+                break;
+            }
+
+            if (strcmp(key, CATALOG_BASE_KEY) == 0)
+            {
+                free(base);
+                base = doc.is<const char*>() ? strdup(doc.as<const char*>()) : nullptr;
+            }
+            else
+            {
+                JsonObject entry = doc.as<JsonObject>();
+                const char* path = entry["path"] | "";
+                if (base && isRelativePath(path))
+                {
+                    path = joinPath(base, path, &joined, &joinedCapacity);
+                    if (!path)
+                    {
+                        failure = "out of memory";
+                        break;
+                    }
+                }
+                if (!visitor(key, entry["description"] | "Unknown", entry["type"] | "unknown", path, context))
+                {
+                    break;
+                }
+            }
+
+            c = nextToken(reader);
+            if (c == '}')
+            {
+                break;
+            }
+            if (c != ',')
+            {
+                failure = c < 0 ? "catalog truncated" : "expected ',' or '}' in catalog";
+                break;
+            }
+            c = nextToken(reader);
+        }
+    }
+
+    if (!failure && c == '}')
+    {
+        // Read to the end so a gzip catalog's CRC and length get checked
+        while (reader.read() >= 0)
+        {
+        }
+        failure = reader.error();
+    }
+
+    free(base);
+    free(joined);
+    if (failure && reader.error())
+    {
+        failure = reader.error(); // The stream failed underneath the parser
+    }
+    return failure;
+}
@@ -0,0 +1,486 @@
+/**
+ * @file control_api.cpp
+ *
+ * This file implements the /api control endpoints and the job table that
+ * hands their long-running work to loop().
+ *
+ * @date 2025
+ */
+
+#define LOG_MODULE LOG_MODULE_WIFI
+#include "control_api.h"
+#include "wifi_manager.h"
+#include "audio_file_manager.h"
+#include "audio_file_player.h"
+#include "logging.h"
+#include "ota_pull.h"
+#include "ota_image_stream.h"
+#include <functional>
+#include <memory>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+// Job i lives in slot (i - 1) % CONTROL_JOB_SLOTS. Jobs lastJobRun+1 ..
+// lastJobId are queued; they run one at a time in ID order.
+static ControlJob jobs[CONTROL_JOB_SLOTS];
+static uint32_t lastJobId = 0;
+static uint32_t lastJobRun = 0;
+static portMUX_TYPE jobMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Part of every signed /api/ota request; replaced once a signature is accepted,
+// so a captured request cannot be replayed (only the web task touches it)
+static char otaNonce[9] = "";
+
+static const char* const jobTypeNames[] = {"catalog_refresh", "clear_downloads"};
+static const char* const jobStateNames[] = {"queued", "running", "done", "failed"};
+
+// Position in a list being written one item per part
+struct ListItemContext
+{
+    Print* out;
+    int index;
+};
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static ControlJob& jobSlot(uint32_t id)
+{
+    return jobs[(id - 1) % CONTROL_JOB_SLOTS];
+}
+
+// Accept a value from the query string or a form body
+static const AsyncWebParameter* findParam(AsyncWebServerRequest* request, const char* name)
+{
+    if (request->hasParam(name))
+    {
+        return request->getParam(name);
+    }
+    if (request->hasParam(name, true))
+    {
+        return request->getParam(name, true);
+    }
+    return nullptr;
+}
+
+// Write ,"name":"value" with the value escaped
+static void writeJsonField(Print& out, const char* name, const char* value)
+{
+    out.printf(",\"%s\":\"", name);
+    if (value)
+    {
+        writeJsonEscaped(out, value, strlen(value));
+    }
+    out.print('"');
+}
+
+static void writeJobJson(Print& out, const ControlJob& job)
+{
+    out.printf("{\"id\":%lu,\"type\":\"%s\",\"state\":\"%s\",\"queuedMs\":%lu,\"startedMs\":%lu,\"finishedMs\":%lu}",
+               (unsigned long)job.id, jobTypeNames[job.type], jobStateNames[job.state],
+               (unsigned long)job.queuedMs, (unsigned long)job.startedMs, (unsigned long)job.finishedMs);
+}
+
+// Reply with a single-part JSON body; body() runs when the response is
+// sent, after the handler has returned, so it must only use captured copies
+static void sendJson(AsyncWebServerRequest* request, int code, std::function<void(Print&)> body)
+{
+    AsyncWebServerResponse* response = beginPartResponse(request, "application/json", [body](Print& out)
+    {
+        body(out);
+        return false;
+    });
+    response->setCode(code);
+    request->send(response);
+}
+
+// Reply with an error; message must be a string constant
+static void sendJsonError(AsyncWebServerRequest* request, int code, const char* message)
+{
+    sendJson(request, code, [message](Print& out)
+    {
+        out.printf("{\"error\":\"%s\"}", message);
+    });
+}
+
+// Reply 202 with the job just queued, or 503 if the job table is full
+static void sendJobQueued(AsyncWebServerRequest* request, uint32_t id)
+{
+    ControlJob job;
+    if (id == 0 || !getControlJob(id, job))
+    {
+        sendJsonError(request, 503, "too many unfinished jobs");
+        return;
+    }
+
+    char location[32];
+    snprintf(location, sizeof(location), "/api/jobs?id=%lu", (unsigned long)id);
+    AsyncWebServerResponse* response = beginPartResponse(request, "application/json", [job](Print& out)
+    {
+        writeJobJson(out, job);
+        return false;
+    });
+    response->setCode(202);
+    response->addHeader("Location", location);
+    request->send(response);
+}
+
+// {"<name>":[item, item, ...],"count":N}, one item per part; writeItem()
+// returns false past the last item
+static void sendJsonList(AsyncWebServerRequest* request, const char* name, bool (*writeItem)(Print&, int))
+{
+    auto index = std::make_shared<int>(-1);
+    request->send(beginPartResponse(request, "application/json", [name, writeItem, index](Print& out)
+    {
+        if (*index < 0)
+        {
+            out.printf("{\"%s\":[", name);
+            *index = 0;
+            return true;
+        }
+        if (writeItem(out, *index))
+        {
+            (*index)++;
+            return true;
+        }
+        out.printf("],\"count\":%d}", *index);
+        return false;
+    }));
+}
+
+static void writeAudioKeyJson(const AudioFile& file, void* context)
+{
+    ListItemContext& item = *(ListItemContext*)context;
+    Print& out = *item.out;
+    out.printf("%s{\"index\":%d", item.index ? "," : "", item.index);
+    writeJsonField(out, "key", file.audioKey);
+    writeJsonField(out, "description", file.description);
+    writeJsonField(out, "type", file.type);
+    writeJsonField(out, "path", file.path);
+    out.print('}');
+}
+
+static bool writeCatalogItem(Print& out, int index)
+{
+    ListItemContext item = {&out, index};
+    return visitAudioKey(index, writeAudioKeyJson, &item);
+}
+
+static void writeDownloadItemJson(const AudioDownloadItem& download, AudioDownloadState state, void* context)
+{
+    static const char* const stateNames[] = {"pending", "downloading", "done"};
+    ListItemContext& item = *(ListItemContext*)context;
+    Print& out = *item.out;
+    out.printf("%s{\"index\":%d,\"state\":\"%s\"", item.index ? "," : "", item.index, stateNames[state]);
+    writeJsonField(out, "description", download.description);
+    writeJsonField(out, "url", download.url);
+    writeJsonField(out, "path", download.localPath);
+    out.print('}');
+}
+
+static bool writeDownloadItem(Print& out, int index)
+{
+    ListItemContext item = {&out, index};
+    return visitDownloadItem(index, writeDownloadItemJson, &item);
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+uint32_t queueControlJob(ControlJobType type)
+{
+    uint32_t id = 0;
+    portENTER_CRITICAL(&jobMux);
+    for (uint32_t i = lastJobRun + 1; i <= lastJobId; i++)
+    {
+        if (jobSlot(i).type == type)
+        {
+            id = i;
+            break;
+        }
+    }
+    if (id == 0)
+    {
+        ControlJob& slot = jobSlot(lastJobId + 1);
+        if (slot.id == 0 || slot.state == CONTROL_JOB_DONE || slot.state == CONTROL_JOB_FAILED)
+        {
+            id = ++lastJobId;
+            slot = {id, type, CONTROL_JOB_QUEUED, (uint32_t)millis(), 0, 0};
+        }
+    }
+    portEXIT_CRITICAL(&jobMux);
+    return id;
+}
+
+bool getControlJob(uint32_t id, ControlJob& job)
+{
+    if (id == 0)
+    {
+        return false;
+    }
+    portENTER_CRITICAL(&jobMux);
+    job = jobSlot(id);
+    portEXIT_CRITICAL(&jobMux);
+    return job.id == id;
+}
+
+void processControlJobs()
+{
+    ControlJob* job = nullptr;
+    portENTER_CRITICAL(&jobMux);
+    if (lastJobRun < lastJobId)
+    {
+        // The slot cannot be reused until the job is finished
+        job = &jobSlot(++lastJobRun);
+        job->state = CONTROL_JOB_RUNNING;
+        job->startedMs = millis();
+    }
+    portEXIT_CRITICAL(&jobMux);
+
+    if (!job)
+    {
+        return;
+    }
+
+    LOG_INFO("🛠️ Running job %lu (%s)\n", (unsigned long)job->id, jobTypeNames[job->type]);
+    bool ok = true;
+    switch (job->type)
+    {
+    case CONTROL_JOB_CATALOG_REFRESH:
+        ok = downloadAudio(true);
+        break;
+
+    case CONTROL_JOB_CLEAR_DOWNLOADS:
+        clearDownloadQueue();
+        break;
+    }
+
+    portENTER_CRITICAL(&jobMux);
+    job->state = ok ? CONTROL_JOB_DONE : CONTROL_JOB_FAILED;
+    job->finishedMs = millis();
+    portEXIT_CRITICAL(&jobMux);
+    LOG_INFO("%s Job %lu %s\n", ok ? "✅" : "❌", (unsigned long)job->id, ok ? "done" : "failed");
+}
+
+// Queue a sound by key; the key is resolved later in processAudioFile()
+void handleApiPlay(AsyncWebServerRequest* request)
+{
+    const AsyncWebParameter* param = findParam(request, "key");
+    if (!param || param->value().length() == 0 || param->value().length() >= AUDIO_KEY_MAX_LENGTH)
+    {
+        sendJsonError(request, 400, "key required");
+        return;
+    }
+
+    char key[AUDIO_KEY_MAX_LENGTH];
+    strlcpy(key, param->value().c_str(), sizeof(key));
+    if (!playAudioByKey(key))
+    {
+        sendJsonError(request, 503, "player not ready or request queue full");
+        return;
+    }
+
+    sendJson(request, 202, [key](Print& out)
+    {
+        out.print("{\"key\":\"");
+        writeJsonEscaped(out, key, strlen(key));
+        out.print("\",\"queued\":true}");
+    });
+}
+
+void handleApiGetVolume(AsyncWebServerRequest* request)
+{
+    float volume = getVolume();
+    sendJson(request, 200, [volume](Print& out)
+    {
+        out.printf("{\"volume\":%.2f}", volume);
+    });
+}
+
+// setVolume() only queues a mixer command and writes the settings store,
+// both of which are safe from the network task
+void handleApiSetVolume(AsyncWebServerRequest* request)
+{
+    const AsyncWebParameter* param = findParam(request, "value");
+    const char* text = param ? param->value().c_str() : "";
+    char* end;
+    float volume = strtof(text, &end);
+    if (end == text || *end != '\0' || !(volume >= 0.0f && volume <= 1.0f))
+    {
+        sendJsonError(request, 400, "value must be between 0 and 1");
+        return;
+    }
+
+    setVolume(volume);
+    handleApiGetVolume(request);
+}
+
+void handleApiCatalog(AsyncWebServerRequest* request)
+{
+    sendJsonList(request, "keys", writeCatalogItem);
+}
+
+void handleApiCatalogRefresh(AsyncWebServerRequest* request)
+{
+    sendJobQueued(request, queueControlJob(CONTROL_JOB_CATALOG_REFRESH));
+}
+
+void handleApiDownloads(AsyncWebServerRequest* request)
+{
+    sendJsonList(request, "items", writeDownloadItem);
+}
+
+void handleApiClearDownloads(AsyncWebServerRequest* request)
+{
+    sendJobQueued(request, queueControlJob(CONTROL_JOB_CLEAR_DOWNLOADS));
+}
+
+// One job with ?id=N, otherwise every remembered job, newest first
+void handleApiJobs(AsyncWebServerRequest* request)
+{
+    const AsyncWebParameter* param = findParam(request, "id");
+    if (param)
+    {
+        ControlJob job;
+        if (!getControlJob(strtoul(param->value().c_str(), nullptr, 10), job))
+        {
+            sendJsonError(request, 404, "unknown job");
+            return;
+        }
+        sendJson(request, 200, [job](Print& out)
+        {
+            writeJobJson(out, job);
+        });
+        return;
+    }
+
+    portENTER_CRITICAL(&jobMux);
+    uint32_t newest = lastJobId;
+    portEXIT_CRITICAL(&jobMux);
+
+    auto id = std::make_shared<uint32_t>(newest + 1);
+    request->send(beginPartResponse(request, "application/json", [id, newest](Print& out)
+    {
+        if (*id > newest)
+        {
+            out.print("{\"jobs\":[");
+            (*id)--;
+            return true;
+        }
+        ControlJob job;
+        if (newest - *id < CONTROL_JOB_SLOTS && getControlJob(*id, job))
+        {
+            if (*id != newest)
+            {
+                out.print(',');
+            }
+            writeJobJson(out, job);
+            (*id)--;
+            return true;
+        }
+        out.print("]}");
+        return false;
+    }));
+}
+
+static const char* currentOtaNonce(bool renew = false)
+{
+    if (renew || !otaNonce[0])
+    {
+        snprintf(otaNonce, sizeof(otaNonce), "%08lx", (unsigned long)esp_random());
+    }
+    return otaNonce;
+}
+
+/**
+ * @brief Check the sig parameter of a pull OTA request
+ *
+ * sig is the hex HMAC-SHA256, keyed with OTA_PASSWORD, of
+ * "<nonce>\n<url>\n<sha256>\n<size>" (size as sent, empty if absent).
+ */
+static bool otaRequestSigned(const AsyncWebParameter* url, const AsyncWebParameter* sha256,
+                             const AsyncWebParameter* size, const AsyncWebParameter* sig)
+{
+    uint8_t expected[OTA_SHA256_LENGTH];
+    uint8_t given[OTA_SHA256_LENGTH];
+    char message[OTA_PULL_URL_LENGTH + 96];
+    int length = snprintf(message, sizeof(message), "%s\n%s\n%s\n%s", currentOtaNonce(), url->value().c_str(),
+                          sha256->value().c_str(), size ? size->value().c_str() : "");
+    if (!sig || !parseSha256Hex(sig->value().c_str(), given) || length < 0 || length >= (int)sizeof(message))
+    {
+        return false;
+    }
+    return hmacSha256(OTA_PASSWORD, (const uint8_t*)message, length, expected) && digestsEqual(expected, given);
+}
+
+static void sendOtaStatus(AsyncWebServerRequest* request, int code)
+{
+    static const char* const stateNames[] = {"idle", "downloading", "done", "failed"};
+    OtaPullStatus status = getPullOtaStatus();
+    struct
+    {
+        char text[sizeof(otaNonce)];
+    } nonce;
+    strlcpy(nonce.text, currentOtaNonce(), sizeof(nonce.text));
+    sendJson(request, code, [status, nonce](Print& out)
+    {
+        out.printf("{\"state\":\"%s\",\"compressed\":%s,\"bytes\":%lu,\"size\":%ld,\"image\":%lu,"
+                   "\"resumes\":%lu,\"elapsedMs\":%lu,\"nonce\":\"%s\"",
+                   stateNames[status.state], status.compressed ? "true" : "false",
+                   (unsigned long)status.streamBytes, (long)status.streamSize,
+                   (unsigned long)status.imageBytes, (unsigned long)status.resumes,
+                   (unsigned long)status.elapsedMs, nonce.text);
+        if (status.state == OTA_PULL_FAILED)
+        {
+            out.print(",\"error\":\"");
+            writeJsonEscaped(out, status.error, strlen(status.error));
+            out.print('"');
+        }
+        out.print('}');
+    });
+}
+
+void handleApiStartOta(AsyncWebServerRequest* request)
+{
+    const AsyncWebParameter* url = findParam(request, "url");
+    const AsyncWebParameter* sha256 = findParam(request, "sha256");
+    const AsyncWebParameter* size = findParam(request, "size");
+    const AsyncWebParameter* sig = findParam(request, "sig");
+    if (!url || !sha256)
+    {
+        sendJsonError(request, 400, "url and sha256 required");
+        return;
+    }
+    if (!otaRequestSigned(url, sha256, size, sig))
+    {
+        LOG_WARN("⚠️ Rejected unsigned or badly signed /api/ota request\n");
+        sendJsonError(request, 403, "missing or invalid sig");
+        return;
+    }
+    currentOtaNonce(true); // Spent, whether or not the update starts
+    switch (startPullOta(url->value().c_str(), sha256->value().c_str(),
+                         size ? strtoul(size->value().c_str(), nullptr, 10) : 0))
+    {
+    case OTA_START_OK:
+        sendOtaStatus(request, 202);
+        break;
+    case OTA_START_BUSY:
+        sendJsonError(request, 409, "an update is already running");
+        break;
+    case OTA_START_INVALID:
+        sendJsonError(request, 400, "invalid url or sha256");
+        break;
+    default:
+        sendJsonError(request, 503, "could not start the update");
+        break;
+    }
+}
+
+void handleApiOtaStatus(AsyncWebServerRequest* request)
+{
+    sendOtaStatus(request, 200);
+}
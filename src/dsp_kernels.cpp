@@ -0,0 +1,185 @@
+/**
+ * @file dsp_kernels.cpp
+ *
+ * This file implements the fixed-point block kernels. Loops are written as
+ * tight pointer walks with the gain hoisted, which the Xtensa compiler turns
+ * into MULL/loop-instruction code.
+ *
+ * @date 2025
+ */
+
+#include "dsp_kernels.h"
+#include <math.h>
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static inline int32_t stepTowards(int32_t gain, int32_t step, int32_t target)
+{
+    if (step >= 0)
+    {
+        gain += step;
+        return gain > target ? target : gain;
+    }
+    gain += step;
+    return gain < target ? target : gain;
+}
+
+static inline uint32_t nextRandom(uint32_t* state)
+{
+    // xorshift32: cheap and good enough for dither noise
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void dspGainQ15(int16_t* samples, size_t count, int32_t gainQ15)
+{
+    if (gainQ15 >= DSP_Q15_ONE)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        samples[i] = (int16_t)((samples[i] * gainQ15) >> 15);
+    }
+}
+
+void dspGainQ31(int32_t* samples, size_t count, int32_t gainQ31)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        samples[i] = (int32_t)(((int64_t)samples[i] * gainQ31) >> 31);
+    }
+}
+
+int32_t dspFadeLinearQ15(int16_t* samples, size_t frames, int channels,
+                         int32_t gainQ15, int32_t stepQ15, int32_t targetQ15)
+{
+    for (size_t f = 0; f < frames; f++)
+    {
+        if (gainQ15 == targetQ15)
+        {
+            // Ramp finished: rest of the block is plain gain
+            dspGainQ15(samples, (frames - f) * channels, gainQ15);
+            break;
+        }
+        gainQ15 = stepTowards(gainQ15, stepQ15, targetQ15);
+        for (int c = 0; c < channels; c++)
+        {
+            *samples = (int16_t)((*samples * gainQ15) >> 15);
+            samples++;
+        }
+    }
+    return gainQ15;
+}
+
+int32_t dspFadeExpQ15(int16_t* samples, size_t frames, int channels,
+                      int32_t gainQ15, int32_t targetQ15, int32_t coeffQ15)
+{
+    for (size_t f = 0; f < frames; f++)
+    {
+        int32_t delta = ((targetQ15 - gainQ15) * coeffQ15) >> 15;
+        if (delta == 0)
+        {
+            gainQ15 = targetQ15; // Close enough: snap so the fade terminates
+        }
+        else
+        {
+            gainQ15 += delta;
+        }
+        for (int c = 0; c < channels; c++)
+        {
+            *samples = (int16_t)((*samples * gainQ15) >> 15);
+            samples++;
+        }
+    }
+    return gainQ15;
+}
+
+int32_t dspExpFadeCoeffQ15(uint32_t sampleRate, float timeConstantMs)
+{
+    if (sampleRate == 0 || timeConstantMs <= 0.0f)
+    {
+        return DSP_Q15_ONE;
+    }
+    float samples = timeConstantMs * (float)sampleRate / 1000.0f;
+    return (int32_t)(DSP_Q15_ONE * (1.0f - expf(-1.0f / samples)) + 0.5f);
+}
+
+void dspMixSaturate16(int16_t* dst, const int16_t* src, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        dst[i] = dspSaturate16((int32_t)dst[i] + src[i]);
+    }
+}
+
+void dspMixAccumulateQ15(int32_t* acc, const int16_t* in, size_t count,
+                         int32_t gainQ15, int fracBits)
+{
+    const int shift = 15 - fracBits;
+    for (size_t i = 0; i < count; i++)
+    {
+        acc[i] += (in[i] * gainQ15) >> shift;
+    }
+}
+
+int32_t dspMixAccumulateRampQ15(int32_t* acc, const int16_t* in, size_t frames, int channels,
+                                int32_t gainQ15, int32_t stepQ15, int32_t targetQ15,
+                                int fracBits)
+{
+    const int shift = 15 - fracBits;
+    for (size_t f = 0; f < frames; f++)
+    {
+        if (gainQ15 == targetQ15)
+        {
+            dspMixAccumulateQ15(acc, in, (frames - f) * channels, gainQ15, fracBits);
+            break;
+        }
+        gainQ15 = stepTowards(gainQ15, stepQ15, targetQ15);
+        for (int c = 0; c < channels; c++)
+        {
+            *acc++ += (*in++ * gainQ15) >> shift;
+        }
+    }
+    return gainQ15;
+}
+
+void dspReduceTo16(int16_t* out, const int32_t* acc, size_t count, int fracBits)
+{
+    const int32_t round = fracBits > 0 ? 1 << (fracBits - 1) : 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = dspSaturate16((acc[i] + round) >> fracBits);
+    }
+}
+
+void dspDitherTpdfTo16(int16_t* out, const int32_t* acc, size_t count, int fracBits,
+                       uint32_t* rngState)
+{
+    if (fracBits <= 0)
+    {
+        dspReduceTo16(out, acc, count, 0);
+        return;
+    }
+
+    // Difference of two uniform values spanning one output LSB gives triangular noise of +-1 LSB
+    const uint32_t mask = (1u << fracBits) - 1;
+    const int32_t round = 1 << (fracBits - 1);
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t r = nextRandom(rngState);
+        int32_t tpdf = (int32_t)(r & mask) - (int32_t)((r >> 16) & mask);
+        out[i] = dspSaturate16((acc[i] + tpdf + round) >> fracBits);
+    }
+}
@@ -0,0 +1,280 @@
+/**
+ * @file event_stream.cpp
+ *
+ * This file implements the /events stream: the shared event ring, the task
+ * that forwards ring events and log records to the SSE clients, and
+ * Last-Event-ID replay.
+ *
+ * @date 2025
+ */
+
+#define LOG_MODULE LOG_MODULE_WIFI
+#include "event_stream.h"
+#include "logging.h"
+#include "metrics.h"
+#include <atomic>
+
+// Room for one log record as JSON, even if every byte is escaped as \u00XX
+#define LOG_EVENT_LENGTH (MAX_LOG_MESSAGE_LENGTH * 6 + 96)
+
+static_assert(EVENT_STRING_LENGTH + 64 <= EVENT_DATA_LENGTH,
+              "An event with one escaped string field must fit EVENT_DATA_LENGTH");
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+struct StreamEvent
+{
+    uint32_t sequence;
+    StreamEventType type;
+    char data[EVENT_DATA_LENGTH];
+};
+
+// One formatted log event
+struct LogEventBuffer : public Print
+{
+    char data[LOG_EVENT_LENGTH + 1];
+    size_t length = 0;
+
+    size_t write(uint8_t byte) override
+    {
+        return write(&byte, 1);
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override
+    {
+        size_t n = min(size, LOG_EVENT_LENGTH - length);
+        memcpy(data + length, buffer, n);
+        length += n;
+        return n;
+    }
+};
+
+// One escaped string field; a write that does not fit whole is refused, and so is everything after it
+struct EventStringBuffer : public Print
+{
+    char* data;
+    size_t length = 0;
+    bool full = false;
+
+    explicit EventStringBuffer(char* out) : data(out) {}
+
+    size_t write(uint8_t byte) override
+    {
+        return write(&byte, 1);
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override
+    {
+        if (full || length + size > EVENT_STRING_LENGTH - 1)
+        {
+            full = true;
+            return 0;
+        }
+        memcpy(data + length, buffer, size);
+        length += size;
+        return size;
+    }
+};
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static AsyncEventSource events("/events");
+static TaskHandle_t streamTaskHandle = nullptr;
+
+// Event i lives in slot (i - 1) % EVENT_RING_SLOTS
+static StreamEvent ring[EVENT_RING_SLOTS];
+static uint32_t lastSequence = 0;
+static portMUX_TYPE ringMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Newest ring event the stream task has sent; replay on connect stops here
+static std::atomic<uint32_t> sentSequence(0);
+
+// Only the stream task touches these
+static uint32_t logCursor = 0;
+static LogEventBuffer logEvent;
+
+static const char* const eventTypeNames[] = {"game", "playback", "download"};
+
+// Exported at /metrics
+static MetricCounter eventsPublished("sse_events_published_total", "Events published to /events");
+static MetricCounter messagesDiscarded("sse_messages_discarded_total",
+                                       "Events not queued for at least one client because its queue was full");
+static MetricGauge clientCount("sse_clients", "Connected /events clients",
+                               []() { return (int32_t)events.count(); });
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Copy the ring event that follows sequence
+ * @return false if there is none; an event already overwritten is skipped
+ *         and the oldest one still held is returned instead
+ */
+static bool readEventAfter(uint32_t sequence, StreamEvent& event)
+{
+    bool found = false;
+    portENTER_CRITICAL(&ringMux);
+    if (sequence < lastSequence)
+    {
+        uint32_t oldest = lastSequence > EVENT_RING_SLOTS ? lastSequence - EVENT_RING_SLOTS + 1 : 1;
+        event = ring[(max(sequence + 1, oldest) - 1) % EVENT_RING_SLOTS];
+        found = true;
+    }
+    portEXIT_CRITICAL(&ringMux);
+    return found;
+}
+
+static void sendToClients(const char* data, const char* type, uint32_t id)
+{
+    if (events.send(data, type, id) != AsyncEventSource::ENQUEUED)
+    {
+        messagesDiscarded.add();
+    }
+}
+
+// No id: log records keep their own sequence, and Last-Event-ID stays on the ring
+static void sendLogRecord(const LogRecord& record, void* context)
+{
+    logEvent.length = 0;
+    logEvent.printf("{\"seq\":%lu,\"t\":%lu,\"level\":%u,\"module\":\"%s\",\"msg\":\"",
+                    (unsigned long)record.sequence, (unsigned long)record.timestampMs, record.level,
+                    LoggerClass::moduleName(record.module));
+    writeJsonEscaped(logEvent, record.message, record.length);
+    logEvent.print("\"}");
+    logEvent.data[logEvent.length] = '\0';
+
+    sendToClients(logEvent.data, "log", 0);
+    logCursor = record.sequence;
+}
+
+static void eventStreamTask(void* parameter)
+{
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(EVENT_LOG_POLL_MS));
+
+        StreamEvent event;
+        while (readEventAfter(sentSequence.load(), event))
+        {
+            if (events.count() > 0)
+            {
+                sendToClients(event.data, eventTypeNames[event.type], event.sequence);
+            }
+            sentSequence.store(event.sequence);
+        }
+
+        // Nothing is logged from here: each line would come back as another log event
+        if (events.count() > 0)
+        {
+            Logger.forEachRecordSince(logCursor, sendLogRecord, nullptr);
+        }
+        else
+        {
+            logCursor = Logger.getLastSequence();
+        }
+    }
+}
+
+// Runs on the network task as a client connects
+static void onClientConnect(AsyncEventSourceClient* client)
+{
+    uint32_t lastId = client->lastId();
+    uint32_t sent = sentSequence.load();
+
+    if (lastId == 0 || lastId > sent)
+    {
+        // New client, or one from before a reboot: tell it where both streams stand
+        char hello[64];
+        snprintf(hello, sizeof(hello), "{\"seq\":%lu,\"logSeq\":%lu}", (unsigned long)sent,
+                 (unsigned long)Logger.getLastSequence());
+        client->send(hello, "hello", sent, EVENT_RETRY_MS);
+        return;
+    }
+
+    // Reconnect: replay what it missed; anything after "sent" comes from the stream task
+    StreamEvent event;
+    uint32_t sequence = lastId;
+    while (sequence < sent && readEventAfter(sequence, event))
+    {
+        client->send(event.data, eventTypeNames[event.type], event.sequence);
+        sequence = event.sequence;
+    }
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+bool initEventStream()
+{
+    if (streamTaskHandle)
+    {
+        return true;
+    }
+
+    if (xTaskCreatePinnedToCore(eventStreamTask, "eventStream", EVENT_TASK_STACK, nullptr,
+                                EVENT_TASK_PRIORITY, &streamTaskHandle, EVENT_TASK_CORE) != pdPASS)
+    {
+        LOG_ERROR("❌ Failed to start the event stream task");
+        return false;
+    }
+    return true;
+}
+
+void attachEventStream(AsyncWebServer& server)
+{
+    events.onConnect(onClientConnect);
+    events.setFilter([](AsyncWebServerRequest* request)
+    {
+        return events.count() < EVENT_MAX_CLIENTS;
+    });
+    server.addHandler(&events);
+}
+
+void escapeEventString(char* out, const char* text)
+{
+    EventStringBuffer escaped(out);
+    size_t i = 0;
+    while (text[i] && !escaped.full)
+    {
+        // One character at a time, so an escape or a UTF-8 sequence is kept or dropped whole
+        size_t length = 1;
+        if ((uint8_t)text[i] >= 0xC0)
+        {
+            while (length < 4 && ((uint8_t)text[i + length] & 0xC0) == 0x80)
+            {
+                length++;
+            }
+        }
+        writeJsonEscaped(escaped, text + i, length);
+        i += length;
+    }
+    out[escaped.length] = '\0';
+}
+
+void publishEvent(StreamEventType type, const char* format, ...)
+{
+    char data[EVENT_DATA_LENGTH];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(data, sizeof(data), format, args);
+    va_end(args);
+
+    portENTER_CRITICAL(&ringMux);
+    StreamEvent& slot = ring[lastSequence % EVENT_RING_SLOTS];
+    slot.sequence = ++lastSequence;
+    slot.type = type;
+    memcpy(slot.data, data, sizeof(data));
+    portEXIT_CRITICAL(&ringMux);
+
+    eventsPublished.add();
+    if (streamTaskHandle)
+    {
+        xTaskNotifyGive(streamTaskHandle);
+    }
+}
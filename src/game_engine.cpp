@@ -0,0 +1,293 @@
+/**
+ * @file game_engine.cpp
+ *
+ * This file implements the input lookup and the per-station round logic of
+ * the game engine.
+ *
+ * @date 2025
+ */
+
+#include "game_engine.h"
+#include <string.h>
+
+static_assert(GAME_MAX_STATIONS <= 32, "Station masks are 32 bits wide");
+static_assert(GAME_PLAYERS >= 1 && GAME_PLAYERS <= GAME_MAX_PLAYERS, "GAME_PLAYERS out of range");
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief Signed distance from a to b, correct across 32-bit rollover
+ */
+static inline int32_t elapsedMs(uint32_t from, uint32_t to)
+{
+    return (int32_t)(to - from);
+}
+
+static inline uint32_t playerMask(int players)
+{
+    return players >= 32 ? 0xFFFFFFFFu : (1u << players) - 1;
+}
+
+// ============================================================================
+// GameInputMap
+// ============================================================================
+
+GameInputMap::GameInputMap()
+    : inputs_(nullptr)
+{
+    memset(index_, -1, sizeof(index_));
+}
+
+bool GameInputMap::begin(const GameInput* inputs, size_t count)
+{
+    inputs_ = inputs;
+    memset(index_, -1, sizeof(index_));
+
+    bool ok = count <= 127;
+    for (size_t i = 0; i < count && i <= 127; i++)
+    {
+        uint8_t pin = inputs[i].pin;
+        if (pin >= GAME_MAX_PINS || index_[pin] >= 0)
+        {
+            ok = false;
+            continue;
+        }
+        index_[pin] = (int8_t)i;
+    }
+    return ok;
+}
+
+// ============================================================================
+// GameEngine - PUBLIC FUNCTIONS
+// ============================================================================
+
+GameEngine::GameEngine(uint32_t timeoutMs)
+    : stations_(),
+      waitingMask_(0),
+      playingMask_(0),
+      handler_(nullptr),
+      handlerContext_(nullptr),
+      clock_(nullptr),
+      clockContext_(nullptr),
+      stats_()
+{
+    for (int i = 0; i < GAME_MAX_STATIONS; i++)
+    {
+        configureStation(i, i == 0 ? GAME_PLAYERS : 0, timeoutMs);
+    }
+}
+
+void GameEngine::setEventHandler(GameEventHandler handler, void* context)
+{
+    handler_ = handler;
+    handlerContext_ = context;
+}
+
+void GameEngine::setClock(GameClock clock, void* context)
+{
+    clock_ = clock;
+    clockContext_ = context;
+}
+
+void GameEngine::configureStation(int station, int players, uint32_t timeoutMs)
+{
+    if (station < 0 || station >= GAME_MAX_STATIONS)
+    {
+        return;
+    }
+
+    players = players < 0 ? 0 : (players > GAME_MAX_PLAYERS ? GAME_MAX_PLAYERS : players);
+    Station& s = stations_[station];
+    s = Station();
+    s.players = (uint8_t)players;
+    s.timeoutMs = timeoutMs;
+    s.fullMask = playerMask(players);
+    waitingMask_ &= ~(1u << station);
+    playingMask_ &= ~(1u << station);
+}
+
+void GameEngine::configureStations(const GameInput* inputs, size_t count)
+{
+    int players[GAME_MAX_STATIONS] = {};
+    for (size_t i = 0; i < count; i++)
+    {
+        if (inputs[i].station < GAME_MAX_STATIONS && inputs[i].player >= players[inputs[i].station])
+        {
+            players[inputs[i].station] = inputs[i].player + 1;
+        }
+    }
+
+    for (int i = 0; i < GAME_MAX_STATIONS; i++)
+    {
+        configureStation(i, players[i], stations_[i].timeoutMs);
+    }
+}
+
+void GameEngine::press(int station, int player, bool answer, uint32_t timestampMs)
+{
+    // Ignore presses from unknown inputs and while the result plays
+    if (station < 0 || station >= GAME_MAX_STATIONS || player < 0 ||
+        player >= stations_[station].players || (playingMask_ & (1u << station)))
+    {
+        stats_.pressesIgnored++;
+        return;
+    }
+
+    Station& s = stations_[station];
+    uint32_t bit = 1u << player;
+    bool wasFirstPress = s.pressedMask == 0;
+    if (wasFirstPress)
+    {
+        s.firstPressMs = timestampMs;
+        waitingMask_ |= 1u << station;
+    }
+
+    // A player may change their answer until everyone has pressed
+    s.pressedMask |= bit;
+    s.yesMask = answer ? (s.yesMask | bit) : (s.yesMask & ~bit);
+    s.pressMs[player] = timestampMs;
+    stats_.presses++;
+    emit(GAME_EVENT_PRESS, station, timestampMs, player, answer);
+
+    if (s.pressedMask == s.fullMask)
+    {
+        decide(station, timestampMs);
+    }
+    else if (wasFirstPress)
+    {
+        emit(GAME_EVENT_LOCKED_IN, station, timestampMs, player, answer);
+    }
+}
+
+void GameEngine::update()
+{
+    if (clock_ && waitingMask_)
+    {
+        update(clock_(clockContext_));
+    }
+}
+
+void GameEngine::update(uint32_t nowMs)
+{
+    // Only stations with a round in progress
+    for (uint32_t pending = waitingMask_; pending; pending &= pending - 1)
+    {
+        int station = __builtin_ctz(pending);
+        Station& s = stations_[station];
+
+        // Signed: a press stamped just after the clock was read must not look like a 49-day wait
+        if (elapsedMs(s.firstPressMs, nowMs) > (int32_t)s.timeoutMs)
+        {
+            stats_.timeouts++;
+            finishRound(station, GAME_OUTCOME_TIMEOUT, nowMs, 0);
+        }
+    }
+}
+
+void GameEngine::soundFinished(int station)
+{
+    if (station >= 0 && station < GAME_MAX_STATIONS && (playingMask_ & (1u << station)))
+    {
+        reset(station);
+    }
+}
+
+void GameEngine::reset(int station)
+{
+    if (station < 0 || station >= GAME_MAX_STATIONS)
+    {
+        return;
+    }
+
+    Station& s = stations_[station];
+    s.pressedMask = 0;
+    s.yesMask = 0;
+    s.firstPressMs = 0;
+    waitingMask_ &= ~(1u << station);
+    playingMask_ &= ~(1u << station);
+    emit(GAME_EVENT_RESET, station, clock_ ? clock_(clockContext_) : 0);
+}
+
+void GameEngine::reset()
+{
+    for (int i = 0; i < GAME_MAX_STATIONS; i++)
+    {
+        if (stations_[i].players > 0)
+        {
+            reset(i);
+        }
+    }
+}
+
+GameState GameEngine::state(int station) const
+{
+    bool playing = station >= 0 && station < GAME_MAX_STATIONS && (playingMask_ & (1u << station));
+    return playing ? GAME_PLAYING_SOUND : GAME_WAITING_FOR_PLAYERS;
+}
+
+// ============================================================================
+// GameEngine - PRIVATE FUNCTIONS
+// ============================================================================
+
+void GameEngine::emit(GameEventType type, int station, uint32_t timeMs, int player, bool answer,
+                      GameOutcome outcome, uint32_t spreadMs, uint32_t pressedMask)
+{
+    if (!handler_)
+    {
+        return;
+    }
+
+    GameEvent event;
+    event.type = type;
+    event.station = station;
+    event.players = stations_[station].players;
+    event.timeMs = timeMs;
+    event.player = player;
+    event.answer = answer;
+    event.outcome = outcome;
+    event.spreadMs = spreadMs;
+    event.pressedMask = pressedMask;
+    handler_(event, handlerContext_);
+}
+
+void GameEngine::decide(int station, uint32_t timeMs)
+{
+    Station& s = stations_[station];
+    if (s.yesMask != s.fullMask)
+    {
+        finishRound(station, GAME_OUTCOME_NO, timeMs, 0);
+        return;
+    }
+
+    // Offsets from the first press keep the spread correct across rollover
+    int32_t earliest = 0;
+    int32_t latest = 0;
+    for (int i = 0; i < s.players; i++)
+    {
+        int32_t offset = elapsedMs(s.firstPressMs, s.pressMs[i]);
+        earliest = offset < earliest ? offset : earliest;
+        latest = offset > latest ? offset : latest;
+    }
+    uint32_t spreadMs = (uint32_t)(latest - earliest);
+
+    if (spreadMs <= s.timeoutMs)
+    {
+        stats_.yesRounds++;
+        finishRound(station, GAME_OUTCOME_YES, timeMs, spreadMs);
+    }
+    else
+    {
+        finishRound(station, GAME_OUTCOME_TOO_SLOW, timeMs, spreadMs);
+    }
+}
+
+void GameEngine::finishRound(int station, GameOutcome outcome, uint32_t timeMs, uint32_t spreadMs)
+{
+    waitingMask_ &= ~(1u << station);
+    playingMask_ |= 1u << station;
+    stats_.rounds++;
+    emit(GAME_EVENT_ROUND_COMPLETE, station, timeMs, -1, false, outcome, spreadMs,
+         stations_[station].pressedMask);
+}
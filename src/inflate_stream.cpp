@@ -0,0 +1,746 @@
+/**
+ * @file inflate_stream.cpp
+ *
+ * This file implements the streaming gzip decompressor. Input is staged in
+ * a small buffer; each decoding step (a block header, one literal or match)
+ * either completes from the buffered bits or rolls back to where it started
+ * and waits for the next write(), so no step ever sees a partial symbol.
+ * Huffman codes of up to 9 bits decode with one table lookup; longer ones
+ * fall back to a canonical bit-by-bit walk.
+ *
+ * @date 2025
+ */
+
+#include "inflate_stream.h"
+#include <stdlib.h>
+#include <string.h>
+#include <initializer_list>
+
+// ============================================================================
+// CONSTANTS AND CONFIGURATION
+// ============================================================================
+
+#define WINDOW_MASK (INFLATE_WINDOW_SIZE - 1)
+#define FAST_BITS 9
+
+#define GZIP_FLAG_HCRC 0x02
+#define GZIP_FLAG_EXTRA 0x04
+#define GZIP_FLAG_NAME 0x08
+#define GZIP_FLAG_COMMENT 0x10
+#define GZIP_FLAG_RESERVED 0xE0
+
+static const uint16_t lengthBase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t lengthExtra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t distanceBase[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t distanceExtra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+static const uint8_t codeLengthOrder[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static uint32_t crcTable[256];
+static bool crcTableReady = false;
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static void buildCrcTable()
+{
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+        {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        crcTable[i] = c;
+    }
+    crcTableReady = true;
+}
+
+static uint32_t updateCrc(uint32_t crc, const uint8_t* data, size_t length)
+{
+    while (length--)
+    {
+        crc = crcTable[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+// ============================================================================
+// CLASS IMPLEMENTATION
+// ============================================================================
+
+GzipInflater::GzipInflater()
+    : sink(nullptr), sinkContext(nullptr), window(nullptr), windowPos(0), windowFlushed(0),
+      inputLength(0), inputPos(0), bitBuffer(0), bitCount(0), state(STATE_ERROR), lastBlock(false),
+      storedRemaining(0), crc(0), inputTotal(0), outputTotal(0), errorText("not started")
+{
+}
+
+GzipInflater::~GzipInflater()
+{
+    end();
+}
+
+bool GzipInflater::begin(InflateSink outputSink, void* context)
+{
+    if (!crcTableReady)
+    {
+        buildCrcTable();
+    }
+    if (!window)
+    {
+        window = (uint8_t*)malloc(INFLATE_WINDOW_SIZE);
+    }
+
+    sink = outputSink;
+    sinkContext = context;
+    windowPos = 0;
+    windowFlushed = 0;
+    inputLength = 0;
+    inputPos = 0;
+    bitBuffer = 0;
+    bitCount = 0;
+    lastBlock = false;
+    storedRemaining = 0;
+    crc = 0xFFFFFFFFu;
+    inputTotal = 0;
+    outputTotal = 0;
+    errorText = nullptr;
+    state = STATE_HEADER;
+
+    if (!window)
+    {
+        fail("out of memory");
+        return false;
+    }
+    return true;
+}
+
+void GzipInflater::end()
+{
+    free(window);
+    window = nullptr;
+}
+
+InflateStatus GzipInflater::write(const uint8_t* data, size_t length)
+{
+    while (state != STATE_DONE && state != STATE_ERROR)
+    {
+        // Top up the staging buffer
+        size_t n = INFLATE_INPUT_BUFFER - inputLength;
+        if (n > length)
+        {
+            n = length;
+        }
+        memcpy(input + inputLength, data, n);
+        inputLength += n;
+        inputTotal += n;
+        data += n;
+        length -= n;
+
+        // Decode as far as the buffered input goes
+        Step step = STEP_OK;
+        while (step == STEP_OK && state != STATE_DONE && state != STATE_ERROR)
+        {
+            switch (state)
+            {
+            case STATE_HEADER:
+                step = decodeHeader();
+                break;
+            case STATE_BLOCK:
+                step = decodeBlockHeader();
+                break;
+            case STATE_STORED:
+                step = decodeStored();
+                break;
+            case STATE_CODES:
+                step = decodeCodes();
+                break;
+            case STATE_TRAILER:
+                step = decodeTrailer();
+                break;
+            default:
+                break;
+            }
+        }
+
+        // Keep only the bytes no step has consumed
+        memmove(input, input + inputPos, inputLength - inputPos);
+        inputLength -= inputPos;
+        inputPos = 0;
+
+        if (length == 0)
+        {
+            break;
+        }
+        if (inputLength == INFLATE_INPUT_BUFFER && state != STATE_DONE && state != STATE_ERROR)
+        {
+            fail("header larger than the input buffer");
+        }
+    }
+
+    // Hand out what this write produced rather than waiting for the window to fill
+    if (state != STATE_ERROR && !flushWindow())
+    {
+        fail("output refused");
+    }
+    return status();
+}
+
+// Load whole bytes until at least bits are buffered (at most 25)
+bool GzipInflater::fill(int bits)
+{
+    while (bitCount < bits)
+    {
+        if (inputPos >= inputLength)
+        {
+            return false;
+        }
+        bitBuffer |= (uint32_t)input[inputPos++] << bitCount;
+        bitCount += 8;
+    }
+    return true;
+}
+
+uint32_t GzipInflater::take(int bits)
+{
+    uint32_t value = bitBuffer & ((1u << bits) - 1);
+    bitBuffer >>= bits;
+    bitCount -= bits;
+    return value;
+}
+
+// Returns the symbol, -1 if more input is needed, -2 for an invalid code
+int GzipInflater::decodeSymbol(const InflateHuffman& huffman)
+{
+    while (bitCount <= 24 && inputPos < inputLength)
+    {
+        bitBuffer |= (uint32_t)input[inputPos++] << bitCount;
+        bitCount += 8;
+    }
+
+    uint16_t entry = huffman.fast[bitBuffer & ((1u << FAST_BITS) - 1)];
+    if (entry && (entry >> FAST_BITS) <= bitCount)
+    {
+        take(entry >> FAST_BITS);
+        return entry & ((1u << FAST_BITS) - 1);
+    }
+
+    // Canonical decode: codes of each length are consecutive integers
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (int len = 1; len <= 15; len++)
+    {
+        if (len > bitCount)
+        {
+            return -1;
+        }
+        code |= (bitBuffer >> (len - 1)) & 1;
+        int count = huffman.count[len];
+        if (code - count < first)
+        {
+            take(len);
+            return huffman.symbol[index + (code - first)];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    return -2;
+}
+
+bool GzipInflater::buildHuffman(InflateHuffman& huffman, const uint8_t* lengths, int count)
+{
+    memset(huffman.count, 0, sizeof(huffman.count));
+    for (int i = 0; i < count; i++)
+    {
+        huffman.count[lengths[i]]++;
+    }
+    huffman.count[0] = 0;
+
+    // Over-subscribed codes are invalid; incomplete ones are allowed (single distance codes)
+    int left = 1;
+    for (int len = 1; len <= 15; len++)
+    {
+        left <<= 1;
+        left -= huffman.count[len];
+        if (left < 0)
+        {
+            return false;
+        }
+    }
+
+    uint16_t offsets[16];
+    offsets[1] = 0;
+    for (int len = 1; len < 15; len++)
+    {
+        offsets[len + 1] = offsets[len] + huffman.count[len];
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (lengths[i])
+        {
+            huffman.symbol[offsets[lengths[i]]++] = (uint16_t)i;
+        }
+    }
+
+    // Codes arrive most significant bit first, so the table is indexed by the reversed code
+    memset(huffman.fast, 0, sizeof(huffman.fast));
+    uint32_t code = 0;
+    int index = 0;
+    for (int len = 1; len <= FAST_BITS; len++)
+    {
+        for (int k = 0; k < huffman.count[len]; k++, index++, code++)
+        {
+            uint32_t reversed = 0;
+            for (int b = 0; b < len; b++)
+            {
+                reversed |= ((code >> b) & 1) << (len - 1 - b);
+            }
+            for (uint32_t e = reversed; e < (1u << FAST_BITS); e += 1u << len)
+            {
+                huffman.fast[e] = (uint16_t)(len << FAST_BITS | huffman.symbol[index]);
+            }
+        }
+        code <<= 1;
+    }
+    return true;
+}
+
+inline void GzipInflater::put(uint8_t byte)
+{
+    window[windowPos++] = byte;
+    if (windowPos == INFLATE_WINDOW_SIZE)
+    {
+        if (!flushWindow())
+        {
+            state = STATE_ERROR;
+            errorText = "output refused";
+        }
+        windowPos = 0;
+        windowFlushed = 0;
+    }
+}
+
+bool GzipInflater::flushWindow()
+{
+    size_t length = windowPos - windowFlushed;
+    if (length == 0)
+    {
+        return true;
+    }
+
+    const uint8_t* run = window + windowFlushed;
+    crc = updateCrc(crc, run, length);
+    outputTotal += length;
+    windowFlushed = windowPos;
+    return sink(run, length, sinkContext);
+}
+
+GzipInflater::Step GzipInflater::fail(const char* text)
+{
+    state = STATE_ERROR;
+    errorText = text;
+    return STEP_FAIL;
+}
+
+GzipInflater::Step GzipInflater::decodeHeader()
+{
+    const uint8_t* p = input + inputPos;
+    size_t available = inputLength - inputPos;
+    if (available < 10)
+    {
+        return STEP_NEED_INPUT;
+    }
+    if (p[0] != 0x1F || p[1] != 0x8B)
+    {
+        return fail("not a gzip stream");
+    }
+    if (p[2] != 8)
+    {
+        return fail("not deflate");
+    }
+
+    uint8_t flags = p[3];
+    if (flags & GZIP_FLAG_RESERVED)
+    {
+        return fail("reserved gzip flags");
+    }
+
+    size_t pos = 10;
+    if (flags & GZIP_FLAG_EXTRA)
+    {
+        if (available < pos + 2)
+        {
+            return STEP_NEED_INPUT;
+        }
+        pos += 2 + (p[pos] | p[pos + 1] << 8);
+    }
+    for (uint8_t flag : {GZIP_FLAG_NAME, GZIP_FLAG_COMMENT})
+    {
+        if (flags & flag)
+        {
+            while (pos < available && p[pos] != 0)
+            {
+                pos++;
+            }
+            pos++; // Terminator
+        }
+    }
+    if (flags & GZIP_FLAG_HCRC)
+    {
+        pos += 2;
+    }
+    if (pos > available)
+    {
+        return STEP_NEED_INPUT;
+    }
+
+    inputPos += pos;
+    state = STATE_BLOCK;
+    return STEP_OK;
+}
+
+GzipInflater::Step GzipInflater::decodeBlockHeader()
+{
+    size_t savedPos = inputPos;
+    uint32_t savedBits = bitBuffer;
+    int savedCount = bitCount;
+#define NEED_INPUT()                \
+    do                              \
+    {                               \
+        inputPos = savedPos;        \
+        bitBuffer = savedBits;      \
+        bitCount = savedCount;      \
+        return STEP_NEED_INPUT;     \
+    } while (0)
+
+    if (!fill(3))
+    {
+        NEED_INPUT();
+    }
+    lastBlock = take(1);
+    uint32_t type = take(2);
+
+    if (type == 0)
+    {
+        take(bitCount & 7); // Stored blocks start on a byte boundary
+        if (!fill(32))
+        {
+            NEED_INPUT();
+        }
+        uint32_t length = take(16);
+        uint32_t complement = take(16);
+        if (length != (~complement & 0xFFFF))
+        {
+            return fail("bad stored block length");
+        }
+        storedRemaining = length;
+        state = STATE_STORED;
+        return STEP_OK;
+    }
+
+    uint8_t lengths[286 + 30];
+    if (type == 1)
+    {
+        // Fixed codes
+        memset(lengths, 8, 144);
+        memset(lengths + 144, 9, 112);
+        memset(lengths + 256, 7, 24);
+        memset(lengths + 280, 8, 8);
+        buildHuffman(lengthCode, lengths, 288);
+        memset(lengths, 5, 30);
+        buildHuffman(distanceCode, lengths, 30);
+        state = STATE_CODES;
+        return STEP_OK;
+    }
+    if (type != 2)
+    {
+        return fail("invalid block type");
+    }
+
+    // Dynamic codes, themselves sent with a code length code (built in distanceCode for now)
+    if (!fill(14))
+    {
+        NEED_INPUT();
+    }
+    int literalCount = take(5) + 257;
+    int distanceCount = take(5) + 1;
+    int codeLengthCount = take(4) + 4;
+    if (literalCount > 286 || distanceCount > 30)
+    {
+        return fail("bad code counts");
+    }
+
+    uint8_t codeLengths[19] = {0};
+    for (int i = 0; i < codeLengthCount; i++)
+    {
+        if (!fill(3))
+        {
+            NEED_INPUT();
+        }
+        codeLengths[codeLengthOrder[i]] = take(3);
+    }
+    if (!buildHuffman(distanceCode, codeLengths, 19))
+    {
+        return fail("bad code length code");
+    }
+
+    int total = literalCount + distanceCount;
+    int n = 0;
+    while (n < total)
+    {
+        int symbol = decodeSymbol(distanceCode);
+        if (symbol == -1)
+        {
+            NEED_INPUT();
+        }
+        if (symbol < 0)
+        {
+            return fail("bad code length");
+        }
+        if (symbol < 16)
+        {
+            lengths[n++] = symbol;
+            continue;
+        }
+
+        uint8_t value = 0;
+        int repeat;
+        if (symbol == 16)
+        {
+            if (n == 0)
+            {
+                return fail("repeat with no previous length");
+            }
+            if (!fill(2))
+            {
+                NEED_INPUT();
+            }
+            value = lengths[n - 1];
+            repeat = 3 + take(2);
+        }
+        else if (symbol == 17)
+        {
+            if (!fill(3))
+            {
+                NEED_INPUT();
+            }
+            repeat = 3 + take(3);
+        }
+        else
+        {
+            if (!fill(7))
+            {
+                NEED_INPUT();
+            }
+            repeat = 11 + take(7);
+        }
+        if (n + repeat > total)
+        {
+            return fail("too many code lengths");
+        }
+        memset(lengths + n, value, repeat);
+        n += repeat;
+    }
+#undef NEED_INPUT
+
+    if (lengths[256] == 0)
+    {
+        return fail("no end-of-block code");
+    }
+    if (!buildHuffman(lengthCode, lengths, literalCount) ||
+        !buildHuffman(distanceCode, lengths + literalCount, distanceCount))
+    {
+        return fail("bad literal/length or distance code");
+    }
+    state = STATE_CODES;
+    return STEP_OK;
+}
+
+GzipInflater::Step GzipInflater::decodeStored()
+{
+    // Whole bytes already pulled into the bit buffer come first
+    while (storedRemaining && bitCount >= 8)
+    {
+        put((uint8_t)take(8));
+        storedRemaining--;
+    }
+
+    while (storedRemaining && inputPos < inputLength)
+    {
+        size_t n = inputLength - inputPos;
+        if (n > storedRemaining)
+        {
+            n = storedRemaining;
+        }
+        if (n > INFLATE_WINDOW_SIZE - windowPos)
+        {
+            n = INFLATE_WINDOW_SIZE - windowPos;
+        }
+        memcpy(window + windowPos, input + inputPos, n);
+        inputPos += n;
+        storedRemaining -= n;
+        windowPos += n;
+        if (windowPos == INFLATE_WINDOW_SIZE)
+        {
+            if (!flushWindow())
+            {
+                return fail("output refused");
+            }
+            windowPos = 0;
+            windowFlushed = 0;
+        }
+    }
+
+    if (storedRemaining)
+    {
+        return STEP_NEED_INPUT;
+    }
+    state = lastBlock ? STATE_TRAILER : STATE_BLOCK;
+    return STEP_OK;
+}
+
+GzipInflater::Step GzipInflater::decodeCodes()
+{
+    for (;;)
+    {
+        size_t savedPos = inputPos;
+        uint32_t savedBits = bitBuffer;
+        int savedCount = bitCount;
+
+        int symbol = decodeSymbol(lengthCode);
+        if (symbol == -2)
+        {
+            return fail("bad literal/length code");
+        }
+        if (symbol < 256 && symbol >= 0)
+        {
+            put((uint8_t)symbol);
+            if (state == STATE_ERROR)
+            {
+                return STEP_FAIL;
+            }
+            continue;
+        }
+        if (symbol == 256)
+        {
+            state = lastBlock ? STATE_TRAILER : STATE_BLOCK;
+            return STEP_OK;
+        }
+
+        if (symbol > 256)
+        {
+            symbol -= 257;
+        }
+        if (symbol >= 29)
+        {
+            return fail("bad length code");
+        }
+        if (symbol < 0 || !fill(lengthExtra[symbol]))
+        {
+            symbol = -1;
+        }
+        else
+        {
+            uint32_t length = lengthBase[symbol] + take(lengthExtra[symbol]);
+            int distanceSymbol = decodeSymbol(distanceCode);
+            if (distanceSymbol >= 30)
+            {
+                return fail("bad distance code");
+            }
+            if (distanceSymbol >= 0 && fill(distanceExtra[distanceSymbol]))
+            {
+                uint32_t distance = distanceBase[distanceSymbol] + take(distanceExtra[distanceSymbol]);
+                if (distance > outputTotal + (windowPos - windowFlushed))
+                {
+                    return fail("distance too far back");
+                }
+
+                uint32_t from = (windowPos - distance) & WINDOW_MASK;
+                while (length--)
+                {
+                    put(window[from]);
+                    from = (from + 1) & WINDOW_MASK;
+                }
+                if (state == STATE_ERROR)
+                {
+                    return STEP_FAIL;
+                }
+                continue;
+            }
+            symbol = distanceSymbol == -2 ? -2 : -1;
+        }
+
+        if (symbol == -1)
+        {
+            // Ran out of input inside this symbol: resume from its start next time
+            inputPos = savedPos;
+            bitBuffer = savedBits;
+            bitCount = savedCount;
+            return STEP_NEED_INPUT;
+        }
+        return fail("bad distance code");
+    }
+}
+
+GzipInflater::Step GzipInflater::decodeTrailer()
+{
+    take(bitCount & 7);
+
+    uint8_t trailer[8];
+    size_t savedPos = inputPos;
+    uint32_t savedBits = bitBuffer;
+    int savedCount = bitCount;
+    for (int i = 0; i < 8; i++)
+    {
+        if (bitCount >= 8)
+        {
+            trailer[i] = (uint8_t)take(8);
+        }
+        else if (inputPos < inputLength)
+        {
+            trailer[i] = input[inputPos++];
+        }
+        else
+        {
+            inputPos = savedPos;
+            bitBuffer = savedBits;
+            bitCount = savedCount;
+            return STEP_NEED_INPUT;
+        }
+    }
+
+    if (!flushWindow())
+    {
+        return fail("output refused");
+    }
+    uint32_t expectedCrc = trailer[0] | trailer[1] << 8 | trailer[2] << 16 | (uint32_t)trailer[3] << 24;
+    uint32_t expectedSize = trailer[4] | trailer[5] << 8 | trailer[6] << 16 | (uint32_t)trailer[7] << 24;
+    if ((crc ^ 0xFFFFFFFFu) != expectedCrc)
+    {
+        return fail("CRC mismatch");
+    }
+    if (outputTotal != expectedSize)
+    {
+        return fail("length mismatch");
+    }
+
+    state = STATE_DONE;
+    return STEP_OK;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file log_sink.cpp
+ *
+ * This file implements the SD log sink task: cursor-based reading of the
+ * Logger ring, batched appends and size-based rotation.
+ *
+ * @date 2025
+ */
+
+#define LOG_MODULE LOG_MODULE_SINK
+#include "log_sink.h"
+#include "logging.h"
+#include <FS.h>
+#include <esp_timer.h>
+
+static_assert(LOG_SINK_MAX_FILES >= 1, "LOG_SINK_MAX_FILES must keep the current file");
+
+#define WRITE_RETRY_MS 5000
+#define LOG_SINK_PATH_LENGTH 32
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static TaskHandle_t sinkTaskHandle = nullptr;
+static volatile bool flushRequested = false;
+static LogSinkStats stats = {};
+
+// Only the sink task touches the state below
+static char batch[LOG_SINK_BATCH_BYTES];
+static size_t batchLength = 0;
+static uint32_t batchRecords = 0;
+static unsigned long batchStartTime = 0;
+static uint32_t cursor = 0;                 // Sequence of the last record read from the ring
+static File file;
+static size_t fileSize = 0;
+static unsigned long lastFailedWrite = 0;
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static void rotatedPath(char* path, int index)
+{
+    snprintf(path, LOG_SINK_PATH_LENGTH, "%s.%d", LOG_SINK_FILE, index);
+}
+
+/**
+ * @brief Shift LOG_SINK_FILE to .1, .1 to .2, ... and drop the oldest
+ */
+static void rotate()
+{
+    char from[LOG_SINK_PATH_LENGTH];
+    char to[LOG_SINK_PATH_LENGTH];
+
+    file.close();
+    if (LOG_SINK_MAX_FILES == 1)
+    {
+        LOG_SINK_FS.remove(LOG_SINK_FILE);
+    }
+    else
+    {
+        rotatedPath(to, LOG_SINK_MAX_FILES - 1);
+        LOG_SINK_FS.remove(to);
+        for (int i = LOG_SINK_MAX_FILES - 2; i >= 1; i--)
+        {
+            rotatedPath(from, i);
+            rotatedPath(to, i + 1);
+            LOG_SINK_FS.rename(from, to);
+        }
+        rotatedPath(to, 1);
+        LOG_SINK_FS.rename(LOG_SINK_FILE, to);
+    }
+    fileSize = 0;
+    stats.rotations++;
+}
+
+/**
+ * @brief Append the batch to the current file in one write
+ *
+ * A batch that cannot be written is discarded and counted as dropped;
+ * retrying would only let the ring overwrite newer records instead.
+ */
+static void writeBatch()
+{
+    if (batchLength == 0)
+    {
+        return;
+    }
+
+    bool ok = false;
+    if (lastFailedWrite == 0 || millis() - lastFailedWrite >= WRITE_RETRY_MS)
+    {
+        if (file && fileSize + batchLength > LOG_SINK_MAX_FILE_BYTES)
+        {
+            rotate();
+        }
+        if (!file)
+        {
+            file = LOG_SINK_FS.open(LOG_SINK_FILE, FILE_APPEND);
+            fileSize = file ? file.size() : 0;
+        }
+
+        int64_t start = esp_timer_get_time();
+        ok = file && file.write((const uint8_t*)batch, batchLength) == batchLength;
+        if (ok)
+        {
+            file.flush();
+        }
+        uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start);
+
+        stats.writes++;
+        stats.lastWriteUs = elapsed;
+        stats.maxWriteUs = max(stats.maxWriteUs, elapsed);
+    }
+
+    if (ok)
+    {
+        fileSize += batchLength;
+        stats.bytes += batchLength;
+        stats.records += batchRecords;
+        lastFailedWrite = 0;
+    }
+    else
+    {
+        if (lastFailedWrite == 0)
+        {
+            // Logged once per failure streak; the line itself ends up in the next batch
+            LOG_WARN("⚠️ Log sink cannot write %s\n", LOG_SINK_FILE);
+            stats.writeErrors++;
+            lastFailedWrite = millis();
+        }
+        file.close();
+        stats.dropped += batchRecords;
+    }
+
+    batchLength = 0;
+    batchRecords = 0;
+}
+
+static void appendText(const char* text, size_t length)
+{
+    if (batchLength + length > sizeof(batch))
+    {
+        writeBatch();
+    }
+    if (batchLength == 0)
+    {
+        batchStartTime = millis();
+    }
+    memcpy(batch + batchLength, text, length);
+    batchLength += length;
+}
+
+static void appendRecordLine(const LogRecord& record, void* context)
+{
+    char line[MAX_LOG_MESSAGE_LENGTH + 48];
+    int length;
+
+    if (record.sequence != cursor + 1)
+    {
+        // The ring wrapped before we got here
+        uint32_t lost = record.sequence - cursor - 1;
+        stats.dropped += lost;
+        length = snprintf(line, sizeof(line), "----- %lu records dropped -----\n", (unsigned long)lost);
+        appendText(line, length);
+    }
+
+    length = snprintf(line, sizeof(line), "%10lu %-5s %-8s %s\n", (unsigned long)record.timestampMs,
+                      LoggerClass::levelName(record.level), LoggerClass::moduleName(record.module),
+                      record.message);
+    appendText(line, min(length, (int)sizeof(line) - 1));
+    batchRecords++;
+    cursor = record.sequence;
+}
+
+static void logSinkTask(void* parameter)
+{
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOG_SINK_POLL_MS));
+
+        Logger.forEachRecordSince(cursor, appendRecordLine, nullptr);
+
+        if (batchLength > 0 && (flushRequested || millis() - batchStartTime >= LOG_SINK_FLUSH_MS))
+        {
+            writeBatch();
+        }
+        flushRequested = false;
+    }
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+bool initLogSink()
+{
+    if (sinkTaskHandle)
+    {
+        return true;
+    }
+
+    // Records logged before the sink started are still in the ring and get written first
+    const char marker[] = "===== boot =====\n";
+    appendText(marker, sizeof(marker) - 1);
+
+    if (xTaskCreatePinnedToCore(logSinkTask, "logSink", LOG_SINK_TASK_STACK, nullptr,
+                                LOG_SINK_TASK_PRIORITY, &sinkTaskHandle, LOG_SINK_TASK_CORE) != pdPASS)
+    {
+        LOG_ERROR("❌ Failed to start the log sink task");
+        return false;
+    }
+    Logger.setReaderTask(sinkTaskHandle);
+
+    LOG_INFO("💾 Log sink writing to %s (%lu bytes x %d files)\n", LOG_SINK_FILE,
+             (unsigned long)LOG_SINK_MAX_FILE_BYTES, LOG_SINK_MAX_FILES);
+    return true;
+}
+
+void flushLogSink()
+{
+    if (sinkTaskHandle)
+    {
+        flushRequested = true;
+        xTaskNotifyGive(sinkTaskHandle);
+    }
+}
+
+LogSinkStats getLogSinkStats()
+{
+    return stats;
+}
@@ -1,56 +1,139 @@
 #include "logging.h"
 #include <Arduino.h>
+#include <stdarg.h>
 
 // Global logger instance
 LoggerClass Logger;
 
-LoggerClass::LoggerClass() : serialPrint(nullptr), logIndex(0), logCount(0), bufferPos(0) {
-    messageBuffer[0] = '\0';
+LogLevel logModuleLevels[LOG_MODULE_COUNT] = {
+    LOG_COMPILE_LEVEL, LOG_COMPILE_LEVEL, LOG_COMPILE_LEVEL, LOG_COMPILE_LEVEL,
+    LOG_COMPILE_LEVEL, LOG_COMPILE_LEVEL, LOG_COMPILE_LEVEL, LOG_COMPILE_LEVEL,
+    LOG_COMPILE_LEVEL
+};
+
+static const char* const moduleNames[LOG_MODULE_COUNT] = {
+    "main", "audio", "mixer", "files", "wifi", "settings", "input", "history", "sink"
+};
+
+static const char* const levelNames[] = {"NONE", "ERROR", "WARN", "INFO", "DEBUG"};
+
+static_assert(LOG_MODULE_COUNT == 9, "Update logModuleLevels and moduleNames");
+static_assert((LOG_RING_BYTES & (LOG_RING_BYTES - 1)) == 0, "LOG_RING_BYTES must be a power of two");
+
+// Guards the ring and line buffer ownership; producers may run on either core
+static portMUX_TYPE logMux = portMUX_INITIALIZER_UNLOCKED;
+
+struct __attribute__((packed)) LogRecordHeader {
+    uint16_t length;
+    uint8_t level;
+    uint8_t module;
+    uint32_t timestampMs;
+    uint32_t sequence;
+};
+
+#define LOG_RECORD_OVERHEAD (sizeof(LogRecordHeader) + sizeof(uint16_t))
+
+LoggerClass::LoggerClass()
+    : serialPrint(nullptr), head(0), tail(0), logCount(0), totalRecords(0), truncatedRecords(0),
+      readerTask(nullptr), readerWakeHead(0) {
+    memset(lineBuffers, 0, sizeof(lineBuffers));
 }
 
 void LoggerClass::addLogger(Print& print) {
     serialPrint = &print;
 }
 
-size_t LoggerClass::write(uint8_t byte) {
-    // Write to serial/print object (if available)
-    size_t result = 0;
-    if (serialPrint) {
-        result = serialPrint->write(byte);
-    }
-    
-    // Buffer the character for log messages
-    if (bufferPos < MAX_LOG_MESSAGE_LENGTH - 1) {
-        messageBuffer[bufferPos++] = byte;
-        messageBuffer[bufferPos] = '\0';
-        
-        // If we hit a newline, add the message to log buffer
-        if (byte == '\n' || byte == '\r') {
-            if (bufferPos > 1) { // Only if there's actual content (more than just the newline)
-                // Remove the newline from the buffer
-                messageBuffer[bufferPos - 1] = '\0';
-                
-                // Add timestamped message to log buffer
-                String timestampedMessage = String(millis()) + "ms: " + String(messageBuffer);
-                addMessageToBuffer(timestampedMessage);
-            }
-            
-            // Reset buffer
-            bufferPos = 0;
-            messageBuffer[0] = '\0';
+void LoggerClass::copyToRing(uint32_t pos, const void* src, size_t length) {
+    size_t offset = pos & (LOG_RING_BYTES - 1);
+    size_t first = min(length, (size_t)LOG_RING_BYTES - offset);
+    memcpy(ring + offset, src, first);
+    memcpy(ring, (const uint8_t*)src + first, length - first);
+}
+
+void LoggerClass::copyFromRing(uint32_t pos, void* dst, size_t length) const {
+    size_t offset = pos & (LOG_RING_BYTES - 1);
+    size_t first = min(length, (size_t)LOG_RING_BYTES - offset);
+    memcpy(dst, ring + offset, first);
+    memcpy((uint8_t*)dst + first, ring, length - first);
+}
+
+// Drop a multi-byte UTF-8 character cut off at the end so truncated lines stay valid text
+static size_t trimPartialUtf8(const char* text, size_t length) {
+    size_t lead = length;
+    while (lead > 0 && length - lead < 4 && ((uint8_t)text[lead - 1] & 0xC0) == 0x80) {
+        lead--;
+    }
+    if (lead == 0) {
+        return length;
+    }
+    uint8_t c = (uint8_t)text[lead - 1];
+    size_t needed = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+    return length - (lead - 1) < needed ? lead - 1 : length;
+}
+
+void LoggerClass::appendRecord(LogModule module, LogLevel level, const char* message, size_t length) {
+    if (length >= MAX_LOG_MESSAGE_LENGTH) {
+        length = trimPartialUtf8(message, MAX_LOG_MESSAGE_LENGTH - 1);
+        truncatedRecords++;
+    }
+
+    LogRecordHeader header;
+    header.length = (uint16_t)length;
+    header.level = level;
+    header.module = module;
+    header.timestampMs = millis();
+    uint16_t footer = header.length;
+    uint32_t size = LOG_RECORD_OVERHEAD + length;
+
+    portENTER_CRITICAL(&logMux);
+    // Evict the oldest records until the new one fits
+    while (LOG_RING_BYTES - (head - tail) < size) {
+        uint16_t oldLength;
+        copyFromRing(tail, &oldLength, sizeof(oldLength));
+        tail += LOG_RECORD_OVERHEAD + oldLength;
+        logCount--;
+    }
+    header.sequence = totalRecords + 1;
+    copyToRing(head, &header, sizeof(header));
+    copyToRing(head + sizeof(header), message, length);
+    copyToRing(head + sizeof(header) + length, &footer, sizeof(footer));
+    head += size;
+    logCount++;
+    totalRecords++;
+    bool wakeReader = readerTask && head - readerWakeHead >= LOG_RING_BYTES / 4;
+    if (wakeReader) {
+        readerWakeHead = head;
+    }
+    portEXIT_CRITICAL(&logMux);
+
+    if (wakeReader) {
+        xTaskNotifyGive(readerTask);
+    }
+}
+
+LoggerClass::LineBuffer* LoggerClass::lineBufferForCurrentTask() {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    LineBuffer* found = nullptr;
+
+    portENTER_CRITICAL(&logMux);
+    for (int i = 0; i < LOG_LINE_BUFFERS && !found; i++) {
+        if (lineBuffers[i].owner == self) {
+            found = &lineBuffers[i];
         }
-    } else {
-        // Buffer full, add what we have and reset
-        String timestampedMessage = String(millis()) + "ms: " + String(messageBuffer);
-        addMessageToBuffer(timestampedMessage);
-        
-        // Reset buffer and add current byte
-        bufferPos = 0;
-        messageBuffer[bufferPos++] = byte;
-        messageBuffer[bufferPos] = '\0';
-    }
-    
-    return result;
+    }
+    for (int i = 0; i < LOG_LINE_BUFFERS && !found; i++) {
+        if (lineBuffers[i].owner == nullptr) {
+            found = &lineBuffers[i];
+            found->owner = self;
+            found->length = 0;
+        }
+    }
+    portEXIT_CRITICAL(&logMux);
+    return found;
+}
+
+size_t LoggerClass::write(uint8_t byte) {
+    return write(&byte, 1);
 }
 
 size_t LoggerClass::write(const uint8_t* buffer, size_t size) {
@@ -58,112 +141,254 @@ size_t LoggerClass::write(const uint8_t* buffer, size_t size) {
     if (serialPrint) {
         result = serialPrint->write(buffer, size);
     }
-    
-    // Process each byte for log buffer (without calling serial again)
+
+    LineBuffer* line = lineBufferForCurrentTask();
+    if (!line) {
+        // Every line buffer is busy: store this fragment as its own record
+        size_t length = size;
+        while (length > 0 && (buffer[length - 1] == '\n' || buffer[length - 1] == '\r')) {
+            length--;
+        }
+        if (length > 0) {
+            appendRecord(LOG_MODULE_MAIN, LOG_LEVEL_INFO, (const char*)buffer, length);
+        }
+        return result;
+    }
+
+    // Only this task touches its line buffer, so no lock is needed while filling it
     for (size_t i = 0; i < size; i++) {
         uint8_t byte = buffer[i];
-        
-        // Buffer the character for log messages
-        if (bufferPos < MAX_LOG_MESSAGE_LENGTH - 1) {
-            messageBuffer[bufferPos++] = byte;
-            messageBuffer[bufferPos] = '\0';
-            
-            // If we hit a newline, add the message to log buffer
-            if (byte == '\n' || byte == '\r') {
-                if (bufferPos > 1) { // Only if there's actual content (more than just the newline)
-                    // Remove the newline from the buffer
-                    messageBuffer[bufferPos - 1] = '\0';
-                    
-                    // Add timestamped message to log buffer
-                    String timestampedMessage = String(millis()) + "ms: " + String(messageBuffer);
-                    addMessageToBuffer(timestampedMessage);
-                }
-                
-                // Reset buffer
-                bufferPos = 0;
-                messageBuffer[0] = '\0';
+        if (byte == '\n' || byte == '\r') {
+            if (line->length > 0) {
+                appendRecord(LOG_MODULE_MAIN, LOG_LEVEL_INFO, line->data, line->length);
+                line->length = 0;
             }
         } else {
-            // Buffer full, add what we have and reset
-            String timestampedMessage = String(millis()) + "ms: " + String(messageBuffer);
-            addMessageToBuffer(timestampedMessage);
-            
-            // Reset buffer and add current byte
-            bufferPos = 0;
-            messageBuffer[bufferPos++] = byte;
-            messageBuffer[bufferPos] = '\0';
+            if (line->length >= MAX_LOG_MESSAGE_LENGTH - 1) {
+                // Line too long: store what we have and continue in a new record
+                appendRecord(LOG_MODULE_MAIN, LOG_LEVEL_INFO, line->data, line->length);
+                line->length = 0;
+            }
+            line->data[line->length++] = (char)byte;
         }
     }
-    
+
+    // Release the buffer once the line is complete
+    if (line->length == 0) {
+        line->owner = nullptr;
+    }
     return result;
 }
 
-void LoggerClass::addMessageToBuffer(const String& message) {
-    // Add to circular buffer
-    logBuffer[logIndex] = message;
-    logIndex = (logIndex + 1) % LOG_BUFFER_SIZE;
-    
-    if (logCount < LOG_BUFFER_SIZE) {
-        logCount++;
-    }
-}
-
-String LoggerClass::getLogsAsHtml() {
-    String html = R"(
-<!DOCTYPE html><html><head><title>System Logs</title>
-<meta name="viewport" content="width=device-width,initial-scale=1">
-<meta http-equiv="refresh" content="5">
-<style>
-body{font-family:monospace;margin:10px;background:#000;color:#0f0}
-.header{background:#333;color:#fff;padding:10px;margin-bottom:10px;border-radius:3px}
-.log{background:#111;padding:5px;margin:2px 0;border-left:3px solid #0f0;font-size:12px;word-wrap:break-word}
-.nav{background:#444;padding:10px;margin-bottom:10px;text-align:center}
-.nav a{color:#0ff;text-decoration:none;margin:0 10px}
-.stats{background:#222;color:#fff;padding:5px;margin:5px 0;font-size:11px}
-</style></head><body>
-<div class="header"><h2>📱 System Logs</h2></div>
-<div class="nav">
-<a href="/">🏠 Home</a> | <a href="/logs">🔄 Refresh</a>
-</div>
-<div class="stats">Total Messages: )";
-
-    html += String(logCount);
-    html += " | Buffer: " + String(LOG_BUFFER_SIZE) + " | Free RAM: " + String(ESP.getFreeHeap()) + " bytes</div>";
-    
-    // Add log messages (newest first)
-    if (logCount > 0) {
-        int start = logCount < LOG_BUFFER_SIZE ? 0 : logIndex;
-        for (int i = 0; i < logCount; i++) {
-            int idx = (start + logCount - 1 - i) % LOG_BUFFER_SIZE;
-            html += "<div class='log'>" + logBuffer[idx] + "</div>";
+void LoggerClass::log(LogModule module, LogLevel level, const char* format, ...) {
+    char message[MAX_LOG_MESSAGE_LENGTH];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    if (length < 0) {
+        return;
+    }
+    if (length >= (int)sizeof(message)) {
+        length = trimPartialUtf8(message, sizeof(message) - 1);
+    }
+    while (length > 0 && (message[length - 1] == '\n' || message[length - 1] == '\r')) {
+        length--;
+    }
+
+    if (serialPrint) {
+        serialPrint->write((const uint8_t*)message, length);
+        serialPrint->write((const uint8_t*)"\r\n", 2);
+    }
+    appendRecord(module, level, message, length);
+}
+
+void LoggerClass::setModuleLevel(LogModule module, LogLevel level) {
+    if (module < LOG_MODULE_COUNT) {
+        // Levels above LOG_COMPILE_LEVEL were compiled out and cannot be enabled
+        logModuleLevels[module] = min(level, (LogLevel)LOG_COMPILE_LEVEL);
+    }
+}
+
+bool LoggerClass::setModuleLevel(const char* name, LogLevel level) {
+    for (int i = 0; i < LOG_MODULE_COUNT; i++) {
+        if (strcmp(name, moduleNames[i]) == 0) {
+            setModuleLevel((LogModule)i, level);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* LoggerClass::moduleName(LogModule module) {
+    return module < LOG_MODULE_COUNT ? moduleNames[module] : "?";
+}
+
+const char* LoggerClass::levelName(LogLevel level) {
+    return level <= LOG_LEVEL_DEBUG ? levelNames[level] : "?";
+}
+
+void LoggerClass::forEachRecord(LogRecordVisitor visitor, void* context, bool newestFirst) {
+    portENTER_CRITICAL(&logMux);
+    uint32_t pos = newestFirst ? head : tail;
+    uint32_t end = head; // Records logged while visiting are not visited
+    portEXIT_CRITICAL(&logMux);
+
+    visitRecords(pos, end, newestFirst, visitor, context, UINT32_MAX);
+}
+
+void LoggerClass::forEachRecordSince(uint32_t sequence, LogRecordVisitor visitor, void* context, uint32_t limit) {
+    portENTER_CRITICAL(&logMux);
+    uint32_t end = head;
+    uint32_t pos = tail;
+    uint32_t newer = totalRecords - sequence;
+    if (newer < (uint32_t)logCount) {
+        // Walk back from the newest record over the length footers; only the
+        // requested records are touched, however full the ring is
+        pos = head;
+        for (uint32_t i = 0; i < newer; i++) {
+            uint16_t length;
+            copyFromRing(pos - sizeof(uint16_t), &length, sizeof(length));
+            pos -= LOG_RECORD_OVERHEAD + length;
+        }
+    }
+    portEXIT_CRITICAL(&logMux);
+
+    visitRecords(pos, end, false, visitor, context, limit);
+}
+
+void LoggerClass::visitRecords(uint32_t pos, uint32_t end, bool newestFirst, LogRecordVisitor visitor, void* context,
+                               uint32_t limit) {
+    LogRecord record;
+    LogRecordHeader header;
+
+    for (; limit > 0; limit--) {
+        portENTER_CRITICAL(&logMux);
+        if (newestFirst) {
+            // Stop at the oldest record, or once older records have been overwritten
+            if ((int32_t)(pos - LOG_RECORD_OVERHEAD - tail) < 0) {
+                portEXIT_CRITICAL(&logMux);
+                break;
+            }
+            uint16_t length;
+            copyFromRing(pos - sizeof(uint16_t), &length, sizeof(length));
+            pos -= LOG_RECORD_OVERHEAD + length;
+            if ((int32_t)(pos - tail) < 0) {
+                portEXIT_CRITICAL(&logMux);
+                break;
+            }
+        } else {
+            // Skip ahead if the record was overwritten while we were visiting
+            if ((int32_t)(pos - tail) < 0) {
+                pos = tail;
+            }
+            if (pos == end || (int32_t)(pos - end) > 0) {
+                portEXIT_CRITICAL(&logMux);
+                break;
+            }
+        }
+        copyFromRing(pos, &header, sizeof(header));
+        copyFromRing(pos + sizeof(header), record.message, header.length);
+        uint32_t next = pos + LOG_RECORD_OVERHEAD + header.length;
+        portEXIT_CRITICAL(&logMux);
+
+        record.sequence = header.sequence;
+        record.timestampMs = header.timestampMs;
+        record.level = header.level;
+        record.module = (LogModule)header.module;
+        record.length = header.length;
+        record.message[header.length] = '\0';
+        visitor(record, context);
+
+        if (!newestFirst) {
+            pos = next;
+        }
+    }
+}
+
+// Write text as the contents of a JSON string; safe runs go out in one write
+void writeJsonEscaped(Print& out, const char* text, size_t length) {
+    size_t runStart = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t c = (uint8_t)text[i];
+        const char* replacement = nullptr;
+        char hex[7];
+        if (c == '"') replacement = "\\\"";
+        else if (c == '\\') replacement = "\\\\";
+        else if (c == '\n') replacement = "\\n";
+        else if (c == '\r') replacement = "\\r";
+        else if (c == '\t') replacement = "\\t";
+        else if (c < 0x20) {
+            snprintf(hex, sizeof(hex), "\\u%04x", c);
+            replacement = hex;
         }
-    } else {
-        html += "<div class='log'>No log messages yet...</div>";
-    }
-    
-    html += "</body></html>";
-    return html;
-}
-
-String LoggerClass::getLogsAsJson() {
-    String json = "{\"logs\":[";
-    
-    if (logCount > 0) {
-        int start = logCount < LOG_BUFFER_SIZE ? 0 : logIndex;
-        for (int i = 0; i < logCount; i++) {
-            int idx = (start + logCount - 1 - i) % LOG_BUFFER_SIZE;
-            if (i > 0) json += ",";
-            json += "\"" + logBuffer[idx] + "\"";
+        if (replacement) {
+            out.write((const uint8_t*)text + runStart, i - runStart);
+            out.print(replacement);
+            runStart = i + 1;
         }
     }
-    
-    json += "],\"count\":" + String(logCount) + ",\"freeRam\":" + String(ESP.getFreeHeap()) + "}";
-    return json;
+    out.write((const uint8_t*)text + runStart, length - runStart);
+}
+
+void LoggerClass::beginLogsJson(LogJsonCursor& cursor, uint32_t since) {
+    cursor.since = since;
+    cursor.last = since;
+    cursor.end = since;
+    cursor.stage = 0;
+}
+
+static void writeJsonRecord(const LogRecord& record, void* context) {
+    LogJsonCursor& cursor = *(LogJsonCursor*)context;
+    Print& out = *cursor.out;
+    out.printf("%s{\"seq\":%lu,\"t\":%lu,\"level\":%u,\"module\":\"%s\",\"msg\":\"",
+               cursor.last == cursor.since ? "" : ",", (unsigned long)record.sequence,
+               (unsigned long)record.timestampMs, record.level, LoggerClass::moduleName(record.module));
+    writeJsonEscaped(out, record.message, record.length);
+    out.print("\"}");
+    cursor.last = record.sequence;
+}
+
+bool LoggerClass::writeLogsJsonPart(Print& out, LogJsonCursor& cursor) {
+    cursor.out = &out;
+    if (cursor.stage == 0) {
+        portENTER_CRITICAL(&logMux);
+        uint32_t last = totalRecords;
+        uint32_t first = totalRecords - logCount + 1;
+        int count = logCount;
+        portEXIT_CRITICAL(&logMux);
+
+        // A cursor from before a reboot is ahead of us: start over
+        if (cursor.since > last) {
+            cursor.since = 0;
+            cursor.last = 0;
+        }
+        // Records logged while the response is being sent wait for the next request
+        cursor.end = last;
+        out.printf("{\"first\":%lu,\"count\":%d,\"freeRam\":%u,\"logs\":[",
+                   (unsigned long)first, count, (unsigned)ESP.getFreeHeap());
+        cursor.stage = 1;
+        return true;
+    }
+
+    if (cursor.stage == 1) {
+        uint32_t previous = cursor.last;
+        if (cursor.last < cursor.end) {
+            forEachRecordSince(cursor.last, writeJsonRecord, &cursor, 1);
+        }
+        if (cursor.last != previous) {
+            return true;
+        }
+        // "last" is the cursor for the next request (the newest record sent)
+        out.printf("],\"last\":%lu}", (unsigned long)cursor.last);
+        cursor.stage = 2;
+    }
+    return false;
 }
 
 void LoggerClass::clearLogs() {
-    logIndex = 0;
+    portENTER_CRITICAL(&logMux);
+    tail = head;
     logCount = 0;
-    bufferPos = 0;
-    messageBuffer[0] = '\0';
-}
\ No newline at end of file
+    portEXIT_CRITICAL(&logMux);
+}
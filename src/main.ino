@@ -8,6 +8,15 @@
 #include "audio_file_player.h"
 #include "wifi_manager.h"
 #include "logging.h"
+#include "settings_store.h"
+#include "boot_profiler.h"
+#include "button_input.h"
+#include "game_engine.h"
+#include "round_history.h"
+#include "log_sink.h"
+#include "metrics.h"
+#include "control_api.h"
+#include "event_stream.h"
 #include <SD.h>
 
 #define PLAYER_1_YES 1
@@ -16,10 +25,6 @@
 #define PLAYER_2_NO 4
 #define RESET_GAME 5
 
-#ifndef GAME_TIMEOUT_MS
-#define GAME_TIMEOUT_MS 60000  // 60 seconds default timeout
-#endif
-
 #ifndef YES_SOUND_KEY
 #define YES_SOUND_KEY "yes"
 #endif
@@ -32,6 +37,22 @@
 #define LOCKED_IN_SOUND_KEY "locked_in"
 #endif
 
+#ifndef SERIAL_WAIT_MS
+#define SERIAL_WAIT_MS 500 // Longest wait for a native USB serial host at boot
+#endif
+
+#ifndef CODEC_INIT_ATTEMPTS
+#define CODEC_INIT_ATTEMPTS 3
+#endif
+
+#ifndef CODEC_RETRY_MS
+#define CODEC_RETRY_MS 50
+#endif
+
+#ifndef CATALOG_WAIT_MS
+#define CATALOG_WAIT_MS 2000 // Longest setup() waits for the SD catalog before the first round
+#endif
+
 AudioBoardStream kit(AudioKitEs8388V1); // Audio source
 
 #ifndef AUDIO_START_PATH
@@ -40,198 +61,263 @@ AudioBoardStream kit(AudioKitEs8388V1); // Audio source
 
 // Audio components
 AudioSourceSDMMC source(AUDIO_START_PATH);
-MP3DecoderHelix decoder;
 
-// Button press tracking
-struct ButtonPress {
-    unsigned long timestamp;
-    bool value; // true for YES, false for NO
-    bool hasPressed; // true if this player has pressed a button this round
+// Game logic; fed with timestamped presses, reports results through onGameEvent()
+GameEngine game;
+
+// Input table: station/player/answer of each button. Entries hold board key
+// numbers until setup() resolves them to GPIO pins. Add rows (and stations)
+// here to run more players from one board.
+GameInput gameInputs[] = {
+    {PLAYER_1_YES, 0, 0, true},
+    {PLAYER_2_YES, 0, 1, true},
+    {PLAYER_1_NO,  0, 0, false},
+    {PLAYER_2_NO,  0, 1, false},
 };
+const size_t gameInputCount = sizeof(gameInputs) / sizeof(gameInputs[0]);
+GameInputMap gameInputMap;
 
-ButtonPress player1LastPress = {0, false, false};
-ButtonPress player2LastPress = {0, false, false};
+// Microsecond time of the press being fed to the engine (for the round history)
+int64_t currentPressUs = 0;
 
-// Game state
-enum GameState {
-    WAITING_FOR_PLAYERS,
-    GAME_COMPLETE,
-    PLAYING_SOUND
-};
+// Exported at /metrics
+MetricHistogram loopTime("loop_duration_us", "Time for one pass of loop()");
+MetricGauge loopMaxTime("loop_max_duration_us", "Longest pass of loop() since boot");
+
+// Association runs in the WiFi driver from setup() until the first connect
+int wifiBootPhase = -1;
 
-GameState gameState = WAITING_FOR_PLAYERS;
-unsigned long firstPressTime = 0;
+// Set on connect; the download waits in loop() until the boot-time catalog load is done
+bool catalogRefreshPending = false;
 
-// WiFi connected callback - downloads audio sequences when WiFi connects
+// WiFi connected callback - schedules the audio sequence download
 void onWiFiConnected()
 {
-    Logger.println("🌐 WiFi connected - downloading audio sequences...");
-    
-    // Download sequences from server (if cache is stale)
+    endBootPhase(wifiBootPhase);
+    wifiBootPhase = -1;
+    catalogRefreshPending = true;
+}
+
+// Download sequences from server (if cache is stale) once the SD catalog has loaded
+void processCatalogRefresh()
+{
+    if (!catalogRefreshPending || !waitForAudioCatalog(0))
+    {
+        return;
+    }
+    catalogRefreshPending = false;
+    LOG_INFO("🌐 WiFi connected - downloading audio sequences...");
+
     if (downloadAudio())
     {
-        Logger.println("✅ Sequences loaded successfully");
+        LOG_INFO("✅ Sequences loaded successfully");
         listAudioKeys();
     }
     else
     {
-        Logger.println("⚠️ Failed to download sequences (using cached data if available)");
+        LOG_WARN("⚠️ Failed to download sequences (using cached data if available)");
     }
 }
 
 void setup()
 {
     Serial.begin(115200);
-    delay(2000); // Give serial time to initialize
+#if ARDUINO_USB_CDC_ON_BOOT
+    // Native USB: wait (briefly) for the host to open the port; a UART is ready at once
+    while (!Serial && millis() < SERIAL_WAIT_MS) {
+        delay(10);
+    }
+#endif
 
-    // Initialize logging system first
+    // Initialize logging system first; lines logged before a monitor attaches stay in the ring (/logs)
     Logger.addLogger(Serial);
     
-    Logger.printf("=== Starting ===\n");
+    LOG_INFO("=== Starting ===\n");
     AudioToolsLogger.begin(Serial, AudioToolsLogLevel::Info); // setup Audiokit
+    initSettings();
+
+    // Start association first: it runs in the WiFi driver while the rest of setup() continues
+    LOG_INFO("🔧 Starting WiFi initialization in background...");
+    wifiBootPhase = beginBootPhase("wifi");
+    initWiFi(onWiFiConnected);    // Configure OTA updates (will start when WiFi is ready)
+    LOG_INFO("🔄 Configuring OTA updates");
+    initOTA();
 
-    // Add more startup delay for system stabilization
-    Logger.println("🔧 Allowing system to stabilize...");
-    delay(3000);
+    int phase = beginBootPhase("codec");
     auto cfg = kit.defaultConfig(TX_MODE);
     cfg.sd_active = true;
-    if (!kit.begin(cfg))
+    bool codecReady = false;
+    for (int attempt = 1; attempt <= CODEC_INIT_ATTEMPTS && !codecReady; attempt++) {
+        codecReady = kit.begin(cfg);
+        if (!codecReady && attempt < CODEC_INIT_ATTEMPTS) {
+            LOG_WARN("⚠️ AudioKit not ready, retry %d/%d\n", attempt, CODEC_INIT_ATTEMPTS - 1);
+            delay(CODEC_RETRY_MS);
+        }
+    }
+    if (!codecReady)
     {
-        Logger.println("❌ Failed to initialize AudioKit");
+        LOG_ERROR("❌ Failed to initialize AudioKit");
     }
     else {
-        Logger.println("✅ AudioKit initialized successfully");
+        LOG_INFO("✅ AudioKit initialized successfully");
     }
-    initAudioFilePlayer(source, kit, decoder);
+    endBootPhase(phase);
 
-    Logger.println("🎤 Audio system ready!");
+    // The SD card is set up by kit.begin() (sd_active); the catalog then
+    // loads on its own task while the rest of setup() runs
+    initializeAudioFileManager();
 
-    // Initialize WiFi in background (non-blocking) with callback
-    Logger.println("🔧 Starting WiFi initialization in background...");
-    initWiFi(onWiFiConnected);    // Configure OTA updates (will start when WiFi is ready)
-    Logger.println("🔄 Configuring OTA updates");
-    initOTA();
-    kit.addAction(kit.getKey(PLAYER_1_YES), buttonPressed);
-    kit.addAction(kit.getKey(PLAYER_2_YES), buttonPressed);
-    kit.addAction(kit.getKey(PLAYER_1_NO), buttonPressed);
-    kit.addAction(kit.getKey(PLAYER_2_NO), buttonPressed);
+    phase = beginBootPhase("player");
+    initAudioFilePlayer(source, kit);
+    endBootPhase(phase);
+
+    phase = beginBootPhase("services");
+    initRoundHistory();
+    initLogSink();
+    initEventStream();
+    endBootPhase(phase);
+
+    LOG_INFO("🎤 Audio system ready!");
+
+    // Player buttons are captured by interrupt so presses keep their real timestamps
+    phase = beginBootPhase("input");
+    uint8_t playerPins[gameInputCount];
+    for (size_t i = 0; i < gameInputCount; i++) {
+        gameInputs[i].pin = (uint8_t)kit.getKey(gameInputs[i].pin);
+        playerPins[i] = gameInputs[i].pin;
+    }
+    if (!gameInputMap.begin(gameInputs, gameInputCount)) {
+        LOG_ERROR("❌ Invalid game input table (pin out of range or used twice)");
+    }
+    game.configureStations(gameInputs, gameInputCount);
+    initButtonInput(playerPins, gameInputCount);
     kit.addAction(kit.getKey(RESET_GAME), [](bool active, int pin, void *ptr) {
-        Logger.println("🔄 Reset button pressed - resetting game");
-        resetGame();
+        LOG_INFO("🔄 Reset button pressed - resetting game");
+        game.reset();
     });
-    Logger.println("✅ Startup complete!"); 
-}
+    game.setClock([](void*) -> uint32_t { return millis(); });
+    game.setEventHandler(onGameEvent);
+    endBootPhase(phase);
 
-void buttonPressed(bool active, int pin, void *ptr) {
-    // Ignore button presses while playing sound
-    if (gameState == PLAYING_SOUND) {
-        return;
+    // A round needs the catalog to map results to sounds
+    if (!waitForAudioCatalog(CATALOG_WAIT_MS)) {
+        LOG_WARN("⚠️ Catalog still loading, sounds and downloads wait until it is done");
     }
-    
-    unsigned long timestamp = millis();
-    bool wasFirstPress = false;
-    
-    // Check if this is the first button press of the round
-    if (!player1LastPress.hasPressed && !player2LastPress.hasPressed) {
-        wasFirstPress = true;
-        firstPressTime = timestamp;
+    markBootReady();
+    LOG_INFO("✅ Startup complete!"); 
+}
+
+void buttonPressed(int pin, int64_t timestampUs) {
+    const GameInput* input = gameInputMap.find(pin);
+    if (input) {
+        // esp_timer and millis() share the same boot-time origin
+        currentPressUs = timestampUs;
+        game.press(*input, (uint32_t)(timestampUs / 1000));
     }
-    
-    if(kit.getKey(PLAYER_1_YES) == pin) {
-        Logger.println("YES 1 button pressed");
-        player1LastPress.timestamp = timestamp;
-        player1LastPress.value = true;
-        player1LastPress.hasPressed = true;
-    } else if(kit.getKey(PLAYER_2_YES) == pin) {
-        Logger.println("YES 2 button pressed");
-        player2LastPress.timestamp = timestamp;
-        player2LastPress.value = true;
-        player2LastPress.hasPressed = true;
-    } else if(kit.getKey(PLAYER_1_NO) == pin) {
-        Logger.println("NO 1 button pressed");
-        player1LastPress.timestamp = timestamp;
-        player1LastPress.value = false;
-        player1LastPress.hasPressed = true;
-    } else if(kit.getKey(PLAYER_2_NO) == pin) {
-        Logger.println("NO 2 button pressed");
-        player2LastPress.timestamp = timestamp;
-        player2LastPress.value = false;
-        player2LastPress.hasPressed = true;
+}
+
+// Pushes a game event to /events
+void publishGameEvent(const GameEvent& event) {
+    static const char* const eventNames[] = {"press", "locked_in", "round_complete", "reset"};
+    static const char* const outcomeNames[] = {"none", "yes", "no", "too_slow", "timeout"};
+    publishEvent(STREAM_EVENT_GAME,
+                 "{\"event\":\"%s\",\"station\":%d,\"timeMs\":%lu,\"player\":%d,\"answer\":%s,"
+                 "\"outcome\":\"%s\",\"spreadMs\":%lu,\"pressedMask\":%lu}",
+                 eventNames[event.type], event.station, (unsigned long)event.timeMs, event.player,
+                 event.answer ? "true" : "false", outcomeNames[event.outcome],
+                 (unsigned long)event.spreadMs, (unsigned long)event.pressedMask);
+}
+
+// Turns game events into log lines and sounds
+void onGameEvent(const GameEvent& event, void* context) {
+    recordGameEvent(event, event.type == GAME_EVENT_PRESS ? currentPressUs : esp_timer_get_time());
+    publishGameEvent(event);
+
+    switch (event.type) {
+    case GAME_EVENT_PRESS:
+        LOG_INFO("%s %d button pressed (station %d)\n", event.answer ? "YES" : "NO", event.player + 1, event.station + 1);
+        break;
+    case GAME_EVENT_LOCKED_IN:
+        LOG_INFO("🔒 Station %d: first player locked in! Waiting for the others... (%d seconds remaining)\n", event.station + 1, GAME_TIMEOUT_MS / 1000);
+        triggerAudioByKey(LOCKED_IN_SOUND_KEY, currentPressUs);
+        break;
+    case GAME_EVENT_ROUND_COMPLETE:
+        if (event.outcome != GAME_OUTCOME_TIMEOUT) {
+            LOG_INFO("🎮 All players at station %d have answered!\n", event.station + 1);
+        }
+        switch (event.outcome) {
+        case GAME_OUTCOME_YES:
+            LOG_INFO("✅ Both players said YES within %d seconds - playing YES sound!\n", GAME_TIMEOUT_MS / 1000);
+            triggerAudioByKey(YES_SOUND_KEY, currentPressUs);
+            break;
+        case GAME_OUTCOME_TOO_SLOW:
+            LOG_INFO("⏰ Both said YES but took too long (%lu ms) - playing NO sound\n", (unsigned long)event.spreadMs);
+            triggerAudioByKey(NO_SOUND_KEY, currentPressUs);
+            break;
+        case GAME_OUTCOME_TIMEOUT:
+            LOG_INFO("⏰ Timeout! Not every player at station %d answered within %d seconds - playing NO sound\n", event.station + 1, GAME_TIMEOUT_MS / 1000);
+            playAudioByKey(NO_SOUND_KEY);
+            break;
+        default:
+            LOG_INFO("🚫 At least one player said NO - playing NO sound");
+            triggerAudioByKey(NO_SOUND_KEY, currentPressUs);
+            break;
+        }
+        break;
+    case GAME_EVENT_RESET:
+        LOG_INFO("🎮 Station %d reset - ready for next round!\n", event.station + 1);
+        break;
     }
-    
-    // Play "locked in" sound if this was the first press and the other player hasn't pressed yet
-    if (wasFirstPress && !(player1LastPress.hasPressed && player2LastPress.hasPressed)) {
-        Logger.printf("🔒 First player locked in! Waiting for other player... (%d seconds remaining)\n", GAME_TIMEOUT_MS / 1000);
-        playAudioByKey(LOCKED_IN_SOUND_KEY);
+}
+
+// Drain captured button edges; timestamps are when the edge happened, not when loop() got here
+void processButtons() {
+    processButtonInput();
+
+    ButtonEvent event;
+    while (popButtonEvent(event)) {
+        if (event.pressed) {
+            buttonPressed(event.pin, event.timestampUs);
+        }
     }
 }
 
 void loop()
 {
+    unsigned long loopStart = micros();
+
     // Handle WiFi management (config portal and OTA)
     handleWiFiLoop();
+    processControlJobs();
+    processCatalogRefresh();
     processAudioDownloadQueue();
     processAudioFile();
     kit.processActions();
+    processButtons();
     processGame();
+    // Persist round history only between rounds, with no captured press waiting
+    processRoundHistory(game.waitingMask() == 0 && game.playingMask() == 0 && !hasButtonEvents());
+    processSettings();
+
+    unsigned long loopDuration = micros() - loopStart;
+    loopTime.record(loopDuration);
+    if ((int32_t)loopDuration > loopMaxTime.get()) {
+        loopMaxTime.set((int32_t)loopDuration);
+    }
 }
 
 
 void processGame() {
-    if (gameState == WAITING_FOR_PLAYERS) {
-        // Check if both players have pressed
-        if (player1LastPress.hasPressed && player2LastPress.hasPressed) {
-            // Both players have answered
-            Logger.println("🎮 Both players have answered!");
-            
-            // Check if either player pressed NO
-            if (!player1LastPress.value || !player2LastPress.value) {
-                Logger.println("❌ At least one player said NO - playing NO sound");
-                playAudioByKey(NO_SOUND_KEY);
-            } else {
-                // Both said YES - check if within timeout
-                unsigned long timeDiff = abs((long)(player1LastPress.timestamp - player2LastPress.timestamp));
-                if (timeDiff <= GAME_TIMEOUT_MS) {
-                    Logger.printf("✅ Both players said YES within %d seconds - playing YES sound!\n", GAME_TIMEOUT_MS / 1000);
-                    playAudioByKey(YES_SOUND_KEY);
-                } else {
-                    Logger.printf("⏰ Both said YES but took too long (%lu ms) - playing NO sound\n", timeDiff);
-                    playAudioByKey(NO_SOUND_KEY);
-                }
-            }
-            
-            gameState = PLAYING_SOUND;
-        }
-        // Check for timeout if at least one player has pressed
-        else if ((player1LastPress.hasPressed || player2LastPress.hasPressed) && firstPressTime > 0) {
-            unsigned long elapsed = millis() - firstPressTime;
-            if (elapsed > GAME_TIMEOUT_MS) {
-                Logger.printf("⏰ Timeout! Only one player answered within %d seconds - playing NO sound\n", GAME_TIMEOUT_MS / 1000);
-                playAudioByKey(NO_SOUND_KEY);
-                gameState = PLAYING_SOUND;
+    game.update();
+
+    // Wait for the result sound to finish before the next round
+    uint32_t playing = game.playingMask();
+    if (playing && !isAudioPlaying()) {
+        LOG_INFO("🔄 Sound finished - resetting game");
+        for (int station = 0; playing; station++, playing >>= 1) {
+            if (playing & 1) {
+                game.soundFinished(station);
             }
         }
     }
-    else if (gameState == PLAYING_SOUND) {
-        // Wait for sound to finish playing
-        if (!isAudioPlaying()) {
-            Logger.println("🔄 Sound finished - resetting game");
-            resetGame();
-        }
-    }
 }
-
-void resetGame() {
-    player1LastPress.timestamp = 0;
-    player1LastPress.value = false;
-    player1LastPress.hasPressed = false;
-    
-    player2LastPress.timestamp = 0;
-    player2LastPress.value = false;
-    player2LastPress.hasPressed = false;
-    
-    firstPressTime = 0;
-    gameState = WAITING_FOR_PLAYERS;
-    
-    Logger.println("🎮 Game reset - ready for next round!");
-}
\ No newline at end of file
@@ -0,0 +1,119 @@
+/**
+ * @file metrics.cpp
+ *
+ * This file implements the metrics registry, the Prometheus text renderer
+ * and the system gauges (heap, PSRAM, uptime).
+ *
+ * @date 2025
+ */
+
+#include "metrics.h"
+#include <esp_heap_caps.h>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+// Constant-initialized, so metrics constructed during static initialization
+// in any translation unit can link themselves in safely
+static Metric* registryHead = nullptr;
+static Metric* registryTail = nullptr;
+
+// ============================================================================
+// SYSTEM METRICS
+// ============================================================================
+
+static MetricGauge heapFree("heap_free_bytes", "Free internal heap",
+                            []() { return (int32_t)heap_caps_get_free_size(MALLOC_CAP_INTERNAL); });
+static MetricGauge heapMinFree("heap_min_free_bytes", "Lowest free internal heap since boot",
+                               []() { return (int32_t)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL); });
+static MetricGauge heapLargest("heap_largest_free_block_bytes", "Largest allocatable internal heap block",
+                               []() { return (int32_t)heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL); });
+static MetricGauge psramFree("psram_free_bytes", "Free PSRAM",
+                             []() { return (int32_t)heap_caps_get_free_size(MALLOC_CAP_SPIRAM); });
+static MetricGauge psramLargest("psram_largest_free_block_bytes", "Largest allocatable PSRAM block",
+                                []() { return (int32_t)heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM); });
+static MetricCounter uptime("uptime_seconds_total", "Seconds since boot",
+                            []() { return (uint32_t)(millis() / 1000); });
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+Metric::Metric(const char* name, const char* help, MetricType type)
+    : metricName(name), metricHelp(help), metricType(type), nextMetric(nullptr)
+{
+    // Append, so /metrics lists a module's metrics in definition order
+    if (registryTail)
+    {
+        registryTail->nextMetric = this;
+    }
+    else
+    {
+        registryHead = this;
+    }
+    registryTail = this;
+}
+
+const Metric* Metric::first()
+{
+    return registryHead;
+}
+
+uint64_t MetricHistogram::sum() const
+{
+    // Re-read the high word so a carry between the two loads is not lost
+    uint32_t high, low;
+    do
+    {
+        high = sumHigh.load(std::memory_order_relaxed);
+        low = sumLow.load(std::memory_order_relaxed);
+    } while (high != sumHigh.load(std::memory_order_relaxed));
+    return ((uint64_t)high << 32) | low;
+}
+
+void Metric::write(Print& out) const
+{
+    static const char* const typeNames[] = {"counter", "gauge", "histogram"};
+    out.printf("# HELP %s %s\n# TYPE %s %s\n", metricName, metricHelp, metricName, typeNames[metricType]);
+
+    switch (metricType)
+    {
+    case METRIC_COUNTER:
+        out.printf("%s %lu\n", metricName, (unsigned long)((const MetricCounter*)this)->get());
+        break;
+
+    case METRIC_GAUGE:
+        out.printf("%s %ld\n", metricName, (long)((const MetricGauge*)this)->get());
+        break;
+
+    case METRIC_HISTOGRAM:
+    {
+        const MetricHistogram* histogram = (const MetricHistogram*)this;
+        uint32_t cumulative = 0;
+        for (int i = 0; i < METRIC_HISTOGRAM_BUCKETS; i++)
+        {
+            cumulative += histogram->bucket(i);
+            if (i < METRIC_HISTOGRAM_BUCKETS - 1)
+            {
+                out.printf("%s_bucket{le=\"%lu\"} %lu\n", metricName, 1UL << i, (unsigned long)cumulative);
+            }
+            else
+            {
+                out.printf("%s_bucket{le=\"+Inf\"} %lu\n", metricName, (unsigned long)cumulative);
+            }
+        }
+        out.printf("%s_sum %llu\n%s_count %lu\n", metricName, (unsigned long long)histogram->sum(),
+                   metricName, (unsigned long)cumulative);
+        break;
+    }
+    }
+}
+
+void writeMetrics(Print& out)
+{
+    for (const Metric* metric = Metric::first(); metric; metric = metric->next())
+    {
+        metric->write(out);
+    }
+}
@@ -0,0 +1,185 @@
+/**
+ * @file ota_image_stream.cpp
+ *
+ * This file implements the firmware image pipeline. On the ESP32 the
+ * SHA-256 runs on the hardware accelerator through mbedtls.
+ *
+ * @date 2025
+ */
+
+#include "ota_image_stream.h"
+#include <mbedtls/md.h>
+#include <string.h>
+
+// ============================================================================
+// CLASS IMPLEMENTATION
+// ============================================================================
+
+OtaImageStream::OtaImageStream()
+    : sink(nullptr), sinkContext(nullptr), format(FORMAT_UNKNOWN), streamTotal(0), imageTotal(0),
+      errorText(nullptr)
+{
+    mbedtls_sha256_init(&sha);
+}
+
+OtaImageStream::~OtaImageStream()
+{
+    end();
+    mbedtls_sha256_free(&sha);
+}
+
+bool OtaImageStream::begin(InflateSink imageSink, void* context)
+{
+    sink = imageSink;
+    sinkContext = context;
+    format = FORMAT_UNKNOWN;
+    streamTotal = 0;
+    imageTotal = 0;
+    errorText = nullptr;
+    mbedtls_sha256_starts(&sha, 0);
+
+    if (!inflater.begin(hashAndForward, this))
+    {
+        errorText = inflater.error();
+        return false;
+    }
+    return true;
+}
+
+void OtaImageStream::end()
+{
+    inflater.end();
+}
+
+bool OtaImageStream::hashAndForward(const uint8_t* data, size_t length, void* context)
+{
+    OtaImageStream* self = (OtaImageStream*)context;
+    mbedtls_sha256_update(&self->sha, data, length);
+    self->imageTotal += length;
+    if (!self->sink(data, length, self->sinkContext))
+    {
+        self->errorText = "image write failed";
+        return false;
+    }
+    return true;
+}
+
+bool OtaImageStream::write(const uint8_t* data, size_t length)
+{
+    if (errorText)
+    {
+        return false;
+    }
+    if (length == 0)
+    {
+        return true;
+    }
+
+    if (format == FORMAT_UNKNOWN)
+    {
+        format = data[0] == 0x1F ? FORMAT_GZIP : FORMAT_RAW;
+    }
+    streamTotal += length;
+
+    if (format == FORMAT_RAW)
+    {
+        return hashAndForward(data, length, this);
+    }
+
+    if (inflater.write(data, length) == INFLATE_ERROR)
+    {
+        if (!errorText)
+        {
+            errorText = inflater.error();
+        }
+        return false;
+    }
+    return true;
+}
+
+bool OtaImageStream::isComplete() const
+{
+    return format == FORMAT_GZIP && inflater.status() == INFLATE_DONE;
+}
+
+bool OtaImageStream::finish(const uint8_t expected[OTA_SHA256_LENGTH])
+{
+    if (errorText)
+    {
+        return false;
+    }
+    if (format == FORMAT_GZIP && inflater.status() != INFLATE_DONE)
+    {
+        errorText = "compressed stream truncated";
+        return false;
+    }
+
+    uint8_t digest[OTA_SHA256_LENGTH];
+    mbedtls_sha256_finish(&sha, digest);
+    if (memcmp(digest, expected, OTA_SHA256_LENGTH) != 0)
+    {
+        errorText = "SHA-256 mismatch";
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+bool parseSha256Hex(const char* text, uint8_t digest[OTA_SHA256_LENGTH])
+{
+    if (!text || strlen(text) != OTA_SHA256_LENGTH * 2)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < OTA_SHA256_LENGTH * 2; i++)
+    {
+        char c = text[i];
+        int nibble;
+        if (c >= '0' && c <= '9')
+        {
+            nibble = c - '0';
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            nibble = c - 'a' + 10;
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            nibble = c - 'A' + 10;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (i & 1)
+        {
+            digest[i / 2] |= nibble;
+        }
+        else
+        {
+            digest[i / 2] = nibble << 4;
+        }
+    }
+    return true;
+}
+
+bool hmacSha256(const char* key, const uint8_t* message, size_t length, uint8_t mac[OTA_SHA256_LENGTH])
+{
+    return mbedtls_md_hmac(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), (const uint8_t*)key, strlen(key), message,
+                           length, mac) == 0;
+}
+
+bool digestsEqual(const uint8_t a[OTA_SHA256_LENGTH], const uint8_t b[OTA_SHA256_LENGTH])
+{
+    uint8_t difference = 0;
+    for (int i = 0; i < OTA_SHA256_LENGTH; i++)
+    {
+        difference |= a[i] ^ b[i];
+    }
+    return difference == 0;
+}
@@ -0,0 +1,365 @@
+/**
+ * @file ota_pull.cpp
+ *
+ * This file implements the pull OTA task: ranged HTTP requests feeding the
+ * image pipeline, resume after a drop, and the final verify-then-commit.
+ *
+ * @date 2025
+ */
+
+#define LOG_MODULE LOG_MODULE_WIFI
+#include "ota_pull.h"
+#include "ota_image_stream.h"
+#include "logging.h"
+#include "metrics.h"
+#include "event_stream.h"
+#include "settings_store.h"
+#include <HTTPClient.h>
+#include <Update.h>
+#include <WiFi.h>
+#include <new>
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+// Written by startPullOta() before the task starts, then only read by it
+static char pullUrl[OTA_PULL_URL_LENGTH];
+static uint8_t pullDigest[OTA_SHA256_LENGTH];
+static uint32_t pullImageSize = 0;
+
+// Written by the task, read by getPullOtaStatus() on the web task
+static OtaPullStatus pullStatus = {};
+static bool pullRunning = false;
+static unsigned long pullStartMs = 0;
+static portMUX_TYPE statusMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Exported at /metrics
+static MetricCounter pullBytes("ota_pull_bytes_total", "Bytes received by pull OTA downloads");
+static MetricCounter pullResumes("ota_pull_resumes_total", "Pull OTA downloads resumed after a drop");
+static MetricGauge pullDuration("ota_pull_last_duration_ms", "Duration of the last pull OTA");
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static void failPull(const char* text)
+{
+    portENTER_CRITICAL(&statusMux);
+    pullStatus.state = OTA_PULL_FAILED;
+    strlcpy(pullStatus.error, text ? text : "unknown error", sizeof(pullStatus.error));
+    portEXIT_CRITICAL(&statusMux);
+    LOG_ERROR("❌ Pull OTA failed: %s\n", text ? text : "unknown error");
+}
+
+static void updateProgress(const OtaImageStream& image, int32_t streamSize)
+{
+    portENTER_CRITICAL(&statusMux);
+    pullStatus.compressed = image.isCompressed();
+    pullStatus.streamBytes = image.streamBytes();
+    pullStatus.streamSize = streamSize;
+    pullStatus.imageBytes = image.imageBytes();
+    pullStatus.elapsedMs = millis() - pullStartMs;
+    portEXIT_CRITICAL(&statusMux);
+}
+
+static bool writeToUpdate(const uint8_t* data, size_t length, void* context)
+{
+    return Update.write((uint8_t*)data, length) == length;
+}
+
+/**
+ * @brief One connection: request the image from the first byte not yet
+ *        received and feed the pipeline until it ends, drops or stalls
+ * @param streamSize Size of the served file, learned from the response
+ * @param fatal Set for errors a retry cannot fix
+ * @return Bytes received on this connection
+ */
+static uint32_t receiveAttempt(OtaImageStream& image, uint8_t* buffer, int32_t& streamSize, bool& fatal)
+{
+    uint32_t received = image.streamBytes();
+
+    HTTPClient http;
+    http.useHTTP10(true); // No chunked encoding: the body is read straight off the socket
+    http.setTimeout(OTA_PULL_READ_TIMEOUT_MS);
+    if (!http.begin(pullUrl))
+    {
+        fatal = true;
+        failPull("invalid URL");
+        return 0;
+    }
+
+    char range[32];
+    if (received)
+    {
+        snprintf(range, sizeof(range), "bytes=%lu-", (unsigned long)received);
+        http.addHeader("Range", range);
+    }
+
+    const char* headers[] = {"Content-Range"};
+    http.collectHeaders(headers, 1);
+    int code = http.GET();
+    uint32_t skip = 0;
+    if (code == 200)
+    {
+        // A server that ignores Range sends the whole file again
+        skip = received;
+    }
+    else if (code == 416 && received)
+    {
+        // Nothing left past what we have: a raw image served without
+        // Content-Length ends when the connection closes, which looks like
+        // a drop. finish() still checks the digest.
+        String contentRange = http.header("Content-Range");
+        const char* total = strchr(contentRange.c_str(), '/');
+        http.end();
+        if (total && total[1] != '*' && strtoul(total + 1, nullptr, 10) != received)
+        {
+            fatal = true;
+            failPull("range not satisfiable");
+            return 0;
+        }
+        streamSize = (int32_t)received;
+        return 0;
+    }
+    else if (code != 206)
+    {
+        LOG_WARN("⚠️ Pull OTA request failed: %d\n", code);
+        http.end();
+        if (code >= 400 && code < 500 && code != 408 && code != 429)
+        {
+            fatal = true;
+            failPull(code == 404 ? "image not found" : "request rejected");
+        }
+        return 0;
+    }
+
+    int32_t length = http.getSize();
+    if (length >= 0)
+    {
+        streamSize = code == 206 ? (int32_t)received + length : length;
+    }
+
+    WiFiClient* stream = http.getStreamPtr();
+    uint32_t progress = 0;
+    unsigned long lastData = millis();
+    unsigned long lastEvent = 0;
+    while (!image.isComplete() && (streamSize < 0 || image.streamBytes() < (uint32_t)streamSize))
+    {
+        int available = stream->available();
+        if (available <= 0)
+        {
+            if (!stream->connected() || millis() - lastData > OTA_PULL_READ_TIMEOUT_MS)
+            {
+                break;
+            }
+            delay(2);
+            continue;
+        }
+
+        int n = stream->read(buffer, min(available, OTA_PULL_BUFFER));
+        if (n <= 0)
+        {
+            continue;
+        }
+        lastData = millis();
+
+        const uint8_t* data = buffer;
+        size_t count = n;
+        if (skip)
+        {
+            size_t skipped = min((size_t)skip, count);
+            skip -= skipped;
+            data += skipped;
+            count -= skipped;
+        }
+        if (count == 0)
+        {
+            continue;
+        }
+
+        if (!image.write(data, count))
+        {
+            fatal = true;
+            failPull(image.error());
+            break;
+        }
+        progress += count;
+        pullBytes.add(count);
+
+        updateProgress(image, streamSize);
+        if (millis() - lastEvent >= OTA_PULL_PROGRESS_EVENT_MS)
+        {
+            lastEvent = millis();
+            publishEvent(STREAM_EVENT_DOWNLOAD, "{\"event\":\"ota\",\"bytes\":%lu,\"size\":%ld,\"image\":%lu}",
+                         (unsigned long)image.streamBytes(), (long)streamSize,
+                         (unsigned long)image.imageBytes());
+        }
+    }
+
+    http.end();
+    return progress;
+}
+
+/**
+ * @brief Download, verify and commit the image
+ * @return true if the update partition now holds the verified image
+ */
+static bool runPullOta()
+{
+    OtaImageStream* image = new (std::nothrow) OtaImageStream();
+    uint8_t* buffer = (uint8_t*)malloc(OTA_PULL_BUFFER);
+    bool ok = false;
+
+    if (!image || !buffer || !image->begin(writeToUpdate, nullptr))
+    {
+        failPull("out of memory");
+    }
+    else if (!Update.begin(pullImageSize ? pullImageSize : UPDATE_SIZE_UNKNOWN))
+    {
+        failPull(Update.errorString());
+    }
+    else
+    {
+        int32_t streamSize = -1;
+        int idleAttempts = 0;
+        bool fatal = false;
+        for (;;)
+        {
+            uint32_t progress = receiveAttempt(*image, buffer, streamSize, fatal);
+            if (fatal || image->isComplete() ||
+                (streamSize >= 0 && image->streamBytes() >= (uint32_t)streamSize))
+            {
+                break;
+            }
+
+            idleAttempts = progress ? 0 : idleAttempts + 1;
+            if (idleAttempts >= OTA_PULL_MAX_ATTEMPTS)
+            {
+                fatal = true;
+                failPull("connection lost");
+                break;
+            }
+
+            pullResumes.add();
+            portENTER_CRITICAL(&statusMux);
+            pullStatus.resumes++;
+            portEXIT_CRITICAL(&statusMux);
+            LOG_WARN("⚠️ Pull OTA interrupted at %lu bytes, resuming\n", (unsigned long)image->streamBytes());
+            delay(OTA_PULL_RETRY_MS);
+        }
+
+        if (!fatal)
+        {
+            if (!image->finish(pullDigest))
+            {
+                failPull(image->error());
+            }
+            else if (!Update.end(true))
+            {
+                failPull(Update.errorString());
+            }
+            else
+            {
+                ok = true;
+            }
+        }
+        if (!ok)
+        {
+            Update.abort();
+        }
+        updateProgress(*image, streamSize);
+    }
+
+    if (ok)
+    {
+        LOG_INFO("✅ Pull OTA verified: %lu bytes received, %lu bytes image (%s) in %lu ms\n",
+                 (unsigned long)image->streamBytes(), (unsigned long)image->imageBytes(),
+                 image->isCompressed() ? "gzip" : "raw", millis() - pullStartMs);
+    }
+    delete image;
+    free(buffer);
+    return ok;
+}
+
+static void pullOtaTask(void* parameter)
+{
+    bool ok = runPullOta();
+    pullDuration.set((int32_t)(millis() - pullStartMs));
+    publishEvent(STREAM_EVENT_DOWNLOAD, "{\"event\":\"ota_%s\"}", ok ? "done" : "failed");
+
+    if (ok)
+    {
+        portENTER_CRITICAL(&statusMux);
+        pullStatus.state = OTA_PULL_DONE;
+        portEXIT_CRITICAL(&statusMux);
+
+        LOG_INFO("🔄 Restarting into the new firmware...\n");
+        flushSettings();
+        delay(1000); // Let the reply, the event and the log line go out
+        ESP.restart();
+    }
+
+    portENTER_CRITICAL(&statusMux);
+    pullRunning = false;
+    portEXIT_CRITICAL(&statusMux);
+    vTaskDelete(nullptr);
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+OtaPullStartResult startPullOta(const char* url, const char* sha256Hex, uint32_t imageSize)
+{
+    uint8_t digest[OTA_SHA256_LENGTH];
+    if (!url || strncmp(url, "http", 4) != 0 || strlen(url) >= sizeof(pullUrl) ||
+        !parseSha256Hex(sha256Hex, digest))
+    {
+        return OTA_START_INVALID;
+    }
+    if (Update.isRunning())
+    {
+        return OTA_START_BUSY; // A push OTA is in progress
+    }
+
+    portENTER_CRITICAL(&statusMux);
+    bool busy = pullRunning;
+    if (!busy)
+    {
+        pullRunning = true;
+        memset(&pullStatus, 0, sizeof(pullStatus));
+        pullStatus.state = OTA_PULL_DOWNLOADING;
+        pullStatus.streamSize = -1;
+    }
+    portEXIT_CRITICAL(&statusMux);
+    if (busy)
+    {
+        return OTA_START_BUSY;
+    }
+
+    strlcpy(pullUrl, url, sizeof(pullUrl));
+    memcpy(pullDigest, digest, sizeof(pullDigest));
+    pullImageSize = imageSize;
+    pullStartMs = millis();
+
+    LOG_INFO("⬇️ Pull OTA from %s\n", pullUrl);
+    if (xTaskCreatePinnedToCore(pullOtaTask, "otaPull", OTA_PULL_TASK_STACK, nullptr, OTA_PULL_TASK_PRIORITY,
+                                nullptr, OTA_PULL_TASK_CORE) != pdPASS)
+    {
+        failPull("could not start task");
+        portENTER_CRITICAL(&statusMux);
+        pullRunning = false;
+        portEXIT_CRITICAL(&statusMux);
+        return OTA_START_FAILED;
+    }
+    return OTA_START_OK;
+}
+
+OtaPullStatus getPullOtaStatus()
+{
+    portENTER_CRITICAL(&statusMux);
+    OtaPullStatus snapshot = pullStatus;
+    portEXIT_CRITICAL(&statusMux);
+    return snapshot;
+}
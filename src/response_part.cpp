@@ -0,0 +1,48 @@
+/**
+ * @file response_part.cpp
+ *
+ * This file implements the fixed-buffer part used to stream chunked web
+ * responses.
+ *
+ * @date 2025
+ */
+
+#include "response_part.h"
+
+size_t ResponsePart::write(uint8_t byte)
+{
+    return write(&byte, 1);
+}
+
+size_t ResponsePart::write(const uint8_t* buffer, size_t size)
+{
+    // A part larger than the buffer is cut short rather than grown
+    size_t n = min(size, sizeof(data) - length);
+    memcpy(data + length, buffer, n);
+    length += n;
+    return n;
+}
+
+size_t ResponsePart::fill(uint8_t* buffer, size_t maxLength, const std::function<bool(Print&)>& nextPart)
+{
+    size_t copied = 0;
+    while (copied < maxLength)
+    {
+        if (sent == length)
+        {
+            if (!more)
+            {
+                break;
+            }
+            length = 0;
+            sent = 0;
+            more = nextPart(*this);
+            continue;
+        }
+        size_t n = min(maxLength - copied, length - sent);
+        memcpy(buffer + copied, data + sent, n);
+        sent += n;
+        copied += n;
+    }
+    return copied;
+}
@@ -0,0 +1,405 @@
+/**
+ * @file round_history.cpp
+ *
+ * This file implements the round recorder, the sector-batched SD writer and
+ * the streaming export.
+ *
+ * @date 2025
+ */
+
+#define LOG_MODULE LOG_MODULE_HISTORY
+#include "round_history.h"
+#include "logging.h"
+#include "settings_store.h"
+#include <FS.h>
+#include <atomic>
+#include <esp_timer.h>
+#include <freertos/semphr.h>
+#include <time.h>
+
+static_assert(sizeof(RoundRecord) == ROUND_RECORD_SIZE, "RoundRecord layout changed");
+static_assert(ROUND_HISTORY_SECTOR_SIZE % ROUND_RECORD_SIZE == 0, "Records must tile a sector");
+static_assert((ROUND_HISTORY_RAM_RECORDS & (ROUND_HISTORY_RAM_RECORDS - 1)) == 0,
+              "ROUND_HISTORY_RAM_RECORDS must be a power of two");
+
+#define RECORDS_PER_SECTOR (ROUND_HISTORY_SECTOR_SIZE / ROUND_RECORD_SIZE)
+#define WRITE_RETRY_MS 5000
+#define EXPORT_LOCK_TIMEOUT_MS 100
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * @brief Round being played at a station
+ */
+struct OpenRound
+{
+    bool active;
+    int64_t startUs;
+    uint32_t pressedMask;
+    uint32_t yesMask;
+    int32_t pressOffsetUs[ROUND_RECORD_MAX_PLAYERS];
+};
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static OpenRound openRounds[GAME_MAX_STATIONS];
+static RoundRecord ring[ROUND_HISTORY_RAM_RECORDS];
+static uint32_t ringHead = 0;               // Next record to fill
+static uint32_t ringTail = 0;               // Oldest record not yet on SD
+static unsigned long pushTimes[ROUND_HISTORY_RAM_RECORDS]; // millis() when each ring record was added
+static uint32_t sectorFill = 0;             // Records already in the last, partial sector of the file
+static unsigned long lastFailedWrite = 0;
+static uint16_t bootCount = 0;
+static uint32_t sequence = 0;
+static RoundHistoryStats stats = {};
+
+// One sector of staging so records that wrap the ring still go out in one write
+static uint8_t sectorBuffer[ROUND_HISTORY_SECTOR_SIZE];
+
+// Exports run on the web server task: ringMux guards the ring indices and
+// records, fileMutex keeps a write from landing between an export's file
+// lengths and its copy of the RAM records
+static portMUX_TYPE ringMux = portMUX_INITIALIZER_UNLOCKED;
+static SemaphoreHandle_t fileMutex = nullptr;
+static std::atomic<int> openExports(0);
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+/**
+ * @brief CRC-32 with the zlib polynomial (matches zlib.crc32 on the host)
+ */
+static uint32_t crc32(const uint8_t* data, size_t length)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static int32_t clampOffset(int64_t offsetUs)
+{
+    if (offsetUs > INT32_MAX)
+    {
+        return INT32_MAX;
+    }
+    return offsetUs < INT32_MIN ? INT32_MIN : (int32_t)offsetUs;
+}
+
+static uint32_t pendingCount()
+{
+    return ringHead - ringTail;
+}
+
+static void pushRecord(const RoundRecord& record)
+{
+    portENTER_CRITICAL(&ringMux);
+    if (pendingCount() >= ROUND_HISTORY_RAM_RECORDS)
+    {
+        // SD has been unavailable for a while: keep the newest rounds
+        ringTail++;
+        stats.dropped++;
+    }
+    pushTimes[ringHead & (ROUND_HISTORY_RAM_RECORDS - 1)] = millis();
+    ring[ringHead++ & (ROUND_HISTORY_RAM_RECORDS - 1)] = record;
+    stats.recorded++;
+    portEXIT_CRITICAL(&ringMux);
+}
+
+/**
+ * @brief Move the current file aside once it exceeds the size cap
+ */
+static void rotateIfNeeded(size_t incoming)
+{
+    File current = ROUND_HISTORY_FS.open(ROUND_HISTORY_FILE, FILE_READ);
+    if (!current)
+    {
+        return;
+    }
+    size_t size = current.size();
+    current.close();
+
+    if (size + incoming <= ROUND_HISTORY_MAX_FILE_BYTES || openExports.load() > 0)
+    {
+        return;
+    }
+
+    ROUND_HISTORY_FS.remove(ROUND_HISTORY_OLD_FILE);
+    ROUND_HISTORY_FS.rename(ROUND_HISTORY_FILE, ROUND_HISTORY_OLD_FILE);
+    LOG_INFO("📊 Round history rotated (%u bytes)\n", (unsigned)size);
+}
+
+/**
+ * @brief Append up to `count` pending records in one file session
+ * @return Records written
+ */
+static uint32_t writeRecords(uint32_t count)
+{
+    // An export is taking its snapshot: try again on the next loop
+    if (count == 0 || xSemaphoreTake(fileMutex, 0) != pdTRUE)
+    {
+        return 0;
+    }
+
+    rotateIfNeeded(count * ROUND_RECORD_SIZE);
+    File file = ROUND_HISTORY_FS.open(ROUND_HISTORY_FILE, FILE_APPEND);
+    if (!file)
+    {
+        stats.writeErrors++;
+        lastFailedWrite = millis();
+        xSemaphoreGive(fileMutex);
+        return 0;
+    }
+    lastFailedWrite = 0;
+
+    // After a partial sector the first batch only tops it up, so later writes end on sector boundaries
+    sectorFill = (file.size() % ROUND_HISTORY_SECTOR_SIZE) / ROUND_RECORD_SIZE;
+    uint32_t written = 0;
+    while (written < count)
+    {
+        // Stage up to the end of the sector; each write() completes one unless this is a forced tail
+        uint32_t batch = count - written;
+        batch = batch > RECORDS_PER_SECTOR - sectorFill ? RECORDS_PER_SECTOR - sectorFill : batch;
+        for (uint32_t i = 0; i < batch; i++)
+        {
+            const RoundRecord& record = ring[(ringTail + i) & (ROUND_HISTORY_RAM_RECORDS - 1)];
+            memcpy(sectorBuffer + i * ROUND_RECORD_SIZE, &record, ROUND_RECORD_SIZE);
+        }
+
+        size_t bytes = batch * ROUND_RECORD_SIZE;
+        stats.writes++;
+        if (file.write(sectorBuffer, bytes) != bytes)
+        {
+            stats.writeErrors++;
+            lastFailedWrite = millis();
+            break;
+        }
+
+        portENTER_CRITICAL(&ringMux);
+        ringTail += batch;
+        portEXIT_CRITICAL(&ringMux);
+        written += batch;
+        stats.persisted += batch;
+        sectorFill = (sectorFill + batch) % RECORDS_PER_SECTOR;
+    }
+
+    file.close();
+    xSemaphoreGive(fileMutex);
+    return written;
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void initRoundHistory()
+{
+    fileMutex = xSemaphoreCreateMutex();
+    bootCount = (uint16_t)(getSettingInt("history", "boots", 0) + 1);
+    putSettingInt("history", "boots", bootCount);
+    memset(openRounds, 0, sizeof(openRounds));
+
+    File file = ROUND_HISTORY_FS.open(ROUND_HISTORY_FILE, FILE_READ);
+    if (file)
+    {
+        sectorFill = (file.size() % ROUND_HISTORY_SECTOR_SIZE) / ROUND_RECORD_SIZE;
+        file.close();
+    }
+    LOG_INFO("📊 Round history ready (boot %u, %s)\n", bootCount, ROUND_HISTORY_FILE);
+}
+
+void recordGameEvent(const GameEvent& event, int64_t timeUs)
+{
+    if (event.station < 0 || event.station >= GAME_MAX_STATIONS)
+    {
+        return;
+    }
+
+    OpenRound& round = openRounds[event.station];
+    switch (event.type)
+    {
+    case GAME_EVENT_PRESS:
+    {
+        if (!round.active)
+        {
+            memset(&round, 0, sizeof(round));
+            round.active = true;
+            round.startUs = timeUs;
+        }
+        uint32_t bit = 1u << event.player;
+        round.pressedMask |= bit;
+        round.yesMask = event.answer ? (round.yesMask | bit) : (round.yesMask & ~bit);
+        if (event.player < ROUND_RECORD_MAX_PLAYERS)
+        {
+            round.pressOffsetUs[event.player] = clampOffset(timeUs - round.startUs);
+        }
+        break;
+    }
+
+    case GAME_EVENT_ROUND_COMPLETE:
+    {
+        RoundRecord record;
+        memset(&record, 0, sizeof(record));
+        record.magic = ROUND_RECORD_MAGIC;
+        record.version = ROUND_RECORD_VERSION;
+        record.station = (uint8_t)event.station;
+        record.outcome = (uint8_t)event.outcome;
+        record.players = (uint8_t)event.players;
+        record.bootCount = bootCount;
+        record.sequence = sequence++;
+        record.pressedMask = round.pressedMask;
+        record.yesMask = round.yesMask;
+        record.startUs = round.startUs;
+        record.decideOffsetUs = clampOffset(timeUs - round.startUs);
+        time_t now = time(nullptr);
+        record.unixTime = now > 1600000000 ? (uint32_t)now : 0; // Only once NTP has set the clock
+        memcpy(record.pressOffsetUs, round.pressOffsetUs, sizeof(record.pressOffsetUs));
+        record.crc32 = crc32((const uint8_t*)&record, offsetof(RoundRecord, crc32));
+        pushRecord(record);
+        round.active = false;
+        break;
+    }
+
+    case GAME_EVENT_RESET:
+        // Rounds abandoned by a reset are not recorded
+        round.active = false;
+        break;
+
+    default:
+        break;
+    }
+}
+
+void processRoundHistory(bool idle)
+{
+    uint32_t pending = pendingCount();
+    if (!idle || pending == 0)
+    {
+        return;
+    }
+
+    unsigned long now = millis();
+    if (lastFailedWrite != 0 && now - lastFailedWrite < WRITE_RETRY_MS)
+    {
+        return;
+    }
+
+    uint32_t room = RECORDS_PER_SECTOR - sectorFill;
+    if (pending >= room)
+    {
+        // Up to sector boundaries only; the remainder waits for more rounds
+        writeRecords(pending - (pending - room) % RECORDS_PER_SECTOR);
+    }
+    else if (now - pushTimes[ringTail & (ROUND_HISTORY_RAM_RECORDS - 1)] >= ROUND_HISTORY_MAX_AGE_MS)
+    {
+        writeRecords(pending);
+    }
+}
+
+void flushRoundHistory()
+{
+    writeRecords(pendingCount());
+}
+
+RoundHistoryExport::RoundHistoryExport()
+    : fileBytes{0, 0}, pendingRecords(0), position(0), active(false)
+{
+}
+
+RoundHistoryExport::~RoundHistoryExport()
+{
+    for (int i = 0; i < 2; i++)
+    {
+        if (files[i])
+        {
+            files[i].close();
+        }
+    }
+    if (active)
+    {
+        openExports--;
+    }
+}
+
+bool RoundHistoryExport::begin()
+{
+    if (!fileMutex || xSemaphoreTake(fileMutex, pdMS_TO_TICKS(EXPORT_LOCK_TIMEOUT_MS)) != pdTRUE)
+    {
+        return false;
+    }
+    active = true;
+    openExports++;
+
+    const char* paths[] = {ROUND_HISTORY_OLD_FILE, ROUND_HISTORY_FILE};
+    for (int i = 0; i < 2; i++)
+    {
+        files[i] = ROUND_HISTORY_FS.open(paths[i], FILE_READ);
+        fileBytes[i] = files[i] ? files[i].size() : 0;
+    }
+
+    portENTER_CRITICAL(&ringMux);
+    pendingRecords = pendingCount();
+    for (uint32_t i = 0; i < pendingRecords; i++)
+    {
+        pending[i] = ring[(ringTail + i) & (ROUND_HISTORY_RAM_RECORDS - 1)];
+    }
+    portEXIT_CRITICAL(&ringMux);
+
+    xSemaphoreGive(fileMutex);
+    return true;
+}
+
+size_t RoundHistoryExport::size() const
+{
+    return fileBytes[0] + fileBytes[1] + pendingRecords * ROUND_RECORD_SIZE;
+}
+
+size_t RoundHistoryExport::read(uint8_t* buffer, size_t length)
+{
+    // Rotated file, current file (only the bytes present at begin()), then the RAM records
+    size_t filesEnd = fileBytes[0] + fileBytes[1];
+    size_t end = size();
+    size_t copied = 0;
+    while (copied < length && position < end)
+    {
+        size_t n;
+        if (position < fileBytes[0])
+        {
+            n = files[0].read(buffer + copied, min(length - copied, fileBytes[0] - position));
+        }
+        else if (position < filesEnd)
+        {
+            n = files[1].read(buffer + copied, min(length - copied, filesEnd - position));
+        }
+        else
+        {
+            n = min(length - copied, end - position);
+            memcpy(buffer + copied, (const uint8_t*)pending + (position - filesEnd), n);
+        }
+        if (n == 0)
+        {
+            break;
+        }
+        copied += n;
+        position += n;
+    }
+    return copied;
+}
+
+RoundHistoryStats getRoundHistoryStats()
+{
+    RoundHistoryStats snapshot = stats;
+    snapshot.pending = (uint8_t)pendingCount();
+    return snapshot;
+}
@@ -0,0 +1,405 @@
+/**
+ * @file settings_store.cpp
+ *
+ * This file implements the RAM-cached, write-behind settings store.
+ *
+ * @date 2025
+ */
+
+#define LOG_MODULE LOG_MODULE_SETTINGS
+#include "settings_store.h"
+#include "logging.h"
+#include <Preferences.h>
+#include <esp_system.h>
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+enum SettingType
+{
+    SETTING_FLOAT,
+    SETTING_INT,
+    SETTING_STRING,
+    SETTING_BYTES
+};
+
+/**
+ * @brief One cached namespace/key pair
+ */
+struct SettingEntry
+{
+    char ns[16];                    ///< NVS namespace (max 15 chars)
+    char key[16];                   ///< NVS key (max 15 chars)
+    SettingType type;
+    bool dirty;                     ///< Changed in RAM since the last flush
+    bool persisted;                 ///< Key exists in NVS
+    float floatValue;
+    int32_t intValue;
+    char stringValue[SETTINGS_MAX_STRING];  ///< Also holds SETTING_BYTES values
+    uint8_t byteLength;             ///< SETTING_BYTES value length
+};
+
+// ============================================================================
+// GLOBAL VARIABLES
+// ============================================================================
+
+static SettingEntry entries[SETTINGS_MAX_ENTRIES];
+static int entryCount = 0;
+static SemaphoreHandle_t settingsMutex = nullptr;
+static unsigned long firstDirtyTime = 0;
+static unsigned long lastChangeTime = 0;
+static int dirtyCount = 0;
+static SettingsStats stats = {};
+
+// ============================================================================
+// HELPER FUNCTIONS
+// ============================================================================
+
+static bool lockSettings(TickType_t timeout = portMAX_DELAY)
+{
+    if (!settingsMutex)
+    {
+        settingsMutex = xSemaphoreCreateMutex();
+    }
+    return xSemaphoreTake(settingsMutex, timeout) == pdTRUE;
+}
+
+static void unlockSettings()
+{
+    xSemaphoreGive(settingsMutex);
+}
+
+/**
+ * @brief Find a cached entry, loading it from NVS on first access (call with lock held)
+ * @return The entry, or nullptr if the cache is full
+ */
+static SettingEntry* getEntry(const char* ns, const char* key, SettingType type,
+                              float floatDefault, int32_t intDefault, const char* stringDefault)
+{
+    for (int i = 0; i < entryCount; i++)
+    {
+        if (strcmp(entries[i].ns, ns) == 0 && strcmp(entries[i].key, key) == 0)
+        {
+            return &entries[i];
+        }
+    }
+
+    if (entryCount >= SETTINGS_MAX_ENTRIES)
+    {
+        LOG_ERROR("❌ Settings cache full, cannot track %s/%s\n", ns, key);
+        return nullptr;
+    }
+
+    SettingEntry* entry = &entries[entryCount++];
+    strlcpy(entry->ns, ns, sizeof(entry->ns));
+    strlcpy(entry->key, key, sizeof(entry->key));
+    entry->type = type;
+    entry->dirty = false;
+    entry->persisted = false;
+    entry->floatValue = floatDefault;
+    entry->intValue = intDefault;
+    strlcpy(entry->stringValue, stringDefault ? stringDefault : "", sizeof(entry->stringValue));
+    entry->byteLength = 0;
+
+    // A missing namespace just means nothing has been saved yet
+    Preferences prefs;
+    if (prefs.begin(ns, true)) // Read-only
+    {
+        entry->persisted = prefs.isKey(key);
+        switch (type)
+        {
+        case SETTING_FLOAT:
+            entry->floatValue = prefs.getFloat(key, floatDefault);
+            break;
+        case SETTING_INT:
+            entry->intValue = prefs.getInt(key, intDefault);
+            break;
+        case SETTING_STRING:
+            prefs.getString(key, entry->stringValue, sizeof(entry->stringValue));
+            break;
+        case SETTING_BYTES:
+            // A stored value too large for the cache reads as missing
+            if (entry->persisted && prefs.getBytesLength(key) <= sizeof(entry->stringValue))
+            {
+                entry->byteLength = prefs.getBytes(key, entry->stringValue, sizeof(entry->stringValue));
+            }
+            break;
+        }
+        prefs.end();
+    }
+
+    return entry;
+}
+
+/**
+ * @brief Record a RAM change (call with lock held)
+ */
+static void markDirty(SettingEntry* entry)
+{
+    unsigned long now = millis();
+    lastChangeTime = now;
+
+    if (entry->dirty)
+    {
+        stats.coalesced++;
+        return;
+    }
+
+    entry->dirty = true;
+    if (dirtyCount++ == 0)
+    {
+        firstDirtyTime = now;
+    }
+}
+
+/**
+ * @brief Write every dirty entry, one NVS commit per namespace (call with lock held)
+ */
+static void flushLocked()
+{
+    if (dirtyCount == 0)
+    {
+        return;
+    }
+
+    for (int i = 0; i < entryCount; i++)
+    {
+        if (!entries[i].dirty)
+        {
+            continue;
+        }
+
+        // Open each namespace once and write all of its dirty keys
+        const char* ns = entries[i].ns;
+        Preferences prefs;
+        if (!prefs.begin(ns, false))
+        {
+            LOG_ERROR("❌ Failed to open %s preferences for writing\n", ns);
+            stats.nvsErrors++;
+            continue;
+        }
+
+        for (int j = i; j < entryCount; j++)
+        {
+            SettingEntry& e = entries[j];
+            if (!e.dirty || strcmp(e.ns, ns) != 0)
+            {
+                continue;
+            }
+
+            size_t written = 0;
+            switch (e.type)
+            {
+            case SETTING_FLOAT:
+                written = prefs.putFloat(e.key, e.floatValue);
+                break;
+            case SETTING_INT:
+                written = prefs.putInt(e.key, e.intValue);
+                break;
+            case SETTING_STRING:
+                written = prefs.putString(e.key, e.stringValue);
+                break;
+            case SETTING_BYTES:
+                if (e.byteLength == 0)
+                {
+                    // An empty value removes the key
+                    prefs.remove(e.key);
+                    written = 1;
+                }
+                else
+                {
+                    written = prefs.putBytes(e.key, e.stringValue, e.byteLength);
+                }
+                break;
+            }
+
+            if (written == 0 && !(e.type == SETTING_STRING && e.stringValue[0] == '\0'))
+            {
+                stats.nvsErrors++;
+                continue; // Stay dirty and retry on the next flush
+            }
+
+            e.dirty = false;
+            e.persisted = true;
+            dirtyCount--;
+            stats.nvsKeyWrites++;
+        }
+
+        prefs.end();
+        stats.nvsCommits++;
+    }
+
+    stats.flushes++;
+}
+
+/**
+ * @brief ESP shutdown handler: persist pending writes before restart
+ */
+static void flushSettingsOnShutdown()
+{
+    if (lockSettings(pdMS_TO_TICKS(100)))
+    {
+        flushLocked();
+        unlockSettings();
+    }
+}
+
+// ============================================================================
+// PUBLIC FUNCTIONS
+// ============================================================================
+
+void initSettings()
+{
+    lockSettings();
+    unlockSettings();
+    esp_register_shutdown_handler(flushSettingsOnShutdown);
+}
+
+float getSettingFloat(const char* ns, const char* key, float defaultValue)
+{
+    lockSettings();
+    SettingEntry* entry = getEntry(ns, key, SETTING_FLOAT, defaultValue, 0, nullptr);
+    float value = entry ? entry->floatValue : defaultValue;
+    unlockSettings();
+    return value;
+}
+
+int32_t getSettingInt(const char* ns, const char* key, int32_t defaultValue)
+{
+    lockSettings();
+    SettingEntry* entry = getEntry(ns, key, SETTING_INT, 0, defaultValue, nullptr);
+    int32_t value = entry ? entry->intValue : defaultValue;
+    unlockSettings();
+    return value;
+}
+
+String getSettingString(const char* ns, const char* key, const char* defaultValue)
+{
+    lockSettings();
+    SettingEntry* entry = getEntry(ns, key, SETTING_STRING, 0, 0, defaultValue);
+    String value = entry ? String(entry->stringValue) : String(defaultValue);
+    unlockSettings();
+    return value;
+}
+
+size_t getSettingBytes(const char* ns, const char* key, void* buffer, size_t length)
+{
+    lockSettings();
+    SettingEntry* entry = getEntry(ns, key, SETTING_BYTES, 0, 0, nullptr);
+    size_t stored = 0;
+    if (entry)
+    {
+        stored = entry->byteLength;
+        memcpy(buffer, entry->stringValue, min(stored, length));
+    }
+    unlockSettings();
+    return stored;
+}
+
+void putSettingFloat(const char* ns, const char* key, float value)
+{
+    lockSettings();
+    stats.puts++;
+    SettingEntry* entry = getEntry(ns, key, SETTING_FLOAT, value, 0, nullptr);
+    if (entry && (entry->floatValue != value || !entry->persisted))
+    {
+        entry->floatValue = value;
+        markDirty(entry);
+    }
+    else if (entry)
+    {
+        stats.coalesced++;
+    }
+    unlockSettings();
+}
+
+void putSettingInt(const char* ns, const char* key, int32_t value)
+{
+    lockSettings();
+    stats.puts++;
+    SettingEntry* entry = getEntry(ns, key, SETTING_INT, 0, value, nullptr);
+    if (entry && (entry->intValue != value || !entry->persisted))
+    {
+        entry->intValue = value;
+        markDirty(entry);
+    }
+    else if (entry)
+    {
+        stats.coalesced++;
+    }
+    unlockSettings();
+}
+
+void putSettingString(const char* ns, const char* key, const char* value)
+{
+    lockSettings();
+    stats.puts++;
+    SettingEntry* entry = getEntry(ns, key, SETTING_STRING, 0, 0, "");
+    if (entry && (strcmp(entry->stringValue, value) != 0 || !entry->persisted))
+    {
+        strlcpy(entry->stringValue, value, sizeof(entry->stringValue));
+        markDirty(entry);
+    }
+    else if (entry)
+    {
+        stats.coalesced++;
+    }
+    unlockSettings();
+}
+
+void putSettingBytes(const char* ns, const char* key, const void* value, size_t length)
+{
+    lockSettings();
+    stats.puts++;
+    SettingEntry* entry = getEntry(ns, key, SETTING_BYTES, 0, 0, nullptr);
+    if (entry && length > sizeof(entry->stringValue))
+    {
+        LOG_ERROR("❌ Setting %s/%s too large (%u bytes)\n", ns, key, (unsigned)length);
+    }
+    else if (entry && (entry->byteLength != length || memcmp(entry->stringValue, value, length) != 0 ||
+                       !entry->persisted))
+    {
+        memcpy(entry->stringValue, value, length);
+        entry->byteLength = (uint8_t)length;
+        markDirty(entry);
+    }
+    else if (entry)
+    {
+        stats.coalesced++;
+    }
+    unlockSettings();
+}
+
+void flushSettings()
+{
+    lockSettings();
+    flushLocked();
+    unlockSettings();
+}
+
+bool processSettings()
+{
+    if (dirtyCount == 0)
+    {
+        return false;
+    }
+
+    unsigned long now = millis();
+    if (now - lastChangeTime < SETTINGS_FLUSH_DELAY_MS && now - firstDirtyTime < SETTINGS_MAX_DIRTY_MS)
+    {
+        return false;
+    }
+
+    flushSettings();
+    return true;
+}
+
+SettingsStats getSettingsStats()
+{
+    lockSettings();
+    SettingsStats snapshot = stats;
+    snapshot.dirtyKeys = dirtyCount;
+    unlockSettings();
+    return snapshot;
+}
@@ -1,232 +1,549 @@
+#define LOG_MODULE LOG_MODULE_WIFI
 #include "wifi_manager.h"
 #include "logging.h"
+#include "settings_store.h"
+#include "round_history.h"
+#include "metrics.h"
+#include "control_api.h"
+#include "event_stream.h"
+#include "boot_profiler.h"
+#include "web_assets.h"
+#include "response_part.h"
 #include "nvs_flash.h"
+#include <esp_timer.h>
+#include <functional>
+#include <memory>
 
 // WiFi Setup Variables
-WebServer server(80);
+AsyncWebServer server(80);
 DNSServer dnsServer;
-Preferences wifiPrefs;
 bool isConfigMode = false;
 unsigned long portalStartTime = 0;
+static bool webServerStarted = false;
+
+// Last successful association, saved as one blob so the next boot can skip
+// the scan (BSSID and channel) and optionally DHCP (the lease)
+struct FastConnectRecord
+{
+    uint8_t version;
+    uint8_t channel;
+    uint8_t bssid[6];
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+};
+#define FAST_CONNECT_VERSION 1
+
+static bool fastConnectActive = false;      // The current attempt uses the saved record
+static unsigned long connectBeginTime = 0;
+
+static MetricGauge bootToConnectTime("wifi_boot_to_connect_ms", "Boot to the first WL_CONNECTED");
+static MetricGauge connectTime("wifi_connect_ms", "WiFi.begin() to WL_CONNECTED, last connection");
+static MetricCounter fastConnects("wifi_fast_connects_total", "Connections made with the saved BSSID/channel");
+static MetricCounter fastConnectFallbacks("wifi_fast_connect_fallbacks_total",
+                                          "Fast reconnects that fell back to a full scan");
+
+// Config portal bring-up, advanced by processConfigPortal()
+enum PortalState
+{
+    PORTAL_IDLE,
+    PORTAL_WIFI_OFF,
+    PORTAL_SET_MODE,
+    PORTAL_START_AP,
+    PORTAL_START_SERVICES
+};
+
+static PortalState portalState = PORTAL_IDLE;
+static unsigned long portalStepTime = 0;    // When the last step ran
+static unsigned long portalWaitMs = 0;      // Delay before the next step
+static int portalRetries = 0;
+
+// Loop stall over one timeout -> portal transition: the longest gap between
+// handleWiFiLoop() calls (one loop() pass) from the bring-up start until the portal is up
+static unsigned long wifiLoopEntryUs = 0;   // micros() when the current handleWiFiLoop() began
+static unsigned long portalBringUpUs = 0;   // micros() when the bring-up began
+static unsigned long portalMaxLoopUs = 0;
+
+static MetricHistogram portalStepDuration("wifi_portal_step_duration_us",
+                                          "Time spent in one config portal bring-up step");
+static MetricGauge portalMaxLoopTime("wifi_portal_max_loop_us",
+                                     "Longest loop() pass during the last config portal bring-up");
+static MetricCounter httpRequests("http_requests_total", "Web requests handled");
+static MetricHistogram httpHandlerTime("http_handler_duration_us", "Time spent in a web request handler");
 
 // WiFi connection callback
 static WiFiConnectedCallback wifiConnectedCallback = nullptr;
 
+// Credentials posted to /save; handlers run on the network task, so saving
+// and the restart are left to handleWiFiLoop()
+static char pendingSsid[33];
+static char pendingPassword[65];
+static volatile bool credentialsPending = false;
+static unsigned long restartTime = 0;
+
 // Save WiFi credentials to preferences
 void saveWiFiCredentials(const String& ssid, const String& password)
 {
-    if (!wifiPrefs.begin("wifi", false))
-    {
-        Logger.println("❌ Failed to open WiFi preferences for writing");
-        return;
-    }
+    putSettingString("wifi", "ssid", ssid.c_str());
+    putSettingString("wifi", "password", password.c_str());
+    putSettingBytes("wifi", "fast", "", 0); // The saved BSSID belongs to the old network
     
-    wifiPrefs.putString("ssid", ssid);
-    wifiPrefs.putString("password", password);
-    wifiPrefs.end();
+    // Credentials are followed by a restart - commit them now
+    flushSettings();
     
-    Logger.printf("✅ WiFi credentials saved for SSID: %s\n", ssid.c_str());
+    LOG_INFO("✅ WiFi credentials saved for SSID: %s\n", ssid.c_str());
+}
+
+// Chunked response produced by nextPart() one part at a time, as the
+// connection can take it; the whole body never exists in RAM at once.
+// nextPart() returns false once it has written the last part.
+AsyncWebServerResponse* beginPartResponse(AsyncWebServerRequest* request, const char* contentType,
+                                                 std::function<bool(Print&)> nextPart)
+{
+    auto part = std::make_shared<ResponsePart>();
+    return request->beginChunkedResponse(contentType,
+        [part, nextPart](uint8_t* buffer, size_t maxLength, size_t index) -> size_t
+        {
+            return part->fill(buffer, maxLength, nextPart);
+        });
+}
+
+// Send a gzipped asset straight from flash; a browser already holding it gets a 304
+static void sendWebAsset(AsyncWebServerRequest* request, const WebAsset& asset)
+{
+    AsyncWebServerResponse* response;
+    if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == asset.etag)
+    {
+        response = request->beginResponse(304);
+    }
+    else
+    {
+        response = request->beginResponse(200, asset.contentType, asset.data, asset.length);
+        response->addHeader("Content-Encoding", "gzip");
+    }
+    response->addHeader("ETag", asset.etag);
+    response->addHeader("Cache-Control", asset.fingerprinted ? WEB_ASSET_CACHE_CONTROL : WEB_PAGE_CACHE_CONTROL);
+    request->send(response);
+}
+
+// Handle a fingerprinted script or stylesheet (/logs.<hash>.js)
+static void handleWebAsset(AsyncWebServerRequest* request)
+{
+    for (const WebAsset& asset : webAssets)
+    {
+        if (request->url() == asset.path)
+        {
+            sendWebAsset(request, asset);
+            return;
+        }
+    }
+    request->send(404, "text/plain", "Not found");
 }
 
 // Handle logs page request
-void handleLogs()
+void handleLogs(AsyncWebServerRequest* request)
+{
+    sendWebAsset(request, webAssets[WEB_ASSET_LOGS_HTML]);
+}
+
+// Handle incremental log requests: /logs.json?since=<last sequence seen>
+void handleLogsJson(AsyncWebServerRequest* request)
+{
+    uint32_t since = 0;
+    if (request->hasParam("since"))
+    {
+        since = strtoul(request->getParam("since")->value().c_str(), nullptr, 10);
+    }
+
+    // The body only changes when a record is added or the buffer is cleared;
+    // the boot salt keeps a tag from a previous boot from matching
+    static const uint32_t etagSalt = esp_random();
+    char etag[40];
+    snprintf(etag, sizeof(etag), "\"%08lx-%lu-%d\"", (unsigned long)etagSalt,
+             (unsigned long)Logger.getLastSequence(), Logger.getLogCount());
+
+    AsyncWebServerResponse* response;
+    if (request->hasHeader("If-None-Match") && request->header("If-None-Match") == etag)
+    {
+        response = request->beginResponse(304);
+    }
+    else
+    {
+        auto cursor = std::make_shared<LogJsonCursor>();
+        Logger.beginLogsJson(*cursor, since);
+        response = beginPartResponse(request, "application/json", [cursor](Print& out)
+        {
+            return Logger.writeLogsJsonPart(out, *cursor);
+        });
+    }
+    response->addHeader("ETag", etag);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+}
+
+// Handle metrics scrape (Prometheus text format, one metric per part)
+void handleMetrics(AsyncWebServerRequest* request)
+{
+    auto metric = std::make_shared<const Metric*>(Metric::first());
+    request->send(beginPartResponse(request, "text/plain; version=0.0.4", [metric](Print& out)
+    {
+        if (*metric)
+        {
+            (*metric)->write(out);
+            *metric = (*metric)->next();
+        }
+        return *metric != nullptr;
+    }));
+}
+
+// Handle boot profile request (phase start and duration table)
+void handleBoot(AsyncWebServerRequest* request)
 {
-    String html = Logger.getLogsAsHtml();
-    server.send(200, "text/html", html);
+    request->send(beginPartResponse(request, "text/plain", [](Print& out)
+    {
+        writeBootProfile(out);
+        return false;
+    }));
+}
+
+// Handle round history export (binary RoundRecords, decode with tools/decode_rounds.py)
+void handleRounds(AsyncWebServerRequest* request)
+{
+    auto history = std::make_shared<RoundHistoryExport>();
+    if (!history->begin())
+    {
+        request->send(503, "text/plain", "Round history busy");
+        return;
+    }
+
+    AsyncWebServerResponse* response = request->beginResponse("application/octet-stream", history->size(),
+        [history](uint8_t* buffer, size_t maxLength, size_t index) -> size_t
+        {
+            return history->read(buffer, maxLength);
+        });
+    response->addHeader("Content-Disposition", "attachment; filename=\"rounds.bin\"");
+    request->send(response);
 }
 
 // Web server handlers for WiFi configuration - Minimal version
-void handleRoot()
+void handleRoot(AsyncWebServerRequest* request)
 {
-    const char* html = R"(
-<!DOCTYPE html><html><head><title>WiFi Setup</title>
-<meta name="viewport" content="width=device-width,initial-scale=1">
-<style>body{font-family:Arial;margin:20px;background:#f0f0f0}
-.c{max-width:300px;margin:auto;background:white;padding:20px;border-radius:5px}
-input{width:100%;padding:8px;margin:5px 0;border:1px solid #ddd}
-button{width:100%;background:#007cba;color:white;padding:10px;border:none;cursor:pointer;margin:5px 0}
-.logs-btn{background:#28a745;text-decoration:none;display:block;text-align:center}
-</style></head><body><div class="c"><h2>📱 WiFi Config</h2>
-<form action="/save" method="POST">
-<input type="text" name="ssid" placeholder="WiFi SSID" required>
-<input type="password" name="password" placeholder="Password">
-<button type="submit">Connect to WiFi</button></form>
-<a href="/logs" class="logs-btn button">📄 View System Logs</a>
-</div></body></html>
-)";
-    
-    server.send(200, "text/html", html);
+    sendWebAsset(request, webAssets[WEB_ASSET_INDEX_HTML]);
 }
 
-void handleSave()
+void handleSave(AsyncWebServerRequest* request)
 {
-    String ssid = server.arg("ssid");
-    String password = server.arg("password");
+    String ssid = request->hasParam("ssid", true) ? request->getParam("ssid", true)->value() : String();
+    String password = request->hasParam("password", true) ? request->getParam("password", true)->value() : String();
     
-    if (ssid.length() > 0)
+    if (ssid.length() > 0 && ssid.length() < sizeof(pendingSsid) && password.length() < sizeof(pendingPassword))
     {
-        saveWiFiCredentials(ssid, password);
-        
-        server.send(200, "text/plain", "Connecting to " + ssid + "...\nDevice will restart.");
+        if (!credentialsPending)
+        {
+            strcpy(pendingSsid, ssid.c_str());
+            strcpy(pendingPassword, password.c_str());
+            credentialsPending = true;
+        }
         
-        delay(1000);
-        isConfigMode = false;
-        ESP.restart();
+        request->send(200, "text/plain", "Connecting to " + ssid + "...\nDevice will restart.");
     }
     else
     {
-        server.send(400, "text/plain", "SSID required");
+        request->send(400, "text/plain", "SSID required (max 32 characters, password max 64)");
     }
 }
 
-// Connect to WiFi using saved credentials
-bool connectToWiFi()
+// Wrap a handler to count it and time it (the handler only; streamed bodies
+// are produced later as the connection drains)
+static ArRequestHandlerFunction timed(void (*handler)(AsyncWebServerRequest*))
 {
-    if (!wifiPrefs.begin("wifi", true)) // Read-only
+    return [handler](AsyncWebServerRequest* request)
     {
-        Logger.println("❌ Failed to open WiFi preferences");
-        return false;
+        int64_t start = esp_timer_get_time();
+        handler(request);
+        httpHandlerTime.record((uint32_t)(esp_timer_get_time() - start));
+        httpRequests.add();
+    };
+}
+
+// Register the routes and start the server; it runs on the AsyncTCP task in
+// both AP and STA mode, so requests are never served from loop()
+void startWebServer()
+{
+    if (webServerStarted)
+    {
+        return;
+    }
+
+    server.on("/", HTTP_GET, timed(handleRoot));
+    server.on("/save", HTTP_POST, timed(handleSave));
+    server.on("/logs", HTTP_GET, timed(handleLogs));
+    server.on("/logs.json", HTTP_GET, timed(handleLogsJson));
+    server.on("/rounds.bin", HTTP_GET, timed(handleRounds));
+    server.on("/metrics", HTTP_GET, timed(handleMetrics));
+    server.on("/boot", HTTP_GET, timed(handleBoot));
+    for (const WebAsset& asset : webAssets)
+    {
+        if (asset.fingerprinted)
+        {
+            server.on(asset.path, HTTP_GET, timed(handleWebAsset));
+        }
+    }
+    server.on("/api/play", HTTP_POST, timed(handleApiPlay));
+    server.on("/api/volume", HTTP_GET, timed(handleApiGetVolume));
+    server.on("/api/volume", HTTP_POST, timed(handleApiSetVolume));
+    server.on("/api/catalog/refresh", HTTP_POST, timed(handleApiCatalogRefresh));
+    server.on("/api/catalog", HTTP_GET, timed(handleApiCatalog));
+    server.on("/api/downloads", HTTP_GET, timed(handleApiDownloads));
+    server.on("/api/downloads", HTTP_DELETE, timed(handleApiClearDownloads));
+    server.on("/api/jobs", HTTP_GET, timed(handleApiJobs));
+    server.on("/api/ota", HTTP_POST, timed(handleApiStartOta));
+    server.on("/api/ota", HTTP_GET, timed(handleApiOtaStatus));
+    attachEventStream(server);
+    server.onNotFound([](AsyncWebServerRequest* request) {
+        // Captive portal: send every unknown URL to the setup page
+        if (isConfigMode)
+        {
+            request->redirect("/");
+        }
+        else
+        {
+            request->send(404, "text/plain", "Not found");
+        }
+    });
+
+    server.begin();
+    webServerStarted = true;
+    LOG_INFO("📱 Web server started");
+}
+
+// Apply WIFI_STATIC_IP if configured
+static bool applyStaticIP()
+{
+#ifdef WIFI_STATIC_IP
+    IPAddress ip, gateway, subnet, dns;
+    ip.fromString(WIFI_STATIC_IP);
+    gateway.fromString(WIFI_STATIC_GATEWAY);
+    subnet.fromString(WIFI_STATIC_SUBNET);
+    dns.fromString(WIFI_STATIC_DNS);
+    return WiFi.config(ip, gateway, subnet, dns);
+#else
+    return false;
+#endif
+}
+
+// Start connecting to the saved network; with a record, join its BSSID on its
+// channel directly instead of scanning every channel first
+static void beginStation(const FastConnectRecord* record)
+{
+    String ssid = getSettingString("wifi", "ssid");
+    String password = getSettingString("wifi", "password");
+    bool staticIP = applyStaticIP();
+    
+    if (record)
+    {
+#if WIFI_REUSE_LEASE
+        if (!staticIP && record->ip != 0)
+        {
+            WiFi.config(IPAddress(record->ip), IPAddress(record->gateway), IPAddress(record->subnet),
+                        IPAddress(record->dns));
+        }
+#endif
+        LOG_INFO("⚡ Fast reconnect: channel %u, BSSID %02x:%02x:%02x:%02x:%02x:%02x\n", record->channel,
+                 record->bssid[0], record->bssid[1], record->bssid[2],
+                 record->bssid[3], record->bssid[4], record->bssid[5]);
+        WiFi.begin(ssid.c_str(), password.c_str(), record->channel, record->bssid);
+    }
+    else
+    {
+        if (!staticIP)
+        {
+            // Drop a reused lease from a failed fast attempt
+            WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+        }
+        WiFi.begin(ssid.c_str(), password.c_str());
     }
     
-    String ssid = wifiPrefs.getString("ssid", "");
-    String password = wifiPrefs.getString("password", "");
-    wifiPrefs.end();
+    fastConnectActive = record != nullptr;
+    connectBeginTime = millis();
+}
+
+// Remember how we got on, for the next boot (an unchanged record costs no flash write)
+static void saveFastConnectRecord()
+{
+    FastConnectRecord record = {};
+    record.version = FAST_CONNECT_VERSION;
+    record.channel = WiFi.channel();
+    memcpy(record.bssid, WiFi.BSSID(), sizeof(record.bssid));
+    record.ip = (uint32_t)WiFi.localIP();
+    record.gateway = (uint32_t)WiFi.gatewayIP();
+    record.subnet = (uint32_t)WiFi.subnetMask();
+    record.dns = (uint32_t)WiFi.dnsIP(0);
+    putSettingBytes("wifi", "fast", &record, sizeof(record));
+}
+
+// Connect to WiFi using saved credentials
+bool connectToWiFi()
+{
+    String ssid = getSettingString("wifi", "ssid");
     
     if (ssid.length() == 0)
     {
-        Logger.println("📡 No saved WiFi credentials found");
+        LOG_INFO("📡 No saved WiFi credentials found");
         return false;
     }
     
-    Logger.printf("📡 Starting WiFi connection to: %s\n", ssid.c_str());
+    LOG_INFO("📡 Starting WiFi connection to: %s\n", ssid.c_str());
     
     WiFi.mode(WIFI_STA);
-    WiFi.begin(ssid.c_str(), password.c_str());
+    FastConnectRecord record;
+    bool haveRecord = getSettingBytes("wifi", "fast", &record, sizeof(record)) == sizeof(record) &&
+                      record.version == FAST_CONNECT_VERSION;
+    beginStation(haveRecord ? &record : nullptr);
     
     // Don't wait for connection - let main loop handle status
-    Logger.println("📡 WiFi connection initiated in background");
+    LOG_INFO("📡 WiFi connection initiated in background");
     
     // Return false to indicate we haven't connected yet (will be checked later)
     return false;
 }
 
-// Safer version of configuration portal startup
-bool startConfigPortalSafe()
+// Advance the portal bring-up by at most one WiFi call; each step waits for
+// its delay by returning, so loop() keeps running while the AP starts
+static void processConfigPortal()
 {
-    Logger.println("🔧 Starting WiFi configuration portal (safe mode)...");
+    if (portalState == PORTAL_IDLE || millis() - portalStepTime < portalWaitMs)
+    {
+        return;
+    }
     
-    // First, ensure we're in a clean state
-    Logger.println("🔧 Disconnecting from any existing WiFi...");
-    WiFi.disconnect(true);
-    WiFi.mode(WIFI_OFF);
-    delay(2000);
+    unsigned long stepStart = micros();
+    portalWaitMs = 0;
     
-    // Try to set mode carefully
-    Logger.println("🔧 Setting WiFi mode to AP...");
-    for (int retry = 0; retry < 3; retry++) {
-        if (WiFi.mode(WIFI_AP)) {
-            Logger.println("✅ WiFi mode set to AP");
-            break;
+    switch (portalState)
+    {
+    case PORTAL_IDLE:
+        break;
+        
+    case PORTAL_WIFI_OFF:
+        // First, ensure we're in a clean state
+        LOG_INFO("🔧 Disconnecting from any existing WiFi...");
+        WiFi.disconnect(true);
+        WiFi.mode(WIFI_OFF);
+        portalState = PORTAL_SET_MODE;
+        portalRetries = 0;
+        portalWaitMs = WIFI_PORTAL_OFF_SETTLE_MS;
+        break;
+        
+    case PORTAL_SET_MODE:
+        if (WiFi.mode(WIFI_AP))
+        {
+            LOG_INFO("✅ WiFi mode set to AP");
+            portalState = PORTAL_START_AP;
+            portalRetries = 0;
+            portalWaitMs = WIFI_PORTAL_SETTLE_MS;
         }
-        Logger.printf("⚠️ WiFi mode retry %d/3\n", retry + 1);
-        delay(1000);
-        if (retry == 2) {
-            Logger.println("❌ Failed to set WiFi mode after retries");
-            return false;
+        else if (++portalRetries < WIFI_PORTAL_RETRIES)
+        {
+            LOG_WARN("⚠️ WiFi mode retry %d/%d\n", portalRetries, WIFI_PORTAL_RETRIES);
+            portalWaitMs = WIFI_PORTAL_RETRY_MS;
         }
-    }
-    
-    delay(1000);
-    
-    // Try to start SoftAP carefully
-    Logger.println("🔧 Starting SoftAP...");
-    for (int retry = 0; retry < 3; retry++) {
-        if (WiFi.softAP(WIFI_AP_NAME, WIFI_AP_PASSWORD)) {
-            Logger.println("✅ SoftAP started successfully");
-            isConfigMode = true;
-            break;
+        else
+        {
+            LOG_ERROR("❌ Failed to set WiFi mode after retries");
+            portalState = PORTAL_IDLE;
+        }
+        break;
+        
+    case PORTAL_START_AP:
+        if (WiFi.softAP(WIFI_AP_NAME, WIFI_AP_PASSWORD))
+        {
+            LOG_INFO("✅ SoftAP started successfully");
+            portalState = PORTAL_START_SERVICES;
+            portalWaitMs = WIFI_PORTAL_SETTLE_MS;
         }
-        Logger.printf("⚠️ SoftAP retry %d/3\n", retry + 1);
-        delay(1000);
-        if (retry == 2) {
-            Logger.println("❌ Failed to start SoftAP after retries");
-            return false;
+        else if (++portalRetries < WIFI_PORTAL_RETRIES)
+        {
+            LOG_WARN("⚠️ SoftAP retry %d/%d\n", portalRetries, WIFI_PORTAL_RETRIES);
+            portalWaitMs = WIFI_PORTAL_RETRY_MS;
         }
+        else
+        {
+            LOG_ERROR("❌ Failed to start SoftAP after retries");
+            portalState = PORTAL_IDLE;
+        }
+        break;
+        
+    case PORTAL_START_SERVICES:
+    {
+        // Now setup the web server and DNS
+        IPAddress apIP = WiFi.softAPIP();
+        LOG_INFO("📡 WiFi configuration portal started\n");
+        LOG_INFO("AP Name: %s\n", WIFI_AP_NAME);
+        LOG_INFO("AP Password: %s\n", WIFI_AP_PASSWORD);
+        LOG_INFO("AP IP: %s\n", apIP.toString().c_str());
+        LOG_INFO("Connect to '%s' and go to %s to configure WiFi\n", WIFI_AP_NAME, apIP.toString().c_str());
+        
+        // Start DNS server for captive portal
+        dnsServer.start(53, "*", apIP);
+        
+        startWebServer();
+        isConfigMode = true;
+        portalStartTime = millis();
+        portalState = PORTAL_IDLE;
+
+        // This pass counts up to here; the rest of it is not the bring-up
+        portalMaxLoopUs = max(portalMaxLoopUs, micros() - wifiLoopEntryUs);
+        portalMaxLoopTime.set((int32_t)portalMaxLoopUs);
+        LOG_INFO("📡 Portal up %lu ms after the bring-up began, longest loop() pass meanwhile %lu us\n",
+                 (micros() - portalBringUpUs) / 1000, portalMaxLoopUs);
+        break;
+    }
     }
     
-    delay(1000);
-    
-    // Now setup the web server and DNS
-    IPAddress apIP = WiFi.softAPIP();
-    Logger.printf("📡 WiFi configuration portal started\n");
-    Logger.printf("AP Name: %s\n", WIFI_AP_NAME);
-    Logger.printf("AP Password: %s\n", WIFI_AP_PASSWORD);
-    Logger.printf("AP IP: %s\n", apIP.toString().c_str());
-    Logger.printf("Connect to '%s' and go to %s to configure WiFi\n", WIFI_AP_NAME, apIP.toString().c_str());
-    
-    // Start DNS server for captive portal
-    dnsServer.start(53, "*", apIP);
-    
-    // Setup web server routes
-    server.on("/", handleRoot);
-    server.on("/save", HTTP_POST, handleSave);
-    server.on("/logs", handleLogs);
-    server.onNotFound([]() {
-        server.sendHeader("Location", "/", true);
-        server.send(302, "text/plain", "");
-    });
+    portalStepTime = millis();
+    portalStepDuration.record(micros() - stepStart);
+}
+
+// Safer version of configuration portal startup: begins the bring-up, which
+// handleWiFiLoop() then advances step by step
+bool startConfigPortalSafe()
+{
+    if (portalState != PORTAL_IDLE || isConfigMode)
+    {
+        return false;
+    }
     
-    server.begin();
-    Logger.println("📱 Configuration web server started");
+    LOG_INFO("🔧 Starting WiFi configuration portal (safe mode)...");
+    portalState = PORTAL_WIFI_OFF;
+    portalWaitMs = 0;
+    portalBringUpUs = wifiLoopEntryUs ? wifiLoopEntryUs : micros();
+    portalMaxLoopUs = 0;
     return true;
 }
 
 // Start WiFi configuration portal (legacy function)
 void startConfigPortal()
 {
-    if (!startConfigPortalSafe()) {
-        Logger.println("❌ Configuration portal startup failed");
-        return;
-    }
-    
-    IPAddress apIP = WiFi.softAPIP();
-    Logger.printf("📡 WiFi configuration portal started\n");
-    Logger.printf("AP Name: %s\n", WIFI_AP_NAME);
-    Logger.printf("AP Password: %s\n", WIFI_AP_PASSWORD);
-    Logger.printf("AP IP: %s\n", apIP.toString().c_str());
-    Logger.printf("Connect to '%s' and go to %s to configure WiFi\n", WIFI_AP_NAME, apIP.toString().c_str());
-    
-    // Start DNS server for captive portal
-    dnsServer.start(53, "*", apIP);
-    
-    // Setup web server routes
-    server.on("/", handleRoot);
-    server.on("/save", HTTP_POST, handleSave);
-    server.on("/logs", handleLogs);
-    server.onNotFound([]() {
-        server.sendHeader("Location", "/", true);
-        server.send(302, "text/plain", "");
-    });
-    
-    server.begin();
-    Logger.println("📱 Configuration web server started");
+    startConfigPortalSafe();
 }
 
 // Initialize WiFi with auto-connect or configuration portal
 void initWiFi(WiFiConnectedCallback onConnected)
 {
-    Logger.printf("🔧 Starting WiFi initialization (non-blocking)...\n");
+    LOG_INFO("🔧 Starting WiFi initialization (non-blocking)...\n");
     
     // Store the callback for later use
     wifiConnectedCallback = onConnected;
     
     // Try to connect with saved credentials first (non-blocking)
-    Logger.println("🔧 Checking for saved credentials...");
+    LOG_INFO("🔧 Checking for saved credentials...");
     connectToWiFi(); // This now starts connection in background
     
     // WiFi connection status will be handled in handleWiFiLoop()
     isConfigMode = false;
-    Logger.println("📡 WiFi initialization complete - connection status will be monitored in background");
+    LOG_INFO("📡 WiFi initialization complete - connection status will be monitored in background");
 }
 
 // Configure Over-The-Air (OTA) updates - setup only, begin() called when WiFi ready
@@ -237,25 +554,28 @@ void initOTA()
     ArduinoOTA.setPort(OTA_PORT);
     
     // Minimal callbacks
-    ArduinoOTA.onStart([]() { Logger.println("OTA Start"); });
-    ArduinoOTA.onEnd([]() { Logger.println("OTA End"); });
-    ArduinoOTA.onError([](ota_error_t error) { Logger.printf("OTA Error: %u\n", error); });
+    ArduinoOTA.onStart([]() {
+        LOG_INFO("OTA Start");
+        flushSettings();
+    });
+    ArduinoOTA.onEnd([]() { LOG_INFO("OTA End"); });
+    ArduinoOTA.onError([](ota_error_t error) { LOG_INFO("OTA Error: %u\n", error); });
     
-    Logger.println("🔄 OTA configuration complete - will start when WiFi is ready");
+    LOG_INFO("🔄 OTA configuration complete - will start when WiFi is ready");
 }
 
 // Start OTA service when WiFi is ready
 void startOTA()
 {
     ArduinoOTA.begin();
-    Logger.printf("✅ OTA Ready: %s:%d\n", WiFi.localIP().toString().c_str(), OTA_PORT);
+    LOG_INFO("✅ OTA Ready: %s:%d\n", WiFi.localIP().toString().c_str(), OTA_PORT);
 }
 
 // Stop OTA service when WiFi changes
 void stopOTA()
 {
     ArduinoOTA.end();
-    Logger.println("🔄 OTA stopped due to WiFi change");
+    LOG_INFO("🔄 OTA stopped due to WiFi change");
 }
 
 // Handle WiFi loop processing (call this in main loop)
@@ -265,11 +585,33 @@ void handleWiFiLoop()
     static bool otaStarted = false;
     static unsigned long connectionStartTime = 0;
     
-    if (isConfigMode)
+    unsigned long entryUs = micros();
+    if (portalState != PORTAL_IDLE)
     {
-        // Handle DNS and web server requests
+        portalMaxLoopUs = max(portalMaxLoopUs, entryUs - wifiLoopEntryUs);
+    }
+    wifiLoopEntryUs = entryUs;
+    
+    // Credentials posted to /save: store them, then restart once the reply is out
+    if (credentialsPending && restartTime == 0)
+    {
+        saveWiFiCredentials(pendingSsid, pendingPassword);
+        restartTime = millis();
+    }
+    if (restartTime != 0 && millis() - restartTime >= 1000)
+    {
+        isConfigMode = false;
+        ESP.restart();
+    }
+    
+    if (portalState != PORTAL_IDLE)
+    {
+        processConfigPortal();
+    }
+    else if (isConfigMode)
+    {
+        // Handle DNS requests (the web server runs on its own task)
         dnsServer.processNextRequest();
-        server.handleClient();
         
         // Start OTA in AP mode if not already started
         if (!otaStarted)
@@ -281,25 +623,55 @@ void handleWiFiLoop()
         // Optional: Log periodic reminder about configuration portal (every 5 minutes)
         if (portalStartTime > 0 && (millis() - portalStartTime) % 300000UL == 0)
         {
-            Logger.printf("📱 WiFi configuration portal still active - connect to '%s' to configure\n", WIFI_AP_NAME);
+            LOG_INFO("📱 WiFi configuration portal still active - connect to '%s' to configure\n", WIFI_AP_NAME);
         }
     }
     else if (WiFi.getMode() == WIFI_STA)
     {
+        // The saved BSSID/channel did not work out (AP moved or replaced): scan instead
+        if (fastConnectActive && WiFi.status() != WL_CONNECTED &&
+            (millis() - connectBeginTime > WIFI_FAST_CONNECT_TIMEOUT_MS ||
+             WiFi.status() == WL_NO_SSID_AVAIL || WiFi.status() == WL_CONNECT_FAILED))
+        {
+            LOG_WARN("⚠️ Fast reconnect failed after %lu ms - scanning\n", millis() - connectBeginTime);
+            fastConnectFallbacks.add();
+            putSettingBytes("wifi", "fast", "", 0);
+            WiFi.disconnect();
+            beginStation(nullptr);
+            connectionStartTime = 0;
+        }
+        
         // Check if we're trying to connect and handle status
         if (WiFi.status() == WL_CONNECTED && !connectionLogged)
         {
-            Logger.printf("✅ WiFi connected successfully!\n");
-            Logger.printf("IP Address: %s\n", WiFi.localIP().toString().c_str());
-            Logger.printf("Signal Strength: %d dBm\n", WiFi.RSSI());
+            unsigned long connectedTime = millis();
+            connectTime.set((int32_t)(connectedTime - connectBeginTime));
+            if (bootToConnectTime.get() == 0)
+            {
+                bootToConnectTime.set((int32_t)connectedTime);
+            }
+            
+            LOG_INFO("✅ WiFi connected successfully!\n");
+            LOG_INFO("Connected in %lu ms (%s), %lu ms after boot\n", connectedTime - connectBeginTime,
+                     fastConnectActive ? "fast reconnect" : "full scan", connectedTime);
+            LOG_INFO("IP Address: %s\n", WiFi.localIP().toString().c_str());
+            LOG_INFO("Signal Strength: %d dBm\n", WiFi.RSSI());
+            if (fastConnectActive)
+            {
+                fastConnects.add();
+            }
+            saveFastConnectRecord();
+            fastConnectActive = false;
             
             // Call the user-provided callback if set
             if (wifiConnectedCallback != nullptr)
             {
-                Logger.println("📞 Calling WiFi connected callback...");
+                LOG_INFO("📞 Calling WiFi connected callback...");
                 wifiConnectedCallback();
             }
             
+            startWebServer();
+            
             // Start OTA now that we're connected
             if (!otaStarted)
             {
@@ -315,7 +687,7 @@ void handleWiFiLoop()
         else if (WiFi.status() != WL_CONNECTED && connectionStartTime > 0 && 
                  (millis() - connectionStartTime) > 30000) // 30 second timeout
         {
-            Logger.println("❌ WiFi connection timeout - starting configuration portal");
+            LOG_ERROR("❌ WiFi connection timeout - starting configuration portal");
             
             // Stop OTA if it was running in STA mode
             if (otaStarted)
@@ -327,11 +699,8 @@ void handleWiFiLoop()
             connectionStartTime = 0;
             connectionLogged = false;
             
-            // Start config portal since connection failed
-            if (startConfigPortalSafe()) {
-                portalStartTime = millis();
-                // OTA will be restarted in AP mode above
-            }
+            // Start config portal since connection failed (OTA will be restarted in AP mode above)
+            startConfigPortalSafe();
         }
     }
     
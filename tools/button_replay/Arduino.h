@@ -0,0 +1,50 @@
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the Arduino/FreeRTOS calls button_input.cpp makes (button_replay only)
+ *
+ * Pin levels live in simulatedLevels[]; attachInterruptArg() records the
+ * handler so the replay can fire the real ISR for each edge.
+ */
+
+#ifndef BUTTON_REPLAY_ARDUINO_H
+#define BUTTON_REPLAY_ARDUINO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0x01
+#define INPUT_PULLUP 0x05
+#define CHANGE 0x03
+#define IRAM_ATTR
+
+#define SIMULATED_PINS 40
+#define GPIO_IS_VALID_GPIO(pin) ((pin) < SIMULATED_PINS)
+#define GPIO_IS_VALID_OUTPUT_GPIO(pin) ((pin) < 34)
+#define digitalPinToInterrupt(pin) (pin)
+
+// Single-threaded replay: critical sections have nothing to exclude
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+
+typedef void (*SimulatedIsr)(void* arg);
+
+inline int simulatedLevels[SIMULATED_PINS];
+inline SimulatedIsr simulatedIsrs[SIMULATED_PINS];
+inline void* simulatedIsrArgs[SIMULATED_PINS];
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t pin) { return simulatedLevels[pin]; }
+
+inline void attachInterruptArg(uint8_t pin, SimulatedIsr isr, void* arg, int)
+{
+    simulatedIsrs[pin] = isr;
+    simulatedIsrArgs[pin] = arg;
+}
+
+#endif // BUTTON_REPLAY_ARDUINO_H
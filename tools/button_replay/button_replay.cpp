@@ -0,0 +1,281 @@
+/**
+ * @file button_replay.cpp
+ * @brief Host harness for the button capture: bouncy edge traces in, timing error out
+ *
+ * Build and run from the repository root (the headers in this directory
+ * stand in for Arduino, esp_timer, the GPIO HAL and the logger):
+ *
+ *     g++ -O2 -std=gnu++17 -Itools/button_replay -Iinclude tools/button_replay/button_replay.cpp \
+ *         src/button_input.cpp -o button_replay
+ *     ./button_replay [presses] [seed]
+ *     ./button_replay --trace edges.txt
+ *
+ * The default mode generates presses on two pins, each press and release
+ * followed by 0-8 contact bounces within BOUNCE_SPAN_US. Some taps are
+ * shorter than BUTTON_DEBOUNCE_US, so the release falls inside the lockout
+ * and is recovered by processButtonInput() or, if loop() stalls past the
+ * next press, by the ISR on that press. Every edge fires the real
+ * ISR ISR_LATENCY_US after it happens; loop() runs every 1-20 ms with
+ * occasional stalls of up to LOOP_STALL_US. Each event is matched to the
+ * true transition it reports, and the report gives accepted/bounce counts
+ * and the timestamp error of every event, split into those stamped at the
+ * transition itself and those whose transition fell inside the lockout and
+ * was stamped by the edge that settled it. For comparison it also gives the
+ * error a poll-time stamp (the old millis()-in-loop approach) would have had.
+ * It exits 1 if a transition is lost, an event reports one that did not
+ * happen, or a stamp is off by more than the bounce span.
+ *
+ * --trace replays recorded edges, one "<microseconds> <pin> <level>" per
+ * line, and prints the accepted events.
+ *
+ * @date 2025
+ */
+
+#include "button_input.h"
+#include <esp_timer.h>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define ISR_LATENCY_US 3
+#define BOUNCE_SPAN_US 5000
+#define LOOP_STALL_US 250000
+
+struct Edge
+{
+    int64_t us;
+    uint8_t pin;
+    int level;
+};
+
+struct Transition
+{
+    int64_t us;
+    bool pressed;
+    bool matched;
+};
+
+struct ErrorStats
+{
+    uint32_t count = 0;
+    int64_t total = 0;
+    int64_t worst = 0;
+
+    void add(int64_t error)
+    {
+        count++;
+        total += error;
+        worst = std::max(worst, error);
+    }
+
+    void print(const char* label) const
+    {
+        printf("  %-28s %8u events  mean %9.1f us  max %9lld us\n", label, (unsigned)count,
+               count ? (double)total / count : 0.0, (long long)worst);
+    }
+};
+
+static const uint8_t pins[] = {32, 33};
+static const int pinCount = sizeof(pins) / sizeof(pins[0]);
+static uint32_t rngState = 1;
+
+static uint32_t nextRandom()
+{
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static int64_t randomBetween(int64_t low, int64_t high)
+{
+    return low + (int64_t)(nextRandom() % (uint32_t)(high - low + 1));
+}
+
+/**
+ * @brief Append one transition and its contact bounce to the edge list
+ */
+static void addBouncyEdge(std::vector<Edge>& edges, uint8_t pin, int64_t us, int level)
+{
+    edges.push_back({us, pin, level});
+    int bounces = (int)randomBetween(0, 4) * 2; // Even, so the contact settles at `level`
+    int64_t t = us;
+    for (int b = 0; b < bounces; b++)
+    {
+        t += randomBetween(50, BOUNCE_SPAN_US / 8);
+        edges.push_back({t, pin, b % 2 == 0 ? !level : level});
+    }
+}
+
+/**
+ * @brief Fire the ISR for one edge, ISR_LATENCY_US after it happened
+ */
+static void fireEdge(const Edge& edge)
+{
+    simulatedLevels[edge.pin] = edge.level;
+    simulatedNowUs = edge.us + ISR_LATENCY_US;
+    simulatedIsrs[edge.pin](simulatedIsrArgs[edge.pin]);
+}
+
+static int replayTrace(const char* path)
+{
+    FILE* file = fopen(path, "r");
+    if (!file)
+    {
+        perror(path);
+        return 2;
+    }
+
+    std::vector<Edge> edges;
+    long long us;
+    int pin;
+    int level;
+    while (fscanf(file, "%lld %d %d", &us, &pin, &level) == 3)
+    {
+        edges.push_back({us, (uint8_t)pin, level ? HIGH : LOW});
+    }
+    fclose(file);
+
+    std::vector<uint8_t> tracePins;
+    for (const Edge& edge : edges)
+    {
+        if (std::find(tracePins.begin(), tracePins.end(), edge.pin) == tracePins.end())
+        {
+            tracePins.push_back(edge.pin);
+            simulatedLevels[edge.pin] = !BUTTON_ACTIVE_LEVEL;
+        }
+    }
+    initButtonInput(tracePins.data(), tracePins.size());
+
+    ButtonEvent event;
+    for (const Edge& edge : edges)
+    {
+        fireEdge(edge);
+        while (popButtonEvent(event))
+        {
+            printf("%lld pin %d %s\n", (long long)event.timestampUs, event.pin, event.pressed ? "press" : "release");
+        }
+    }
+    simulatedNowUs += 2 * BUTTON_DEBOUNCE_US;
+    processButtonInput();
+    while (popButtonEvent(event))
+    {
+        printf("%lld pin %d %s (resync)\n", (long long)event.timestampUs, event.pin,
+               event.pressed ? "press" : "release");
+    }
+
+    ButtonInputStats stats = getButtonInputStats();
+    printf("%u edges: %u accepted, %u bounces, %u resyncs, %u overflows\n", (unsigned)stats.edges,
+           (unsigned)stats.accepted, (unsigned)stats.bounces, (unsigned)stats.resyncs, (unsigned)stats.overflows);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 2 && strcmp(argv[1], "--trace") == 0)
+    {
+        return replayTrace(argv[2]);
+    }
+
+    int presses = argc > 1 ? atoi(argv[1]) : 100000;
+    rngState = argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 10) | 1 : 1;
+
+    // Build each pin's presses and the edges they produce
+    std::vector<Edge> edges;
+    std::vector<Transition> truth[pinCount];
+    for (int p = 0; p < pinCount; p++)
+    {
+        simulatedLevels[pins[p]] = !BUTTON_ACTIVE_LEVEL;
+        int64_t t = 100000;
+        for (int i = 0; i < presses / pinCount; i++)
+        {
+            t += randomBetween(60000, 400000);
+            int64_t hold = nextRandom() % 8 == 0 ? randomBetween(BOUNCE_SPAN_US + 1000, BUTTON_DEBOUNCE_US - 1000)
+                                                 : randomBetween(40000, 250000);
+            addBouncyEdge(edges, pins[p], t, BUTTON_ACTIVE_LEVEL);
+            truth[p].push_back({t, true, false});
+            t += hold;
+            addBouncyEdge(edges, pins[p], t, !BUTTON_ACTIVE_LEVEL);
+            truth[p].push_back({t, false, false});
+            t += BOUNCE_SPAN_US;
+        }
+    }
+    std::stable_sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return a.us < b.us; });
+    initButtonInput(pins, pinCount);
+
+    ErrorStats onTime;
+    ErrorStats late;
+    ErrorStats pollError;
+    uint32_t wrong = 0;
+    size_t cursor[pinCount] = {};
+    int64_t loopUs = 0;
+    size_t next = 0;
+    ButtonEvent event;
+
+    while (next < edges.size())
+    {
+        loopUs += nextRandom() % 20 == 0 ? randomBetween(20000, LOOP_STALL_US) : randomBetween(1000, 20000);
+        while (next < edges.size() && edges[next].us <= loopUs)
+        {
+            fireEdge(edges[next++]);
+        }
+
+        simulatedNowUs = loopUs;
+        processButtonInput();
+        while (popButtonEvent(event))
+        {
+            int p = event.pin == pins[0] ? 0 : 1;
+            std::vector<Transition>& list = truth[p];
+
+            // The event reports the latest transition of its polarity at or before its timestamp
+            size_t match = cursor[p];
+            while (match < list.size() && list[match].us <= event.timestampUs)
+            {
+                match++;
+            }
+            while (match > cursor[p] && list[match - 1].pressed != event.pressed)
+            {
+                match--;
+            }
+            if (match == cursor[p])
+            {
+                wrong++;
+                continue;
+            }
+            Transition& transition = list[match - 1];
+            transition.matched = true;
+            cursor[p] = match;
+
+            // A transition hidden by the lockout is stamped by the edge that settled it
+            int64_t error = event.timestampUs - transition.us;
+            (error <= ISR_LATENCY_US ? onTime : late).add(error);
+            pollError.add(loopUs - transition.us);
+            if (error > BOUNCE_SPAN_US + ISR_LATENCY_US)
+            {
+                wrong++;
+            }
+        }
+    }
+
+    uint32_t lost = 0;
+    for (int p = 0; p < pinCount; p++)
+    {
+        for (const Transition& transition : truth[p])
+        {
+            lost += transition.matched ? 0 : 1;
+        }
+    }
+
+    ButtonInputStats stats = getButtonInputStats();
+    printf("%d presses on %d pins, %zu edges, debounce %d us, ISR latency %d us\n", presses - presses % pinCount,
+           pinCount, edges.size(), BUTTON_DEBOUNCE_US, ISR_LATENCY_US);
+    printf("  edges %u, accepted %u, bounces %u, resyncs %u, overflows %u\n", (unsigned)stats.edges,
+           (unsigned)stats.accepted, (unsigned)stats.bounces, (unsigned)stats.resyncs, (unsigned)stats.overflows);
+    onTime.print("stamped at the edge");
+    late.print("stamped by settling edge");
+    pollError.print("poll-time stamp (old loop)");
+    printf("  transitions lost %u, wrong or late events %u\n", (unsigned)lost, (unsigned)wrong);
+    return lost == 0 && wrong == 0 ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+/**
+ * @file esp_timer.h
+ * @brief Host stand-in for esp_timer_get_time(), driven by the replay (button_replay only)
+ */
+
+#ifndef BUTTON_REPLAY_ESP_TIMER_H
+#define BUTTON_REPLAY_ESP_TIMER_H
+
+#include <stdint.h>
+
+inline int64_t simulatedNowUs = 0;
+
+inline int64_t esp_timer_get_time() { return simulatedNowUs; }
+
+#endif // BUTTON_REPLAY_ESP_TIMER_H
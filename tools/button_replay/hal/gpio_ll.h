@@ -0,0 +1,17 @@
+/**
+ * @file gpio_ll.h
+ * @brief Host stand-in for the GPIO register read in the ISR (button_replay only)
+ */
+
+#ifndef BUTTON_REPLAY_GPIO_LL_H
+#define BUTTON_REPLAY_GPIO_LL_H
+
+#include "Arduino.h"
+
+typedef int gpio_num_t;
+struct SimulatedGpio {};
+inline SimulatedGpio GPIO;
+
+inline int gpio_ll_get_level(SimulatedGpio*, gpio_num_t pin) { return simulatedLevels[pin]; }
+
+#endif // BUTTON_REPLAY_GPIO_LL_H
@@ -0,0 +1,16 @@
+/**
+ * @file logging.h
+ * @brief Host stand-in for the logging facade: lines go to stderr (button_replay only)
+ */
+
+#ifndef BUTTON_REPLAY_LOGGING_H
+#define BUTTON_REPLAY_LOGGING_H
+
+#include <stdio.h>
+
+#define LOG_ERROR(...) fprintf(stderr, __VA_ARGS__)
+#define LOG_WARN(...) fprintf(stderr, __VA_ARGS__)
+#define LOG_INFO(...) fprintf(stderr, __VA_ARGS__)
+#define LOG_DEBUG(...) ((void)0)
+
+#endif // BUTTON_REPLAY_LOGGING_H
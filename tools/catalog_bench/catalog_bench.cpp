@@ -0,0 +1,181 @@
+/**
+ * @file catalog_bench.cpp
+ * @brief Host benchmark of the catalog download: bytes on the wire and parse time
+ *
+ * Build and run from the repository root (ArduinoJson is the copy PlatformIO
+ * fetched into .pio/libdeps):
+ *
+ *     g++ -O2 -std=gnu++17 -Iinclude -I.pio/libdeps/esp32dev/ArduinoJson/src \
+ *         tools/catalog_bench/catalog_bench.cpp src/catalog_stream.cpp src/inflate_stream.cpp \
+ *         -lz -o catalog_bench
+ *     ./catalog_bench [entries ...]
+ *
+ * For each size (default 50, 500 and 5000 entries) a synthetic catalog is
+ * built with absolute paths, as served today, and with relative paths under
+ * "_base"; each is sent raw and gzipped (-9) through parseCatalogStream() in
+ * 1460-byte reads, the way the device receives it. Both forms must resolve
+ * to the same entries. Throughput is quoted against the absolute-path JSON
+ * so the four forms compare directly.
+ *
+ * @date 2025
+ */
+
+#include "catalog_stream.h"
+#include <zlib.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#define BENCH_URL_BASE "https://raw.githubusercontent.com/jeff-hamm/pheromone-dating/refs/heads/main/audio/"
+#define BENCH_SEGMENT 1460
+
+struct MemorySource
+{
+    const std::string* data;
+    size_t pos;
+};
+
+struct EntryTally
+{
+    int count;
+    uint32_t hash;
+};
+
+static int readMemory(uint8_t* buffer, size_t length, void* context)
+{
+    MemorySource* source = (MemorySource*)context;
+    size_t n = source->data->size() - source->pos;
+    if (n > length)
+    {
+        n = length;
+    }
+    if (n > BENCH_SEGMENT)
+    {
+        n = BENCH_SEGMENT;
+    }
+    memcpy(buffer, source->data->data() + source->pos, n);
+    source->pos += n;
+    return (int)n;
+}
+
+static uint32_t hashString(uint32_t hash, const char* text)
+{
+    while (*text)
+    {
+        hash = (hash ^ (uint8_t)*text++) * 16777619u;
+    }
+    return hash;
+}
+
+static bool tallyEntry(const char* key, const char* description, const char* type, const char* path, void* context)
+{
+    EntryTally* tally = (EntryTally*)context;
+    tally->count++;
+    tally->hash = hashString(hashString(hashString(hashString(tally->hash, key), description), type), path);
+    return true;
+}
+
+static std::string makeCatalog(int entries, bool relative)
+{
+    std::string json = "{\n";
+    if (relative)
+    {
+        json += "  \"" CATALOG_BASE_KEY "\": \"" BENCH_URL_BASE "\",\n";
+    }
+    for (int i = 0; i < entries; i++)
+    {
+        char entry[320];
+        snprintf(entry, sizeof(entry),
+                 "  \"%d\": {\"description\": \"Game sound %d\", \"type\": \"audio\", \"path\": \"%ssound_%05d.mp3\"}%s\n",
+                 1000 + i * 7, i, relative ? "" : BENCH_URL_BASE, i, i + 1 < entries ? "," : "");
+        json += entry;
+    }
+    return json + "}\n";
+}
+
+static std::string gzip(const std::string& text)
+{
+    z_stream z = {};
+    deflateInit2(&z, 9, Z_DEFLATED, 16 + 15, 9, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&z, text.size()), '\0');
+    z.next_in = (Bytef*)text.data();
+    z.avail_in = text.size();
+    z.next_out = (Bytef*)&out[0];
+    z.avail_out = out.size();
+    deflate(&z, Z_FINISH);
+    out.resize(z.total_out);
+    deflateEnd(&z);
+    return out;
+}
+
+/**
+ * @brief Parse a served catalog; prints one report line
+ * @return The entry tally, count -1 on a parse error
+ */
+static EntryTally benchParse(const char* label, const std::string& served, size_t rawSize)
+{
+    const int runs = 20;
+    double best = 1e9;
+    EntryTally tally = {};
+    for (int run = 0; run < runs; run++)
+    {
+        MemorySource source = {&served, 0};
+        CatalogReader reader;
+        tally = EntryTally{0, 2166136261u};
+
+        auto start = std::chrono::steady_clock::now();
+        const char* failure = reader.begin(readMemory, &source, 0xFFFFFFFF)
+                                  ? parseCatalogStream(reader, tallyEntry, &tally)
+                                  : reader.error();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (failure)
+        {
+            printf("  %-14s parse failed: %s\n", label, failure);
+            tally.count = -1;
+            return tally;
+        }
+        if (seconds < best)
+        {
+            best = seconds;
+        }
+    }
+
+    printf("  %-14s %8zu bytes on the wire (%5.1f%%)  %8.3f ms  %6.1f MB/s of JSON\n", label, served.size(),
+           100.0 * served.size() / rawSize, best * 1000, rawSize / best / 1e6);
+    return tally;
+}
+
+int main(int argc, char** argv)
+{
+    int defaults[] = {50, 500, 5000};
+    int sizes = argc > 1 ? argc - 1 : 3;
+
+    for (int i = 0; i < sizes; i++)
+    {
+        int entries = argc > 1 ? atoi(argv[i + 1]) : defaults[i];
+        std::string absolute = makeCatalog(entries, false);
+        std::string relative = makeCatalog(entries, true);
+
+        printf("%d entries, %zu bytes of JSON as served today:\n", entries, absolute.size());
+        EntryTally reference = benchParse("absolute", absolute, absolute.size());
+        EntryTally results[] = {
+            benchParse("absolute gzip", gzip(absolute), absolute.size()),
+            benchParse("_base", relative, absolute.size()),
+            benchParse("_base gzip", gzip(relative), absolute.size()),
+        };
+        for (const EntryTally& result : results)
+        {
+            if (result.count != reference.count || result.hash != reference.hash)
+            {
+                fprintf(stderr, "entries differ between forms\n");
+                return 1;
+            }
+        }
+    }
+
+    printf("parser memory: %d-byte text buffer, plus the %d-byte inflate window for gzip, at any catalog size\n",
+           CATALOG_TEXT_BUFFER, INFLATE_WINDOW_SIZE);
+    return 0;
+}
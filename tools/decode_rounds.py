@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""Decode a round history file (rounds.bin) written by round_history.cpp.
+
+Usage:
+    decode_rounds.py rounds.bin            # one CSV row per round, summary on stderr
+    curl http://<device>/rounds.bin | decode_rounds.py -
+
+The record layout mirrors RoundRecord in include/round_history.h.
+"""
+
+import struct
+import sys
+import zlib
+
+RECORD_MAGIC = 0x5244
+RECORD_SIZE = 64
+MAX_PLAYERS = 6
+RECORD = struct.Struct("<HBBBBHIIIiqI6iI")
+OUTCOMES = {0: "none", 1: "yes", 2: "no", 3: "too_slow", 4: "timeout"}
+
+assert RECORD.size == RECORD_SIZE
+
+
+def decode(data):
+    """Yield (record dict or None, offset) for each 64-byte slot; None marks a bad record."""
+    for offset in range(0, len(data) - RECORD_SIZE + 1, RECORD_SIZE):
+        raw = data[offset:offset + RECORD_SIZE]
+        fields = RECORD.unpack(raw)
+        (magic, version, station, outcome, players, boot, sequence, pressed, yes,
+         decide_us, start_us, unix_time) = fields[:12]
+        offsets = fields[12:12 + MAX_PLAYERS]
+        crc = fields[-1]
+        if magic != RECORD_MAGIC or zlib.crc32(raw[:-4]) != crc:
+            yield None, offset
+            continue
+        yield {
+            "boot": boot,
+            "sequence": sequence,
+            "version": version,
+            "station": station,
+            "outcome": OUTCOMES.get(outcome, str(outcome)),
+            "players": players,
+            "pressed_mask": pressed,
+            "yes_mask": yes,
+            "start_us": start_us,
+            "decide_us": decide_us,
+            "unix_time": unix_time,
+            "press_us": [offsets[i] if pressed >> i & 1 else None
+                         for i in range(min(players, MAX_PLAYERS))],
+        }, offset
+
+
+def main(argv):
+    if len(argv) != 2:
+        print(__doc__, file=sys.stderr)
+        return 2
+
+    data = sys.stdin.buffer.read() if argv[1] == "-" else open(argv[1], "rb").read()
+
+    rounds = []
+    bad = 0
+    print("boot,sequence,station,outcome,players,unix_time,start_us,decide_us,"
+          "spread_us,answers,press_us")
+    for record, offset in decode(data):
+        if record is None:
+            bad += 1
+            print(f"# bad record at offset {offset}", file=sys.stderr)
+            continue
+        rounds.append(record)
+        presses = [p for p in record["press_us"] if p is not None]
+        spread = max(presses) - min(presses) if presses else 0
+        answers = "".join(
+            ("Y" if record["yes_mask"] >> i & 1 else "N") if record["pressed_mask"] >> i & 1 else "-"
+            for i in range(record["players"]))
+        press_us = " ".join("-" if p is None else str(p) for p in record["press_us"])
+        print(f'{record["boot"]},{record["sequence"]},{record["station"]},{record["outcome"]},'
+              f'{record["players"]},{record["unix_time"]},{record["start_us"]},'
+              f'{record["decide_us"]},{spread},{answers},{press_us}')
+
+    # Summary: outcome rates and the first-to-last press spread of answered rounds
+    total = len(rounds)
+    if total:
+        counts = {}
+        for r in rounds:
+            counts[r["outcome"]] = counts.get(r["outcome"], 0) + 1
+        spreads = sorted(
+            max(p) - min(p)
+            for p in ([x for x in r["press_us"] if x is not None] for r in rounds)
+            if len(p) > 1)
+        print(f"# {total} rounds, {bad} bad records", file=sys.stderr)
+        for outcome, count in sorted(counts.items()):
+            print(f"#   {outcome}: {count} ({100.0 * count / total:.1f}%)", file=sys.stderr)
+        if spreads:
+            print(f"#   spread median {spreads[len(spreads) // 2] / 1000:.1f} ms, "
+                  f"max {spreads[-1] / 1000:.1f} ms", file=sys.stderr)
+    return 0 if bad == 0 else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,252 @@
+/**
+ * @file dsp_bench.cpp
+ * @brief Host benchmark of the fixed-point kernels against the float path
+ *
+ * Build and run from the repository root:
+ *
+ *     g++ -O2 -std=gnu++17 -Iinclude tools/dsp_bench/dsp_bench.cpp src/dsp_kernels.cpp -o dsp_bench
+ *     ./dsp_bench [block frames]
+ *
+ * Each kernel in dsp_kernels.h is timed on stereo blocks (default 256
+ * frames, AUDIO_MIX_BLOCK_FRAMES) next to a float loop doing the same job
+ * the way the old output path did: convert to float, multiply, convert
+ * back. The report gives samples per second for both, the speedup, and the
+ * largest difference between the two outputs in 16-bit LSBs.
+ *
+ * Host numbers only rank the kernels: a desktop CPU vectorizes both paths,
+ * the ESP32's single-precision FPU does not.
+ *
+ * @date 2025
+ */
+
+#include "dsp_kernels.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define BENCH_FRAC_BITS 4   // AUDIO_MIX_FRAC_BITS
+
+static size_t frames = 256;
+static std::vector<int16_t> source;
+static std::vector<int16_t> other;
+static std::vector<int16_t> fixedOut;
+static std::vector<int16_t> floatOut;
+static std::vector<int32_t> fixedBus;
+static std::vector<float> floatBus;
+static volatile uint32_t sink;
+
+static inline int16_t floatTo16(float x)
+{
+    x = x > 32767.0f ? 32767.0f : (x < -32768.0f ? -32768.0f : x);
+    return (int16_t)lrintf(x);
+}
+
+/**
+ * @brief Time `run` over enough blocks for a stable figure
+ * @return Samples per second, best of five
+ */
+template <typename F>
+static double samplesPerSecond(F run)
+{
+    const int blocks = 20000;
+    double best = 1e9;
+    for (int attempt = 0; attempt < 5; attempt++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int b = 0; b < blocks; b++)
+        {
+            run();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds < best)
+        {
+            best = seconds;
+        }
+    }
+    return (double)blocks * frames * 2 / best;
+}
+
+static int maxDifference(const std::vector<int16_t>& a, const std::vector<int16_t>& b)
+{
+    int worst = 0;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        int d = abs(a[i] - b[i]);
+        worst = d > worst ? d : worst;
+    }
+    return worst;
+}
+
+static void report(const char* name, double fixedRate, double floatRate, int lsb)
+{
+    printf("  %-22s %8.1f Msamples/s fixed  %8.1f Msamples/s float  %5.2fx  max diff %d LSB\n", name,
+           fixedRate / 1e6, floatRate / 1e6, fixedRate / floatRate, lsb);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1)
+    {
+        frames = strtoul(argv[1], nullptr, 10);
+    }
+    if (frames == 0)
+    {
+        fprintf(stderr, "usage: %s [block frames]\n", argv[0]);
+        return 2;
+    }
+
+    size_t count = frames * 2;
+    source.resize(count);
+    other.resize(count);
+    fixedOut.resize(count);
+    floatOut.resize(count);
+    fixedBus.resize(count);
+    floatBus.resize(count);
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < count; i++)
+    {
+        seed = seed * 1664525 + 1013904223;
+        source[i] = (int16_t)(seed >> 16);
+        seed = seed * 1664525 + 1013904223;
+        other[i] = (int16_t)(seed >> 16);
+    }
+
+    const int32_t gainQ15 = 23170; // -3 dB
+    const float gain = gainQ15 / 32768.0f;
+    printf("%zu-frame stereo blocks, best of 5 x 20000 blocks\n", frames);
+
+    // Plain gain: dspGainQ15 vs AudioPlayer-style float volume
+    double fixedRate = samplesPerSecond([&] {
+        memcpy(fixedOut.data(), source.data(), count * 2);
+        dspGainQ15(fixedOut.data(), count, gainQ15);
+        sink = fixedOut[0];
+    });
+    double floatRate = samplesPerSecond([&] {
+        for (size_t i = 0; i < count; i++)
+        {
+            floatOut[i] = floatTo16(source[i] * gain);
+        }
+        sink = floatOut[0];
+    });
+    report("gain Q15", fixedRate, floatRate, maxDifference(fixedOut, floatOut));
+
+    // Master gain on the bus, then back to 16 bit
+    std::vector<int32_t> baseBus(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        baseBus[i] = source[i] << BENCH_FRAC_BITS;
+        floatBus[i] = source[i];
+    }
+    fixedRate = samplesPerSecond([&] {
+        memcpy(fixedBus.data(), baseBus.data(), count * 4);
+        dspGainQ31(fixedBus.data(), count, gainQ15 << 16);
+        dspReduceTo16(fixedOut.data(), fixedBus.data(), count, BENCH_FRAC_BITS);
+        sink = fixedOut[0];
+    });
+    floatRate = samplesPerSecond([&] {
+        for (size_t i = 0; i < count; i++)
+        {
+            floatOut[i] = floatTo16(floatBus[i] * gain);
+        }
+        sink = floatOut[0];
+    });
+    report("gain Q31 + reduce", fixedRate, floatRate, maxDifference(fixedOut, floatOut));
+
+    // Linear fade-in across the block
+    int32_t step = DSP_Q15_ONE / (int32_t)frames;
+    fixedRate = samplesPerSecond([&] {
+        memcpy(fixedOut.data(), source.data(), count * 2);
+        sink = dspFadeLinearQ15(fixedOut.data(), frames, 2, 0, step, DSP_Q15_ONE);
+    });
+    floatRate = samplesPerSecond([&] {
+        float g = 0.0f;
+        float fstep = step / 32768.0f;
+        for (size_t f = 0; f < frames; f++)
+        {
+            g = g + fstep > 1.0f ? 1.0f : g + fstep;
+            floatOut[2 * f] = floatTo16(source[2 * f] * g);
+            floatOut[2 * f + 1] = floatTo16(source[2 * f + 1] * g);
+        }
+        sink = floatOut[0];
+    });
+    report("linear fade", fixedRate, floatRate, maxDifference(fixedOut, floatOut));
+
+    // Exponential fade-in, 1 ms time constant at 44.1 kHz
+    int32_t coeff = dspExpFadeCoeffQ15(44100, 1.0f);
+    fixedRate = samplesPerSecond([&] {
+        memcpy(fixedOut.data(), source.data(), count * 2);
+        sink = dspFadeExpQ15(fixedOut.data(), frames, 2, 0, DSP_Q15_ONE, coeff);
+    });
+    floatRate = samplesPerSecond([&] {
+        float g = 0.0f;
+        float fcoeff = coeff / 32768.0f;
+        for (size_t f = 0; f < frames; f++)
+        {
+            g += (1.0f - g) * fcoeff;
+            floatOut[2 * f] = floatTo16(source[2 * f] * g);
+            floatOut[2 * f + 1] = floatTo16(source[2 * f + 1] * g);
+        }
+        sink = floatOut[0];
+    });
+    report("exponential fade", fixedRate, floatRate, maxDifference(fixedOut, floatOut));
+
+    // Two-input saturating mix
+    fixedRate = samplesPerSecond([&] {
+        memcpy(fixedOut.data(), source.data(), count * 2);
+        dspMixSaturate16(fixedOut.data(), other.data(), count);
+        sink = fixedOut[0];
+    });
+    floatRate = samplesPerSecond([&] {
+        for (size_t i = 0; i < count; i++)
+        {
+            floatOut[i] = floatTo16((float)source[i] + (float)other[i]);
+        }
+        sink = floatOut[0];
+    });
+    report("saturating mix", fixedRate, floatRate, maxDifference(fixedOut, floatOut));
+
+    // Gained accumulate onto the bus, then round back to 16 bit (two voices)
+    fixedRate = samplesPerSecond([&] {
+        memset(fixedBus.data(), 0, count * 4);
+        dspMixAccumulateQ15(fixedBus.data(), source.data(), count, gainQ15, BENCH_FRAC_BITS);
+        dspMixAccumulateQ15(fixedBus.data(), other.data(), count, gainQ15, BENCH_FRAC_BITS);
+        dspReduceTo16(fixedOut.data(), fixedBus.data(), count, BENCH_FRAC_BITS);
+        sink = fixedOut[0];
+    });
+    floatRate = samplesPerSecond([&] {
+        for (size_t i = 0; i < count; i++)
+        {
+            floatOut[i] = floatTo16(source[i] * gain + other[i] * gain);
+        }
+        sink = floatOut[0];
+    });
+    report("accumulate + reduce", fixedRate, floatRate, maxDifference(fixedOut, floatOut));
+
+    // TPDF dither of the bus down to 16 bit
+    uint32_t fixedRng = 0x2545F491;
+    uint32_t floatRng = 0x2545F491;
+    for (size_t i = 0; i < count; i++)
+    {
+        fixedBus[i] = (source[i] * gainQ15) >> (15 - BENCH_FRAC_BITS);
+    }
+    fixedRate = samplesPerSecond([&] {
+        dspDitherTpdfTo16(fixedOut.data(), fixedBus.data(), count, BENCH_FRAC_BITS, &fixedRng);
+        sink = fixedOut[0];
+    });
+    floatRate = samplesPerSecond([&] {
+        for (size_t i = 0; i < count; i++)
+        {
+            floatRng = floatRng * 1664525 + 1013904223;
+            float a = (floatRng >> 8) * (1.0f / 16777216.0f);
+            floatRng = floatRng * 1664525 + 1013904223;
+            float b = (floatRng >> 8) * (1.0f / 16777216.0f);
+            floatOut[i] = floatTo16(source[i] * gain + (a - b));
+        }
+        sink = floatOut[0];
+    });
+    report("TPDF dither to 16 bit", fixedRate, floatRate, maxDifference(fixedOut, floatOut));
+    return 0;
+}
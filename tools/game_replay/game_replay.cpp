@@ -0,0 +1,568 @@
+/**
+ * @file game_replay.cpp
+ * @brief Host driver for GameEngine: replay recorded rounds and fuzz random ones
+ *
+ * Build and run from the repository root:
+ *
+ *     g++ -O2 -std=gnu++17 -Iinclude tools/game_replay/game_replay.cpp src/game_engine.cpp -lz -o game_replay
+ *     ./game_replay [rounds] [seed]
+ *     ./game_replay --rounds rounds.bin
+ *
+ * Fuzzing generates rounds on eight stations with 1-6 (or 32) players and
+ * timeouts of 1 ms, 100 ms or GAME_TIMEOUT_MS. Presses are stamped up to
+ * 3 ms before loop() feeds them, players change their answers, update()
+ * runs at random points including exactly on and either side of the
+ * timeout, presses arrive while the result sound plays, and one round in
+ * four starts within a couple of timeouts of the 32-bit millis() rollover.
+ * A reference model working in 64-bit time predicts every event; the run
+ * fails on the first event that differs. Rounds are generated in batches
+ * and only the engine's part is timed, giving events/sec and rounds/sec.
+ *
+ * --rounds replays a round history (rounds.bin, see round_history.h):
+ * each record's final presses are fed back at their recorded times and the
+ * engine must reach the recorded outcome. Records of rounds where a player
+ * changed their answer only keep the final press, so such rounds are
+ * replayed from the reconstructed first and final presses.
+ *
+ * @date 2025
+ */
+
+#include "game_engine.h"
+#include <zlib.h>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// Mirror of RoundRecord in round_history.h (which pulls in Arduino headers)
+#define RECORD_MAGIC 0x5244
+#define RECORD_MAX_PLAYERS 6
+
+struct __attribute__((packed)) RecordedRound
+{
+    uint16_t magic;
+    uint8_t version;
+    uint8_t station;
+    uint8_t outcome;
+    uint8_t players;
+    uint16_t bootCount;
+    uint32_t sequence;
+    uint32_t pressedMask;
+    uint32_t yesMask;
+    int32_t decideOffsetUs;
+    int64_t startUs;
+    uint32_t unixTime;
+    int32_t pressOffsetUs[RECORD_MAX_PLAYERS];
+    uint32_t crc32;
+};
+static_assert(sizeof(RecordedRound) == 64, "RecordedRound must match ROUND_RECORD_SIZE");
+
+enum ActionType
+{
+    ACTION_PRESS,
+    ACTION_UPDATE,
+    ACTION_SOUND_FINISHED
+};
+
+struct Action
+{
+    uint8_t type;
+    uint8_t station;
+    uint8_t player;
+    bool answer;
+    uint32_t timeMs;
+};
+
+/**
+ * @brief Compact copy of a GameEvent, for comparing engine and model
+ */
+struct EventRecord
+{
+    uint8_t type;
+    uint8_t station;
+    int8_t player;
+    uint8_t answer;
+    uint8_t outcome;
+    uint32_t timeMs;
+    uint32_t spreadMs;
+    uint32_t pressedMask;
+
+    bool operator==(const EventRecord& other) const
+    {
+        return memcmp(this, &other, sizeof(*this)) == 0;
+    }
+};
+
+static const char* const eventNames[] = {"press", "locked_in", "round_complete", "reset"};
+static const char* const outcomeNames[] = {"none", "yes", "no", "too_slow", "timeout"};
+
+static uint32_t clockMs = 0;
+static std::vector<EventRecord> engineEvents;
+
+static uint32_t readClock(void*)
+{
+    return clockMs;
+}
+
+static void recordEvent(const GameEvent& event, void*)
+{
+    EventRecord record = {};
+    record.type = (uint8_t)event.type;
+    record.station = (uint8_t)event.station;
+    record.player = (int8_t)event.player;
+    record.answer = event.answer;
+    record.outcome = (uint8_t)event.outcome;
+    record.timeMs = event.timeMs;
+    record.spreadMs = event.spreadMs;
+    record.pressedMask = event.pressedMask;
+    engineEvents.push_back(record);
+}
+
+static void printEvent(const char* label, const EventRecord& e)
+{
+    printf("  %-7s %-14s station %d player %d answer %d outcome %-8s time %u spread %u mask %08x\n", label,
+           eventNames[e.type], e.station, e.player, e.answer, outcomeNames[e.outcome], (unsigned)e.timeMs,
+           (unsigned)e.spreadMs, (unsigned)e.pressedMask);
+}
+
+static void runAction(GameEngine& engine, const Action& action)
+{
+    clockMs = action.timeMs;
+    switch (action.type)
+    {
+    case ACTION_PRESS:
+        engine.press(action.station, action.player, action.answer, action.timeMs);
+        break;
+    case ACTION_UPDATE:
+        engine.update();
+        break;
+    case ACTION_SOUND_FINISHED:
+        engine.soundFinished(action.station);
+        break;
+    }
+}
+
+// ============================================================================
+// REFERENCE MODEL
+// ============================================================================
+
+/**
+ * @brief One station as the game rules describe it, in unwrapped 64-bit time
+ */
+struct ModelStation
+{
+    int players;
+    int64_t timeoutMs;
+    bool waiting;
+    bool playing;
+    uint32_t pressed;
+    uint32_t yes;
+    int64_t firstMs;
+    int64_t pressMs[GAME_MAX_PLAYERS];
+};
+
+struct Model
+{
+    ModelStation stations[GAME_MAX_STATIONS];
+    std::vector<EventRecord> events;
+    uint32_t presses = 0;
+    uint32_t ignored = 0;
+
+    void emit(uint8_t type, int station, int64_t timeMs, int player = -1, bool answer = false,
+              uint8_t outcome = GAME_OUTCOME_NONE, int64_t spreadMs = 0, uint32_t mask = 0)
+    {
+        EventRecord record = {};
+        record.type = type;
+        record.station = (uint8_t)station;
+        record.player = (int8_t)player;
+        record.answer = answer;
+        record.outcome = outcome;
+        record.timeMs = (uint32_t)timeMs;
+        record.spreadMs = (uint32_t)spreadMs;
+        record.pressedMask = mask;
+        events.push_back(record);
+    }
+
+    void finish(int station, uint8_t outcome, int64_t timeMs, int64_t spreadMs)
+    {
+        ModelStation& s = stations[station];
+        s.waiting = false;
+        s.playing = true;
+        emit(GAME_EVENT_ROUND_COMPLETE, station, timeMs, -1, false, outcome, spreadMs, s.pressed);
+    }
+
+    void press(int station, int player, bool answer, int64_t timeMs)
+    {
+        ModelStation& s = stations[station];
+        if (player >= s.players || s.playing)
+        {
+            ignored++;
+            return;
+        }
+
+        bool first = s.pressed == 0;
+        if (first)
+        {
+            s.firstMs = timeMs;
+            s.waiting = true;
+        }
+        s.pressed |= 1u << player;
+        s.yes = answer ? s.yes | (1u << player) : s.yes & ~(1u << player);
+        s.pressMs[player] = timeMs;
+        presses++;
+        emit(GAME_EVENT_PRESS, station, timeMs, player, answer);
+
+        uint32_t all = s.players >= 32 ? 0xFFFFFFFFu : (1u << s.players) - 1;
+        if (s.pressed == all)
+        {
+            if (s.yes != all)
+            {
+                finish(station, GAME_OUTCOME_NO, timeMs, 0);
+                return;
+            }
+            // First to last press, the first press counting even if that player pressed again
+            int64_t earliest = s.firstMs;
+            int64_t latest = s.firstMs;
+            for (int i = 0; i < s.players; i++)
+            {
+                earliest = s.pressMs[i] < earliest ? s.pressMs[i] : earliest;
+                latest = s.pressMs[i] > latest ? s.pressMs[i] : latest;
+            }
+            int64_t spread = latest - earliest;
+            finish(station, spread <= s.timeoutMs ? GAME_OUTCOME_YES : GAME_OUTCOME_TOO_SLOW, timeMs, spread);
+        }
+        else if (first)
+        {
+            emit(GAME_EVENT_LOCKED_IN, station, timeMs, player, answer);
+        }
+    }
+
+    void update(int64_t nowMs)
+    {
+        for (int i = 0; i < GAME_MAX_STATIONS; i++)
+        {
+            if (stations[i].waiting && nowMs - stations[i].firstMs > stations[i].timeoutMs)
+            {
+                finish(i, GAME_OUTCOME_TIMEOUT, nowMs, 0);
+            }
+        }
+    }
+
+    void soundFinished(int station, int64_t nowMs)
+    {
+        ModelStation& s = stations[station];
+        if (!s.playing)
+        {
+            return;
+        }
+        s.playing = false;
+        s.waiting = false;
+        s.pressed = 0;
+        s.yes = 0;
+        emit(GAME_EVENT_RESET, station, nowMs);
+    }
+};
+
+// ============================================================================
+// FUZZING
+// ============================================================================
+
+static uint64_t rngState = 1;
+
+static uint32_t nextRandom()
+{
+    // xorshift64*
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return (uint32_t)((rngState * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+static int64_t randomBetween(int64_t low, int64_t high)
+{
+    return low + (int64_t)(nextRandom() % (uint64_t)(high - low + 1));
+}
+
+/**
+ * @brief Gap to the next action, weighted towards the timeout boundary
+ */
+static int64_t randomGap(int64_t timeoutMs)
+{
+    switch (nextRandom() % 6)
+    {
+    case 0:
+        return 0;
+    case 1:
+        return randomBetween(1, 50);
+    case 2:
+        return timeoutMs - 1 - randomBetween(0, 2);
+    case 3:
+        return timeoutMs + randomBetween(0, 2);
+    default:
+        return randomBetween(0, timeoutMs * 2);
+    }
+}
+
+/**
+ * @brief Generate one round on a random station; the model predicts its events
+ */
+static void generateRound(Model& model, int64_t& now, std::vector<Action>& actions)
+{
+    int station = (int)(nextRandom() % GAME_MAX_STATIONS);
+    ModelStation& s = model.stations[station];
+
+    // One round in four starts just before the 32-bit rollover
+    if (nextRandom() % 4 == 0)
+    {
+        int64_t wrap = ((now >> 32) + 1) << 32;
+        now = wrap - randomBetween(0, s.timeoutMs * 2 + 10);
+    }
+
+    auto add = [&](uint8_t type, int player, bool answer, int64_t timeMs) {
+        actions.push_back({type, (uint8_t)station, (uint8_t)player, answer, (uint32_t)timeMs});
+        switch (type)
+        {
+        case ACTION_PRESS:
+            model.press(station, player, answer, timeMs);
+            break;
+        case ACTION_UPDATE:
+            model.update(timeMs);
+            break;
+        case ACTION_SOUND_FINISHED:
+            model.soundFinished(station, timeMs);
+            break;
+        }
+    };
+
+    int steps = s.players + (int)randomBetween(0, s.players + 2);
+    for (int i = 0; i < steps && !s.playing; i++)
+    {
+        now += i == 0 ? 1 : randomGap(s.timeoutMs);
+        if (i > 0 && nextRandom() % 3 == 0)
+        {
+            add(ACTION_UPDATE, 0, false, now);
+            continue;
+        }
+        // Stamped when the edge happened, up to 3 ms before loop() feeds it;
+        // now and then from an input the station does not have
+        int player = (int)randomBetween(0, s.players - 1);
+        if (i > 0 && nextRandom() % 64 == 0)
+        {
+            player = GAME_MAX_PLAYERS - 1;
+        }
+        add(ACTION_PRESS, player, nextRandom() % 4 != 0, now - randomBetween(0, 3));
+    }
+
+    // Undecided: let the clock run out, probing the exact boundary first if it is still ahead
+    if (!s.playing)
+    {
+        int64_t deadline = s.firstMs + s.timeoutMs;
+        if (deadline >= now)
+        {
+            add(ACTION_UPDATE, 0, false, deadline);
+            now = deadline;
+        }
+        now += 1 + randomBetween(0, 5);
+        add(ACTION_UPDATE, 0, false, now);
+    }
+
+    // Presses during the result sound are ignored
+    for (int i = (int)randomBetween(0, 2); i > 0; i--)
+    {
+        now += randomBetween(0, 500);
+        add(ACTION_PRESS, (int)randomBetween(0, s.players - 1), true, now);
+    }
+    now += randomBetween(0, 3000);
+    add(ACTION_SOUND_FINISHED, 0, false, now);
+}
+
+static int fuzz(uint64_t rounds, uint64_t seed)
+{
+    rngState = seed ? seed : 1;
+    GameEngine engine;
+    Model model = {};
+    static const uint32_t timeouts[] = {1, 100, GAME_TIMEOUT_MS};
+    for (int i = 0; i < GAME_MAX_STATIONS; i++)
+    {
+        int players = i == GAME_MAX_STATIONS - 1 ? GAME_MAX_PLAYERS : (int)randomBetween(1, 6);
+        uint32_t timeout = timeouts[i % 3];
+        engine.configureStation(i, players, timeout);
+        model.stations[i] = ModelStation();
+        model.stations[i].players = players;
+        model.stations[i].timeoutMs = timeout;
+    }
+    engine.setEventHandler(recordEvent);
+    engine.setClock(readClock);
+
+    const uint64_t batchRounds = 20000;
+    std::vector<Action> actions;
+    double engineSeconds = 0;
+    uint64_t events = 0;
+    uint64_t outcomes[5] = {};
+    int64_t now = 0;
+
+    for (uint64_t done = 0; done < rounds; done += batchRounds)
+    {
+        actions.clear();
+        model.events.clear();
+        engineEvents.clear();
+        uint64_t batch = rounds - done < batchRounds ? rounds - done : batchRounds;
+        for (uint64_t r = 0; r < batch; r++)
+        {
+            generateRound(model, now, actions);
+        }
+        engineEvents.reserve(model.events.size());
+
+        auto start = std::chrono::steady_clock::now();
+        for (const Action& action : actions)
+        {
+            runAction(engine, action);
+        }
+        engineSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        size_t count = engineEvents.size() > model.events.size() ? engineEvents.size() : model.events.size();
+        for (size_t i = 0; i < count; i++)
+        {
+            if (i < engineEvents.size() && i < model.events.size() && engineEvents[i] == model.events[i])
+            {
+                if (model.events[i].type == GAME_EVENT_ROUND_COMPLETE)
+                {
+                    outcomes[model.events[i].outcome]++;
+                }
+                continue;
+            }
+            printf("event %llu differs (seed %llu):\n", (unsigned long long)(events + i),
+                   (unsigned long long)seed);
+            if (i < model.events.size())
+            {
+                printEvent("model", model.events[i]);
+            }
+            if (i < engineEvents.size())
+            {
+                printEvent("engine", engineEvents[i]);
+            }
+            return 1;
+        }
+        events += engineEvents.size();
+    }
+
+    const GameStats& stats = engine.stats();
+    if (stats.presses != model.presses || stats.pressesIgnored != model.ignored || stats.rounds != rounds)
+    {
+        printf("counters differ: presses %u/%u, ignored %u/%u, rounds %u/%llu\n", (unsigned)stats.presses,
+               (unsigned)model.presses, (unsigned)stats.pressesIgnored, (unsigned)model.ignored,
+               (unsigned)stats.rounds, (unsigned long long)rounds);
+        return 1;
+    }
+
+    printf("%llu rounds, %llu events, all match the model (seed %llu)\n", (unsigned long long)rounds,
+           (unsigned long long)events, (unsigned long long)seed);
+    printf("  outcomes: yes %llu, no %llu, too_slow %llu, timeout %llu\n", (unsigned long long)outcomes[1],
+           (unsigned long long)outcomes[2], (unsigned long long)outcomes[3], (unsigned long long)outcomes[4]);
+    printf("  presses %u (ignored %u)\n", (unsigned)stats.presses, (unsigned)stats.pressesIgnored);
+    printf("  engine: %.3f s, %.1f M events/s, %.1f M rounds/s\n", engineSeconds, events / engineSeconds / 1e6,
+           rounds / engineSeconds / 1e6);
+    return 0;
+}
+
+// ============================================================================
+// ROUND HISTORY REPLAY
+// ============================================================================
+
+static int replayRounds(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        perror(path);
+        return 2;
+    }
+
+    GameEngine engine;
+    engine.setEventHandler(recordEvent);
+    engine.setClock(readClock);
+
+    RecordedRound record;
+    uint32_t replayed = 0;
+    uint32_t skipped = 0;
+    uint32_t mismatched = 0;
+    while (fread(&record, sizeof(record), 1, file) == 1)
+    {
+        uint32_t crc = crc32(0, (const Bytef*)&record, offsetof(RecordedRound, crc32));
+        if (record.magic != RECORD_MAGIC || crc != record.crc32 || record.station >= GAME_MAX_STATIONS ||
+            record.players == 0 || record.players > RECORD_MAX_PLAYERS)
+        {
+            skipped++;
+            continue;
+        }
+
+        engine.configureStation(record.station, record.players);
+        engineEvents.clear();
+
+        // Final presses in time order; the round opened at startUs, which is a
+        // later press's offset only if that player pressed again
+        std::vector<Action> actions;
+        bool opened = false;
+        for (int i = 0; i < record.players; i++)
+        {
+            opened = opened || ((record.pressedMask >> i & 1) && record.pressOffsetUs[i] == 0);
+        }
+        for (int i = 0; i < record.players; i++)
+        {
+            if (record.pressedMask >> i & 1)
+            {
+                uint32_t ms = (uint32_t)((record.startUs + record.pressOffsetUs[i]) / 1000);
+                actions.push_back({ACTION_PRESS, record.station, (uint8_t)i, (bool)(record.yesMask >> i & 1), ms});
+            }
+        }
+        std::stable_sort(actions.begin(), actions.end(),
+                         [](const Action& a, const Action& b) { return (int32_t)(a.timeMs - b.timeMs) < 0; });
+        if (!opened && !actions.empty())
+        {
+            Action first = actions.front();
+            first.timeMs = (uint32_t)(record.startUs / 1000);
+            actions.insert(actions.begin(), first);
+        }
+        actions.push_back({ACTION_UPDATE, record.station, 0, false,
+                           (uint32_t)((record.startUs + record.decideOffsetUs) / 1000)});
+
+        for (const Action& action : actions)
+        {
+            runAction(engine, action);
+        }
+
+        uint8_t outcome = GAME_OUTCOME_NONE;
+        for (const EventRecord& event : engineEvents)
+        {
+            outcome = event.type == GAME_EVENT_ROUND_COMPLETE ? event.outcome : outcome;
+        }
+        if (outcome != record.outcome)
+        {
+            mismatched++;
+            printf("boot %u round %u station %d: recorded %s, replayed %s\n", record.bootCount,
+                   (unsigned)record.sequence, record.station, outcomeNames[record.outcome % 5],
+                   outcomeNames[outcome]);
+        }
+        replayed++;
+        engine.reset(record.station);
+    }
+    fclose(file);
+
+    printf("%u rounds replayed, %u mismatched, %u records skipped (bad CRC or more than %d players)\n",
+           (unsigned)replayed, (unsigned)mismatched, (unsigned)skipped, RECORD_MAX_PLAYERS);
+    return mismatched == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 2 && strcmp(argv[1], "--rounds") == 0)
+    {
+        return replayRounds(argv[2]);
+    }
+
+    uint64_t rounds = argc > 1 ? strtoull(argv[1], nullptr, 10) : 2000000;
+    uint64_t seed = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1;
+    return fuzz(rounds, seed);
+}
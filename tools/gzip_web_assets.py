@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""Gzip the files in web/ into include/web_assets.h as flash-resident arrays.
+
+Usage:
+    gzip_web_assets.py                      # regenerate include/web_assets.h
+    extra_scripts = pre:tools/gzip_web_assets.py   (platformio.ini, runs each build)
+
+index.html is served at /, other pages at /<name> (logs.html -> /logs).
+Scripts and stylesheets are served at fingerprinted URLs (/logs.<hash>.js);
+a page refers to one as {{logs.js}} and gets the fingerprinted URL
+substituted, so those can be cached for a year while a page revalidates
+against its ETag (the hash of its content).
+
+The header is only rewritten when its content changes, so an unchanged web/
+does not trigger a rebuild.
+"""
+
+import gzip
+import hashlib
+import os
+import re
+
+try:
+    # Run by PlatformIO as an extra script (no __file__ there)
+    Import("env")  # noqa: F821
+    ROOT = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+WEB_DIR = os.path.join(ROOT, "web")
+OUTPUT = os.path.join(ROOT, "include", "web_assets.h")
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".js": "application/javascript",
+    ".css": "text/css",
+    ".svg": "image/svg+xml",
+    ".ico": "image/x-icon",
+}
+
+HEADER = """/**
+ * @file web_assets.h
+ * @brief Gzipped web assets, generated by tools/gzip_web_assets.py from web/ - do not edit
+ *
+ * @date 2025
+ */
+
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+
+struct WebAsset
+{
+    const char* path;           ///< URL the asset is served at
+    const char* contentType;
+    const char* etag;           ///< Quoted hash of the uncompressed content
+    bool fingerprinted;         ///< The URL carries the hash, so it never changes content
+    const uint8_t* data;        ///< gzip stream (Content-Encoding: gzip)
+    size_t length;
+};
+"""
+
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()[:16]
+
+
+def compress(data):
+    # mtime 0 keeps the output (and the build) identical for identical input
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def identifier(name):
+    return re.sub(r"[^A-Za-z0-9]", "_", name).upper()
+
+
+def c_array(name, data):
+    lines = ["static const uint8_t %s[] = {" % name]
+    for i in range(0, len(data), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def build():
+    names = sorted(n for n in os.listdir(WEB_DIR) if os.path.splitext(n)[1] in CONTENT_TYPES)
+    pages = [n for n in names if n.endswith(".html")]
+    resources = [n for n in names if not n.endswith(".html")]
+
+    # Resources first: pages embed their fingerprinted URLs
+    assets = []
+    urls = {}
+    for name in resources:
+        with open(os.path.join(WEB_DIR, name), "rb") as f:
+            data = f.read()
+        stem, ext = os.path.splitext(name)
+        digest = content_hash(data)
+        urls[name] = "/%s.%s%s" % (stem, digest, ext)
+        assets.append((name, urls[name], ext, digest, True, data))
+
+    for name in pages:
+        with open(os.path.join(WEB_DIR, name), "rb") as f:
+            text = f.read().decode("utf-8")
+
+        def substitute(match):
+            if match.group(1) not in urls:
+                raise SystemExit("%s: unknown asset {{%s}}" % (name, match.group(1)))
+            return urls[match.group(1)]
+
+        data = re.sub(r"\{\{([^}]+)\}\}", substitute, text).encode("utf-8")
+        stem, ext = os.path.splitext(name)
+        path = "/" if name == "index.html" else "/" + stem
+        assets.append((name, path, ext, content_hash(data), False, data))
+
+    out = [HEADER]
+    total_raw = total_gz = 0
+    for name, path, ext, digest, fingerprinted, data in assets:
+        packed = compress(data)
+        total_raw += len(data)
+        total_gz += len(packed)
+        out.append("// %s: %d bytes, %d gzipped" % (name, len(data), len(packed)))
+        out.append(c_array("web_" + identifier(name).lower(), packed))
+        out.append("")
+
+    out.append("static const WebAsset webAssets[] = {")
+    for name, path, ext, digest, fingerprinted, data in assets:
+        out.append('    {"%s", "%s", "\\"%s\\"", %s, web_%s, sizeof(web_%s)},' % (
+            path, CONTENT_TYPES[ext], digest, "true" if fingerprinted else "false",
+            identifier(name).lower(), identifier(name).lower()))
+    out.append("};")
+    out.append("")
+    for index, asset in enumerate(assets):
+        out.append("#define WEB_ASSET_%s %d" % (identifier(asset[0]), index))
+    out.append("#define WEB_ASSET_COUNT %d" % len(assets))
+    out.append("")
+    out.append("#endif // WEB_ASSETS_H")
+    out.append("")
+
+    header = "\n".join(out)
+    current = None
+    if os.path.exists(OUTPUT):
+        with open(OUTPUT) as f:
+            current = f.read()
+    if header != current:
+        with open(OUTPUT, "w") as f:
+            f.write(header)
+        print("web_assets.h: %d assets, %d bytes -> %d gzipped" % (len(assets), total_raw, total_gz))
+
+
+build()
@@ -0,0 +1,39 @@
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the Arduino core calls logging.cpp makes (log_bench and the tools built on it)
+ */
+
+#ifndef LOG_BENCH_ARDUINO_H
+#define LOG_BENCH_ARDUINO_H
+
+#include "Print.h"
+#include "WString.h"
+#include "freertos/FreeRTOS.h"
+#include <chrono>
+
+inline unsigned long millis()
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename T>
+inline T min(T a, T b)
+{
+    return a < b ? a : b;
+}
+
+template <typename T>
+inline T max(T a, T b)
+{
+    return a > b ? a : b;
+}
+
+struct HostEsp
+{
+    uint32_t getFreeHeap() const { return 0; }
+};
+inline HostEsp ESP;
+
+#endif // LOG_BENCH_ARDUINO_H
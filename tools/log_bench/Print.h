@@ -0,0 +1,64 @@
+/**
+ * @file Print.h
+ * @brief Host stand-in for the Arduino Print class (log_bench and the tools built on it)
+ *
+ * printf() formats into a 64-byte stack buffer and falls back to the heap
+ * for longer output, as the ESP32 core does.
+ */
+
+#ifndef LOG_BENCH_PRINT_H
+#define LOG_BENCH_PRINT_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t byte) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size)
+    {
+        size_t n = 0;
+        while (size--)
+        {
+            n += write(*buffer++);
+        }
+        return n;
+    }
+
+    size_t print(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)))
+    {
+        char local[64];
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(local, sizeof(local), format, args);
+        va_end(args);
+        if (length < 0)
+        {
+            return 0;
+        }
+        char* text = local;
+        if ((size_t)length >= sizeof(local))
+        {
+            text = (char*)malloc(length + 1);
+            va_start(args, format);
+            vsnprintf(text, length + 1, format, args);
+            va_end(args);
+        }
+        size_t n = write((const uint8_t*)text, length);
+        if (text != local)
+        {
+            free(text);
+        }
+        return n;
+    }
+};
+
+#endif // LOG_BENCH_PRINT_H
@@ -0,0 +1,78 @@
+/**
+ * @file WString.h
+ * @brief Host stand-in for the Arduino String class (log_bench only)
+ *
+ * Only what the pre-ring logger used: construction from text and numbers,
+ * concatenation and assignment, each on its own exact-size heap buffer.
+ */
+
+#ifndef LOG_BENCH_WSTRING_H
+#define LOG_BENCH_WSTRING_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+class String
+{
+public:
+    String() {}
+    String(const char* text) { assign(text, strlen(text)); }
+    explicit String(unsigned long value)
+    {
+        char digits[24];
+        assign(digits, snprintf(digits, sizeof(digits), "%lu", value));
+    }
+    String(const String& other) { assign(other.buffer_, other.length_); }
+    ~String() { free(buffer_); }
+
+    String& operator=(const String& other)
+    {
+        if (this != &other)
+        {
+            assign(other.buffer_, other.length_);
+        }
+        return *this;
+    }
+
+    String& operator+=(const String& other) { return append(other.buffer_, other.length_); }
+    String& operator+=(const char* text) { return append(text, strlen(text)); }
+    friend String operator+(String left, const String& right) { return left += right; }
+    friend String operator+(String left, const char* right) { return left += right; }
+
+    const char* c_str() const { return buffer_ ? buffer_ : ""; }
+    size_t length() const { return length_; }
+
+private:
+    void assign(const char* text, size_t length)
+    {
+        if (length + 1 > capacity_)
+        {
+            free(buffer_);
+            buffer_ = (char*)malloc(length + 1);
+            capacity_ = length + 1;
+        }
+        memcpy(buffer_, text ? text : "", length);
+        buffer_[length] = '\0';
+        length_ = length;
+    }
+
+    String& append(const char* text, size_t length)
+    {
+        if (length_ + length + 1 > capacity_)
+        {
+            buffer_ = (char*)realloc(buffer_, length_ + length + 1);
+            capacity_ = length_ + length + 1;
+        }
+        memcpy(buffer_ + length_, text ? text : "", length);
+        length_ += length;
+        buffer_[length_] = '\0';
+        return *this;
+    }
+
+    char* buffer_ = nullptr;
+    size_t length_ = 0;
+    size_t capacity_ = 0;
+};
+
+#endif // LOG_BENCH_WSTRING_H
@@ -0,0 +1,115 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host stand-in for the FreeRTOS primitives the logger uses (log_bench and the tools built on it)
+ *
+ * Critical sections are real spinlocks, so several host threads can log at
+ * once the way tasks on both cores do. Each thread is its own "task";
+ * xTaskCreatePinnedToCore() starts a detached thread and task
+ * notifications are a counter behind a condition variable. Ticks are
+ * milliseconds.
+ */
+
+#ifndef LOG_BENCH_FREERTOS_H
+#define LOG_BENCH_FREERTOS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+
+struct portMUX_TYPE
+{
+    std::atomic_flag locked = ATOMIC_FLAG_INIT;
+};
+#define portMUX_INITIALIZER_UNLOCKED {}
+
+inline void hostEnterCritical(portMUX_TYPE* mux)
+{
+    // Yield while spinning: unlike a core, a host thread holding the lock can be preempted
+    while (mux->locked.test_and_set(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+}
+
+inline void hostExitCritical(portMUX_TYPE* mux)
+{
+    mux->locked.clear(std::memory_order_release);
+}
+
+#define portENTER_CRITICAL(mux) hostEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) hostExitCritical(mux)
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portMAX_DELAY 0xffffffffUL
+
+struct HostTask
+{
+    std::mutex lock;
+    std::condition_variable wake;
+    uint32_t notifications = 0;
+};
+typedef HostTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    static thread_local HostTask self;
+    return &self;
+}
+
+inline void xTaskNotifyGive(TaskHandle_t task)
+{
+    {
+        std::lock_guard<std::mutex> hold(task->lock);
+        task->notifications++;
+    }
+    task->wake.notify_one();
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks)
+{
+    HostTask* self = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> hold(self->lock);
+    self->wake.wait_for(hold, std::chrono::milliseconds(ticks), [self] { return self->notifications > 0; });
+    uint32_t count = self->notifications;
+    if (count > 0)
+    {
+        self->notifications = clearOnExit ? 0 : count - 1;
+    }
+    return count;
+}
+
+inline void vTaskDelay(TickType_t ticks)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char*, uint32_t, void* parameter,
+                                          UBaseType_t, TaskHandle_t* handle, BaseType_t)
+{
+    std::atomic<TaskHandle_t> created{nullptr};
+    std::thread([&created, function, parameter] {
+        created = xTaskGetCurrentTaskHandle();
+        function(parameter);
+    }).detach();
+    while (!created)
+    {
+        std::this_thread::yield();
+    }
+    if (handle)
+    {
+        *handle = created;
+    }
+    return pdPASS;
+}
+
+#endif // LOG_BENCH_FREERTOS_H
@@ -0,0 +1,11 @@
+/**
+ * @file task.h
+ * @brief Host stand-in for freertos/task.h; everything lives in FreeRTOS.h (log_bench only)
+ */
+
+#ifndef LOG_BENCH_TASK_H
+#define LOG_BENCH_TASK_H
+
+#include "FreeRTOS.h"
+
+#endif // LOG_BENCH_TASK_H
@@ -0,0 +1,272 @@
+/**
+ * @file log_bench.cpp
+ * @brief Host benchmark of the log formatter and record ring: lines per second and heap allocations per line
+ *
+ * Build and run from the repository root (the headers in this directory
+ * stand in for Arduino, Print, String and the FreeRTOS calls the logger
+ * makes):
+ *
+ *     g++ -O2 -std=gnu++17 -Itools/log_bench -Iinclude tools/log_bench/log_bench.cpp src/logging.cpp \
+ *         -lpthread -o log_bench
+ *     ./log_bench [lines] [threads]
+ *
+ * Add -DLOG_COMPILE_LEVEL=4 to the build to include the debug lines in the
+ * per-trigger figures.
+ *
+ * "before" is the String buffer logging.cpp had before the ring: every byte
+ * went through write(), and each completed line built a "<millis>ms: "
+ * String and copied it into a 100-entry String array. It is reproduced here
+ * on the String stand-in, which gives each String its own exact-size heap
+ * buffer like the ESP32 core does for anything past its small inline
+ * buffer. It was never safe to call from two tasks, so it is timed on one
+ * thread only. "after" is the real src/logging.cpp, driven through
+ * Logger.log() (what LOG_INFO() calls) and through Logger.printf() (what
+ * library code printing to Logger uses), on one thread and then on
+ * [threads] threads at once. Serial output is off in both, so the figures
+ * are formatting and buffering only.
+ *
+ * The last section times the log calls made for one cached clip trigger
+ * (the round result in main.ino, the processAudioKey() lookup and the play
+ * command) at each runtime level: lines below the runtime level cost one
+ * table lookup and compare, lines above LOG_COMPILE_LEVEL generate no code.
+ *
+ * Allocations are counted by wrapping malloc/realloc/free, so they include
+ * anything the C library does while formatting. The run also checks that
+ * the ring's sequence numbers are contiguous after the multi-thread pass
+ * and exits 1 if not.
+ *
+ * @date 2025
+ */
+
+#include "logging.h"
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_realloc(void* pointer, size_t size);
+extern "C" void __libc_free(void* pointer);
+
+static std::atomic<uint64_t> allocations{0};
+
+extern "C" void* malloc(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void* realloc(void* pointer, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
+
+extern "C" void free(void* pointer)
+{
+    __libc_free(pointer);
+}
+
+// ============================================================================
+// PRE-RING LOGGER
+// ============================================================================
+
+#define LEGACY_BUFFER_SIZE 100
+
+/**
+ * @brief The String-array logger as it was before the record ring
+ */
+class LegacyLogger : public Print
+{
+public:
+    size_t write(uint8_t byte) override
+    {
+        if (bufferPos < MAX_LOG_MESSAGE_LENGTH - 1)
+        {
+            messageBuffer[bufferPos++] = byte;
+            messageBuffer[bufferPos] = '\0';
+            if (byte == '\n' || byte == '\r')
+            {
+                if (bufferPos > 1)
+                {
+                    messageBuffer[bufferPos - 1] = '\0';
+                    String timestampedMessage = String(millis()) + "ms: " + String(messageBuffer);
+                    addMessageToBuffer(timestampedMessage);
+                }
+                bufferPos = 0;
+                messageBuffer[0] = '\0';
+            }
+        }
+        else
+        {
+            String timestampedMessage = String(millis()) + "ms: " + String(messageBuffer);
+            addMessageToBuffer(timestampedMessage);
+            bufferPos = 0;
+            messageBuffer[bufferPos++] = byte;
+            messageBuffer[bufferPos] = '\0';
+        }
+        return 1;
+    }
+
+private:
+    void addMessageToBuffer(const String& message)
+    {
+        logBuffer[logIndex] = message;
+        logIndex = (logIndex + 1) % LEGACY_BUFFER_SIZE;
+    }
+
+    String logBuffer[LEGACY_BUFFER_SIZE];
+    int logIndex = 0;
+    size_t bufferPos = 0;
+    char messageBuffer[MAX_LOG_MESSAGE_LENGTH] = {};
+};
+
+// ============================================================================
+// BENCHMARK
+// ============================================================================
+
+struct Result
+{
+    double linesPerSecond;
+    double allocationsPerLine;
+};
+
+/**
+ * @brief Run `logLine(i)` for `lines` lines on each of `threads` threads
+ * @return Best of three runs
+ */
+template <typename F>
+static Result measure(uint32_t lines, int threads, F logLine)
+{
+    Result best = {0, 0};
+    for (int attempt = 0; attempt < 3; attempt++)
+    {
+        uint64_t before = allocations.load();
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++)
+        {
+            workers.emplace_back([&, t] {
+                for (uint32_t i = 0; i < lines; i++)
+                {
+                    logLine(t, i);
+                }
+            });
+        }
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double total = (double)lines * threads;
+        if (total / seconds > best.linesPerSecond)
+        {
+            best = {total / seconds, (allocations.load() - before) / total};
+        }
+    }
+    return best;
+}
+
+static void report(const char* name, const Result& result)
+{
+    printf("  %-34s %10.0f lines/s  %6.2f allocations/line\n", name, result.linesPerSecond,
+           result.allocationsPerLine);
+}
+
+#define TRIGGER_PATH "/audio/no/clip_03.mp3"
+
+/**
+ * @brief The LOG_* calls one cached clip trigger makes, with the same arguments
+ */
+static void logTrigger()
+{
+    LOG_INFO("🎮 All players at station %d have answered!\n", 1);
+    LOG_INFO("🚫 At least one player said NO - playing NO sound");
+    LOG_DEBUG("🔍 Processing known sequence: %s\n", "no");
+    LOG_DEBUG("📋 Sequence Info:\n");
+    LOG_DEBUG("   Sequence: %s\n", "no");
+    LOG_DEBUG("   Description: %s\n", "No answer clip");
+    LOG_DEBUG("   Type: %s\n", "audio");
+    LOG_DEBUG("   Path: %s\n", TRIGGER_PATH);
+    LOG_DEBUG("🔊 Processing audio sequence: %s\n", "No answer clip");
+    LOG_DEBUG("🎵 Audio file found locally: %s\n", TRIGGER_PATH);
+    LOG_INFO("🎵 Starting audio playback: %s\n", TRIGGER_PATH);
+    LOG_DEBUG("🎵 Audio playback started");
+}
+
+static void checkSequence(const LogRecord& record, void* context)
+{
+    uint32_t* previous = (uint32_t*)context;
+    if (*previous != 0 && record.sequence != *previous + 1)
+    {
+        fprintf(stderr, "sequence gap: %u after %u\n", (unsigned)record.sequence, (unsigned)*previous);
+        *previous = UINT32_MAX - 1;
+        return;
+    }
+    if (*previous != UINT32_MAX - 1)
+    {
+        *previous = record.sequence;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t lines = argc > 1 ? strtoul(argv[1], nullptr, 10) : 200000;
+    int threads = argc > 2 ? atoi(argv[2]) : 4;
+    if (lines == 0 || threads < 1)
+    {
+        fprintf(stderr, "usage: %s [lines] [threads]\n", argv[0]);
+        return 2;
+    }
+
+    // A short line, and one long enough to push Print::printf() onto the heap
+    const char* shortFormat = "🎵 Starting audio playback: /audio/yes/clip_%u.mp3\n";
+    const char* longFormat = "📶 WiFi connected to %s, IP %u.%u.%u.%u, RSSI %d dBm, catalog has %u clips in %u folders\n";
+    static LegacyLogger legacy;
+
+    printf("%u lines per thread, best of 3 runs\n", (unsigned)lines);
+    printf("short line (~50 bytes):\n");
+    report("before: String buffer", measure(lines, 1, [&](int, uint32_t i) { legacy.printf(shortFormat, i); }));
+    report("after: Logger.log()", measure(lines, 1, [&](int, uint32_t i) {
+               Logger.log(LOG_MODULE_AUDIO, LOG_LEVEL_INFO, shortFormat, i);
+           }));
+    report("after: Logger.printf()", measure(lines, 1, [&](int, uint32_t i) { Logger.printf(shortFormat, i); }));
+
+    printf("long line (~100 bytes):\n");
+    report("before: String buffer", measure(lines, 1, [&](int, uint32_t i) {
+               legacy.printf(longFormat, "pheromone", 192, 168, 1, i & 255, -60, i, 3);
+           }));
+    report("after: Logger.log()", measure(lines, 1, [&](int, uint32_t i) {
+               Logger.log(LOG_MODULE_WIFI, LOG_LEVEL_INFO, longFormat, "pheromone", 192, 168, 1, i & 255, -60, i, 3);
+           }));
+    report("after: Logger.printf()", measure(lines, 1, [&](int, uint32_t i) {
+               Logger.printf(longFormat, "pheromone", 192, 168, 1, i & 255, -60, i, 3);
+           }));
+
+    printf("%d threads at once, short line:\n", threads);
+    report("after: Logger.log()", measure(lines, threads, [&](int, uint32_t i) {
+               Logger.log(LOG_MODULE_AUDIO, LOG_LEVEL_INFO, shortFormat, i);
+           }));
+    report("after: Logger.printf()", measure(lines, threads, [&](int, uint32_t i) { Logger.printf(shortFormat, i); }));
+
+    printf("one cached clip trigger (3 info + 9 debug lines), LOG_COMPILE_LEVEL %s:\n",
+           LoggerClass::levelName(LOG_COMPILE_LEVEL));
+    for (LogLevel level = LOG_LEVEL_NONE; level <= LOG_LEVEL_DEBUG; level++)
+    {
+        logModuleLevels[LOG_MODULE] = level;
+        Result result = measure(lines, 1, [&](int, uint32_t) { logTrigger(); });
+        printf("  runtime level %-6s %10.0f ns/trigger  %6.2f allocations/trigger\n", LoggerClass::levelName(level),
+               1e9 / result.linesPerSecond, result.allocationsPerLine);
+    }
+    logModuleLevels[LOG_MODULE] = LOG_COMPILE_LEVEL;
+
+    uint32_t previous = 0;
+    Logger.forEachRecord(checkSequence, &previous, false);
+    bool contiguous = previous == Logger.getLastSequence();
+    printf("ring: %d records held, last sequence %u, %s\n", Logger.getLogCount(), (unsigned)Logger.getLastSequence(),
+           contiguous ? "contiguous" : "NOT contiguous");
+    return contiguous ? 0 : 1;
+}
@@ -0,0 +1,442 @@
+/**
+ * @file logs_load.cpp
+ * @brief Host load test of /logs.json: concurrent clients pulling the log ring while it is written
+ *
+ * Build and run from the repository root (Arduino, Print and FreeRTOS come
+ * from the log_bench stand-ins):
+ *
+ *     g++ -O2 -std=gnu++17 -Itools/log_bench -Iinclude tools/logs_load/logs_load.cpp src/logging.cpp \
+ *         src/response_part.cpp -lpthread -o logs_load
+ *     ./logs_load [clients] [requests per client] [us between log lines]
+ *
+ * Each client thread produces /logs.json bodies the way handleLogsJson()
+ * does: Logger.beginLogsJson() and Logger.writeLogsJsonPart() feeding a
+ * ResponsePart, drained by ResponsePart::fill() in random chunk sizes of up
+ * to one TCP segment, as AsyncTCP asks for them. Clients poll with the
+ * "last" of their previous body like logs.js, with an occasional full pull.
+ * Meanwhile one thread logs a line every [us] microseconds; each line holds
+ * quotes, backslashes, a tab, a control character and UTF-8, plus its own
+ * number, so its expected text follows from its sequence.
+ *
+ * Every body must parse as JSON, hold records in increasing sequence order
+ * newer than the request's "since", end with "last" equal to its newest
+ * record, and decode each message back to the exact line logged. Gaps inside
+ * a body (the ring wrapped while a slow client was between parts) are legal
+ * and only counted. The report gives requests per second, the longest
+ * fill() call (what the network task spends per chunk) and exits 1 on any
+ * failure.
+ *
+ * @date 2025
+ */
+
+#include "logging.h"
+#include "response_part.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define SEGMENT_BYTES 1460
+
+static std::atomic<bool> logging{true};
+static std::atomic<uint32_t> failures{0};
+
+static void formatLine(char* line, size_t size, uint32_t number)
+{
+    snprintf(line, size, "quote \" backslash \\ tab \t ctrl \x01 utf8 é ✅ line %u", (unsigned)number);
+}
+
+// ============================================================================
+// JSON CHECKING
+// ============================================================================
+
+/**
+ * @brief Just enough of a JSON parser to check a /logs.json body
+ */
+struct BodyParser
+{
+    const char* p;
+    const char* end;
+    std::vector<std::pair<uint32_t, std::string>> records;
+    long long last = -1;
+
+    explicit BodyParser(const std::string& body) : p(body.data()), end(body.data() + body.size()) {}
+
+    void skipSpace()
+    {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+        {
+            p++;
+        }
+    }
+
+    bool expect(char c)
+    {
+        skipSpace();
+        if (p < end && *p == c)
+        {
+            p++;
+            return true;
+        }
+        return false;
+    }
+
+    bool parseString(std::string& out)
+    {
+        if (!expect('"'))
+        {
+            return false;
+        }
+        while (p < end && *p != '"')
+        {
+            unsigned char c = *p++;
+            if (c < 0x20)
+            {
+                return false;
+            }
+            if (c != '\\')
+            {
+                out += (char)c;
+                continue;
+            }
+            if (p >= end)
+            {
+                return false;
+            }
+            switch (*p++)
+            {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u':
+            {
+                if (end - p < 4)
+                {
+                    return false;
+                }
+                unsigned code = (unsigned)strtoul(std::string(p, 4).c_str(), nullptr, 16);
+                p += 4;
+                if (code >= 0x80)
+                {
+                    return false; // The logger passes UTF-8 through and only escapes control characters
+                }
+                out += (char)code;
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+        return expect('"');
+    }
+
+    bool parseNumber(long long& value)
+    {
+        skipSpace();
+        char* stop;
+        value = strtoll(p, &stop, 10);
+        if (stop == p)
+        {
+            return false;
+        }
+        p = stop;
+        return true;
+    }
+
+    bool parseRecord()
+    {
+        if (!expect('{'))
+        {
+            return false;
+        }
+        long long seq = -1;
+        std::string message;
+        bool haveMessage = false;
+        do
+        {
+            std::string key;
+            if (!parseString(key) || !expect(':'))
+            {
+                return false;
+            }
+            long long number;
+            std::string text;
+            if (key == "msg")
+            {
+                haveMessage = parseString(message);
+                if (!haveMessage)
+                {
+                    return false;
+                }
+            }
+            else if (key == "module")
+            {
+                if (!parseString(text))
+                {
+                    return false;
+                }
+            }
+            else if (!parseNumber(number))
+            {
+                return false;
+            }
+            else if (key == "seq")
+            {
+                seq = number;
+            }
+        } while (expect(','));
+        if (!expect('}') || seq < 0 || !haveMessage)
+        {
+            return false;
+        }
+        records.push_back({(uint32_t)seq, message});
+        return true;
+    }
+
+    bool parse()
+    {
+        if (!expect('{'))
+        {
+            return false;
+        }
+        do
+        {
+            std::string key;
+            if (!parseString(key) || !expect(':'))
+            {
+                return false;
+            }
+            long long number;
+            if (key == "logs")
+            {
+                if (!expect('['))
+                {
+                    return false;
+                }
+                if (!expect(']'))
+                {
+                    do
+                    {
+                        if (!parseRecord())
+                        {
+                            return false;
+                        }
+                    } while (expect(','));
+                    if (!expect(']'))
+                    {
+                        return false;
+                    }
+                }
+            }
+            else if (!parseNumber(number))
+            {
+                return false;
+            }
+            else if (key == "last")
+            {
+                last = number;
+            }
+        } while (expect(','));
+        if (!expect('}'))
+        {
+            return false;
+        }
+        skipSpace();
+        return p == end;
+    }
+};
+
+static void fail(const char* what, uint32_t since, const std::string& body)
+{
+    if (failures.fetch_add(1) < 5)
+    {
+        fprintf(stderr, "since=%u: %s\n  %.300s\n", (unsigned)since, what, body.c_str());
+    }
+}
+
+/**
+ * @brief Check one body
+ * @return Gaps between records, or -1 if the body is wrong
+ */
+static int checkBody(const std::string& body, uint32_t since, uint32_t* last, uint32_t* count)
+{
+    BodyParser parser(body);
+    if (!parser.parse() || parser.last < 0)
+    {
+        fail("not valid /logs.json", since, body);
+        return -1;
+    }
+
+    int gaps = 0;
+    uint32_t previous = since;
+    char expected[MAX_LOG_MESSAGE_LENGTH];
+    for (const auto& record : parser.records)
+    {
+        if (record.first <= previous)
+        {
+            fail("record not newer than the previous one", since, body);
+            return -1;
+        }
+        gaps += record.first != previous + 1 && previous != since ? 1 : 0;
+        formatLine(expected, sizeof(expected), record.first - 1);
+        if (record.second != expected)
+        {
+            fail("message does not match the line logged", since, body);
+            return -1;
+        }
+        previous = record.first;
+    }
+    if ((uint32_t)parser.last != previous)
+    {
+        fail("\"last\" is not the newest record sent", since, body);
+        return -1;
+    }
+    *last = previous;
+    *count = parser.records.size();
+    return gaps;
+}
+
+// ============================================================================
+// LOAD
+// ============================================================================
+
+struct ClientResult
+{
+    uint32_t requests = 0;
+    uint64_t records = 0;
+    uint64_t bytes = 0;
+    uint32_t gaps = 0;
+    int64_t worstFillNs = 0;
+};
+
+static void runClient(int id, int requests, ClientResult* result)
+{
+    uint32_t rng = 0x9E3779B9u * (id + 1);
+    uint32_t since = 0;
+    std::vector<uint8_t> chunk(SEGMENT_BYTES);
+    std::string body;
+
+    for (int r = 0; r < requests; r++)
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        if (rng % 16 == 0)
+        {
+            since = 0; // Page reload
+        }
+
+        // handleLogsJson(): one cursor and one part per response
+        auto cursor = std::make_shared<LogJsonCursor>();
+        Logger.beginLogsJson(*cursor, since);
+        auto part = std::make_shared<ResponsePart>();
+        std::function<bool(Print&)> nextPart = [cursor](Print& out) { return Logger.writeLogsJsonPart(out, *cursor); };
+
+        body.clear();
+        for (;;)
+        {
+            rng ^= rng << 13;
+            rng ^= rng >> 17;
+            rng ^= rng << 5;
+            size_t maxLength = 1 + rng % SEGMENT_BYTES;
+            auto start = std::chrono::steady_clock::now();
+            size_t n = part->fill(chunk.data(), maxLength, nextPart);
+            int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start).count();
+            result->worstFillNs = std::max(result->worstFillNs, ns);
+            if (n == 0)
+            {
+                break;
+            }
+            body.append((const char*)chunk.data(), n);
+            if (rng % 64 == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(500)); // A slow connection
+            }
+        }
+
+        uint32_t last = since;
+        uint32_t count = 0;
+        int gaps = checkBody(body, since, &last, &count);
+        if (gaps < 0)
+        {
+            continue;
+        }
+        result->requests++;
+        result->records += count;
+        result->bytes += body.size();
+        result->gaps += gaps;
+        since = last;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int clients = argc > 1 ? atoi(argv[1]) : 8;
+    int requests = argc > 2 ? atoi(argv[2]) : 20000;
+    int intervalUs = argc > 3 ? atoi(argv[3]) : 200;
+    if (clients < 1 || requests < 1 || intervalUs < 0)
+    {
+        fprintf(stderr, "usage: %s [clients] [requests per client] [us between log lines]\n", argv[0]);
+        return 2;
+    }
+
+    std::thread writer([intervalUs] {
+        // Paced against the clock: host sleeps are far coarser than the interval
+        char line[MAX_LOG_MESSAGE_LENGTH];
+        auto due = std::chrono::steady_clock::now();
+        for (uint32_t number = 0; logging; number++)
+        {
+            formatLine(line, sizeof(line), number);
+            Logger.log(LOG_MODULE_MAIN, LOG_LEVEL_INFO, "%s", line);
+            due += std::chrono::microseconds(intervalUs);
+            while (logging && std::chrono::steady_clock::now() < due)
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<ClientResult> results(clients);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int c = 0; c < clients; c++)
+    {
+        threads.emplace_back(runClient, c, requests, &results[c]);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    logging = false;
+    writer.join();
+
+    ClientResult total;
+    for (const ClientResult& result : results)
+    {
+        total.requests += result.requests;
+        total.records += result.records;
+        total.bytes += result.bytes;
+        total.gaps += result.gaps;
+        total.worstFillNs = std::max(total.worstFillNs, result.worstFillNs);
+    }
+    printf("%d clients x %d requests, a line logged every %d us (%u lines in %.2f s)\n", clients, requests, intervalUs,
+           (unsigned)Logger.getLastSequence(), seconds);
+    printf("  %u good bodies, %.0f requests/s, %.1f records and %.0f bytes per body\n", (unsigned)total.requests,
+           total.requests / seconds, (double)total.records / std::max(total.requests, 1u),
+           (double)total.bytes / std::max(total.requests, 1u));
+    printf("  longest fill() %.1f us, %u gaps where the ring wrapped mid-response\n", total.worstFillNs / 1000.0,
+           (unsigned)total.gaps);
+    printf("  %u bad bodies\n", (unsigned)failures.load());
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file mix_bench.cpp
+ * @brief Host benchmark of the mixer bus: cost per voice per millisecond of audio
+ *
+ * Build and run from the repository root:
+ *
+ *     g++ -O2 -std=gnu++17 -Iinclude tools/mix_bench/mix_bench.cpp src/dsp_kernels.cpp -o mix_bench
+ *     ./mix_bench [max voices] [sample rate]
+ *
+ * Each block runs the same kernel sequence as audioMixerRender(): clear the
+ * 32-bit bus, accumulate every voice at its gain (one voice ramping, as
+ * during a fade), apply the master gain and TPDF-dither down to 16 bit.
+ * Decoding is not included; it depends on the voice's MP3 stream, not on
+ * the mix. The per-voice cost is the slope of block time over voice count
+ * (steady-gain voices); the intercept is the bus work done once per block.
+ *
+ * @date 2025
+ */
+
+#include "dsp_kernels.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// Mirror the defaults in audio_mixer.h (which pulls in Arduino headers)
+#define BENCH_BLOCK_FRAMES 256
+#define BENCH_FRAC_BITS 4
+#define BENCH_FADE_MS 5
+
+static int32_t accumulator[BENCH_BLOCK_FRAMES * 2];
+static int16_t output[BENCH_BLOCK_FRAMES * 2];
+
+/**
+ * @brief Mix `blocks` blocks of `voices` voices
+ * @return Seconds taken
+ */
+static double mixBlocks(const std::vector<std::vector<int16_t>>& inputs, int voices, int blocks,
+                        uint32_t sampleRate, uint32_t* checksum)
+{
+    const size_t samples = BENCH_BLOCK_FRAMES * 2;
+    int32_t fadeStep = DSP_Q15_ONE / (int32_t)(sampleRate * BENCH_FADE_MS / 1000);
+    int32_t rampGain = 0;
+    uint32_t dither = 0x2545F491;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < blocks; b++)
+    {
+        memset(accumulator, 0, sizeof(accumulator));
+        for (int v = 0; v < voices; v++)
+        {
+            const int16_t* in = inputs[v].data() + (b % 16) * samples;
+            if (v == 0)
+            {
+                // Restart the fade whenever it completes so one voice always ramps
+                if (rampGain == DSP_Q15_ONE / 2)
+                {
+                    rampGain = 0;
+                }
+                rampGain = dspMixAccumulateRampQ15(accumulator, in, BENCH_BLOCK_FRAMES, 2, rampGain,
+                                                   fadeStep, DSP_Q15_ONE / 2, BENCH_FRAC_BITS);
+            }
+            else
+            {
+                dspMixAccumulateQ15(accumulator, in, samples, DSP_Q15_ONE / 2, BENCH_FRAC_BITS);
+            }
+        }
+        dspGainQ31(accumulator, samples, (DSP_Q15_ONE * 3 / 4) << 16);
+        dspDitherTpdfTo16(output, accumulator, samples, BENCH_FRAC_BITS, &dither);
+        *checksum = *checksum * 31 + (uint16_t)output[b % samples];
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    int maxVoices = argc > 1 ? atoi(argv[1]) : 8;
+    uint32_t sampleRate = argc > 2 ? strtoul(argv[2], nullptr, 10) : 44100;
+    if (maxVoices < 1 || sampleRate < 8000)
+    {
+        fprintf(stderr, "usage: %s [max voices] [sample rate]\n", argv[0]);
+        return 2;
+    }
+
+    // 16 blocks of noise per voice so inputs are not all cache-hot copies of one block
+    std::vector<std::vector<int16_t>> inputs(maxVoices);
+    uint32_t seed = 12345;
+    for (auto& input : inputs)
+    {
+        input.resize(16 * BENCH_BLOCK_FRAMES * 2);
+        for (int16_t& sample : input)
+        {
+            seed = seed * 1664525 + 1013904223;
+            sample = (int16_t)(seed >> 16);
+        }
+    }
+
+    const int blocks = 20000;
+    const int runs = 5;
+    double blockMs = 1000.0 * BENCH_BLOCK_FRAMES / sampleRate;
+    uint32_t checksum = 0;
+    std::vector<double> perBlockUs(maxVoices + 1);
+
+    printf("%d-frame stereo blocks (%.2f ms of audio at %u Hz), best of %d runs of %d blocks:\n",
+           BENCH_BLOCK_FRAMES, blockMs, (unsigned)sampleRate, runs, blocks);
+    for (int voices = 1; voices <= maxVoices; voices++)
+    {
+        double best = 1e9;
+        for (int run = 0; run < runs; run++)
+        {
+            double seconds = mixBlocks(inputs, voices, blocks, sampleRate, &checksum);
+            if (seconds < best)
+            {
+                best = seconds;
+            }
+        }
+        perBlockUs[voices] = best * 1e6 / blocks;
+        printf("  %2d voices: %7.3f us/block  %7.3f us per ms of audio  %6.3f%% of real time\n", voices,
+               perBlockUs[voices], perBlockUs[voices] / blockMs, 100.0 * perBlockUs[voices] / (blockMs * 1000));
+    }
+
+    // Least-squares line through (voices, us/block)
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (int voices = 1; voices <= maxVoices; voices++)
+    {
+        sx += voices;
+        sy += perBlockUs[voices];
+        sxx += (double)voices * voices;
+        sxy += voices * perBlockUs[voices];
+    }
+    double slope = maxVoices > 1 ? (maxVoices * sxy - sx * sy) / (maxVoices * sxx - sx * sx) : perBlockUs[1];
+    double intercept = (sy - slope * sx) / maxVoices;
+    printf("per voice: %.3f us per ms of audio; bus (clear, master gain, dither): %.3f us per ms (checksum %08x)\n",
+           slope / blockMs, intercept / blockMs, (unsigned)checksum);
+    return 0;
+}
@@ -0,0 +1,24 @@
+/**
+ * @file md.h
+ * @brief Host stand-in for the mbedtls HMAC call, backed by OpenSSL (ota_bench only)
+ */
+
+#ifndef OTA_BENCH_MBEDTLS_MD_H
+#define OTA_BENCH_MBEDTLS_MD_H
+
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+typedef EVP_MD mbedtls_md_info_t;
+
+#define MBEDTLS_MD_SHA256 0
+
+static inline const mbedtls_md_info_t* mbedtls_md_info_from_type(int) { return EVP_sha256(); }
+
+static inline int mbedtls_md_hmac(const mbedtls_md_info_t* info, const unsigned char* key, size_t keyLength,
+                                  const unsigned char* input, size_t length, unsigned char* output)
+{
+    return HMAC(info, key, (int)keyLength, input, length, output, nullptr) ? 0 : -1;
+}
+
+#endif // OTA_BENCH_MBEDTLS_MD_H
@@ -0,0 +1,26 @@
+/**
+ * @file sha256.h
+ * @brief Host stand-in for the mbedtls SHA-256 API, backed by OpenSSL (ota_bench only)
+ */
+
+#ifndef OTA_BENCH_MBEDTLS_SHA256_H
+#define OTA_BENCH_MBEDTLS_SHA256_H
+
+#define OPENSSL_SUPPRESS_DEPRECATED // The one-shot SHA256_* calls map 1:1 onto mbedtls
+#include <openssl/sha.h>
+
+typedef SHA256_CTX mbedtls_sha256_context;
+
+static inline void mbedtls_sha256_init(mbedtls_sha256_context* ctx) { SHA256_Init(ctx); }
+static inline void mbedtls_sha256_free(mbedtls_sha256_context*) {}
+static inline int mbedtls_sha256_starts(mbedtls_sha256_context* ctx, int) { return !SHA256_Init(ctx); }
+static inline int mbedtls_sha256_update(mbedtls_sha256_context* ctx, const unsigned char* data, size_t length)
+{
+    return !SHA256_Update(ctx, data, length);
+}
+static inline int mbedtls_sha256_finish(mbedtls_sha256_context* ctx, unsigned char* digest)
+{
+    return !SHA256_Final(digest, ctx);
+}
+
+#endif // OTA_BENCH_MBEDTLS_SHA256_H
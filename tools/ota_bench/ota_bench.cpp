@@ -0,0 +1,104 @@
+/**
+ * @file ota_bench.cpp
+ * @brief Host benchmark of the OTA image pipeline (inflate + SHA-256), as the device runs it
+ *
+ * Build and run from the repository root:
+ *
+ *     g++ -O2 -std=gnu++17 -Itools/ota_bench -Iinclude tools/ota_bench/ota_bench.cpp \
+ *         src/ota_image_stream.cpp src/inflate_stream.cpp -lcrypto -o ota_bench
+ *     gzip -9 -k -n firmware.bin
+ *     ./ota_bench firmware.bin.gz $(sha256sum firmware.bin | cut -c1-64) [chunk bytes] [link KB/s]
+ *
+ * The image is fed in chunk-sized writes (default 1460, one TCP segment),
+ * the way the pull OTA task receives it. The report gives the pipeline
+ * throughput and, for the given link speed, the transfer time of the served
+ * file against that of the raw image.
+ *
+ * @date 2025
+ */
+
+#include "ota_image_stream.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static bool discard(const uint8_t*, size_t, void*)
+{
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s image[.gz] sha256-of-image [chunk bytes] [link KB/s]\n", argv[0]);
+        return 2;
+    }
+
+    FILE* file = fopen(argv[1], "rb");
+    if (!file)
+    {
+        perror(argv[1]);
+        return 2;
+    }
+    std::vector<uint8_t> data;
+    uint8_t block[65536];
+    size_t n;
+    while ((n = fread(block, 1, sizeof(block), file)) > 0)
+    {
+        data.insert(data.end(), block, block + n);
+    }
+    fclose(file);
+
+    uint8_t expected[OTA_SHA256_LENGTH];
+    if (!parseSha256Hex(argv[2], expected))
+    {
+        fprintf(stderr, "sha256 must be 64 hex digits\n");
+        return 2;
+    }
+    size_t chunk = argc > 3 ? strtoul(argv[3], nullptr, 10) : 1460;
+    double linkKBps = argc > 4 ? strtod(argv[4], nullptr) : 500.0;
+    if (chunk == 0)
+    {
+        chunk = 1460;
+    }
+
+    const int runs = 5;
+    double best = 1e9;
+    OtaImageStream stream;
+    for (int run = 0; run < runs; run++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        stream.begin(discard, nullptr);
+        for (size_t pos = 0; pos < data.size(); pos += chunk)
+        {
+            size_t length = data.size() - pos < chunk ? data.size() - pos : chunk;
+            if (!stream.write(data.data() + pos, length))
+            {
+                break;
+            }
+        }
+        bool ok = stream.finish(expected);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!ok)
+        {
+            fprintf(stderr, "verification failed: %s\n", stream.error());
+            return 1;
+        }
+        if (seconds < best)
+        {
+            best = seconds;
+        }
+    }
+
+    double streamBytes = stream.streamBytes();
+    double imageBytes = stream.imageBytes();
+    printf("%s: %s, %.0f bytes -> %.0f bytes image (ratio %.2f), SHA-256 ok\n", argv[1],
+           stream.isCompressed() ? "gzip" : "raw", streamBytes, imageBytes, imageBytes / streamBytes);
+    printf("pipeline: %.1f ms, %.1f MB/s in, %.1f MB/s out (best of %d, %zu-byte writes)\n", best * 1000,
+           streamBytes / best / 1e6, imageBytes / best / 1e6, runs, chunk);
+    printf("at %.0f KB/s: %.1f s transfer vs %.1f s for the raw image\n", linkKBps,
+           streamBytes / 1024 / linkKBps, imageBytes / 1024 / linkKBps);
+    return 0;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file FS.h
+ * @brief Host stand-in for the Arduino filesystem API: an in-memory SD card with write latency (sink_bench only)
+ *
+ * Files live in a map. Each File::write() sleeps for hostSdWriteMs plus
+ * hostSdWriteUsPerKiB per KiB written before it returns, which is roughly
+ * how an SD card in SDMMC mode behaves for appends with a FAT update.
+ */
+
+#ifndef SINK_BENCH_FS_H
+#define SINK_BENCH_FS_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+inline double hostSdWriteMs = 8.0;
+inline double hostSdWriteUsPerKiB = 512.0;
+
+struct HostFileSystemState
+{
+    std::mutex lock;
+    std::map<std::string, std::string> files;
+};
+
+inline HostFileSystemState hostFileSystem;
+
+class File
+{
+public:
+    File() {}
+    explicit File(const std::string& path) : path_(path), open_(true) {}
+
+    explicit operator bool() const { return open_; }
+
+    size_t write(const uint8_t* buffer, size_t size)
+    {
+        if (!open_)
+        {
+            return 0;
+        }
+        std::this_thread::sleep_for(
+            std::chrono::microseconds((long long)(hostSdWriteMs * 1000 + hostSdWriteUsPerKiB * size / 1024)));
+        std::lock_guard<std::mutex> hold(hostFileSystem.lock);
+        hostFileSystem.files[path_].append((const char*)buffer, size);
+        return size;
+    }
+
+    void flush() {}
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> hold(hostFileSystem.lock);
+        auto found = hostFileSystem.files.find(path_);
+        return found == hostFileSystem.files.end() ? 0 : found->second.size();
+    }
+
+    void close() { open_ = false; }
+
+private:
+    std::string path_;
+    bool open_ = false;
+};
+
+namespace fs
+{
+class FS
+{
+public:
+    File open(const char* path, const char* mode)
+    {
+        std::lock_guard<std::mutex> hold(hostFileSystem.lock);
+        std::string& contents = hostFileSystem.files[path];
+        if (mode[0] == 'w')
+        {
+            contents.clear();
+        }
+        return File(path);
+    }
+
+    bool remove(const char* path)
+    {
+        std::lock_guard<std::mutex> hold(hostFileSystem.lock);
+        return hostFileSystem.files.erase(path) > 0;
+    }
+
+    bool rename(const char* from, const char* to)
+    {
+        std::lock_guard<std::mutex> hold(hostFileSystem.lock);
+        auto found = hostFileSystem.files.find(from);
+        if (found == hostFileSystem.files.end())
+        {
+            return false;
+        }
+        hostFileSystem.files[to] = std::move(found->second);
+        hostFileSystem.files.erase(from);
+        return true;
+    }
+};
+} // namespace fs
+
+#endif // SINK_BENCH_FS_H
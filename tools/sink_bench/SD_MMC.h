@@ -0,0 +1,13 @@
+/**
+ * @file SD_MMC.h
+ * @brief Host stand-in for the SD_MMC filesystem object, backed by the fake card in FS.h (sink_bench only)
+ */
+
+#ifndef SINK_BENCH_SD_MMC_H
+#define SINK_BENCH_SD_MMC_H
+
+#include "FS.h"
+
+inline fs::FS SD_MMC;
+
+#endif // SINK_BENCH_SD_MMC_H
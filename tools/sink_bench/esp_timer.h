@@ -0,0 +1,18 @@
+/**
+ * @file esp_timer.h
+ * @brief Host stand-in for esp_timer_get_time() on the steady clock (sink_bench only)
+ */
+
+#ifndef SINK_BENCH_ESP_TIMER_H
+#define SINK_BENCH_ESP_TIMER_H
+
+#include <chrono>
+#include <stdint.h>
+
+inline int64_t esp_timer_get_time()
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif // SINK_BENCH_ESP_TIMER_H
@@ -0,0 +1,131 @@
+/**
+ * @file sink_bench.cpp
+ * @brief Host benchmark of the SD log sink: sustained lines per second against a fake SD card
+ *
+ * Build and run from the repository root (the headers in this directory
+ * stand in for the SD card and esp_timer; the rest come from log_bench):
+ *
+ *     g++ -O2 -std=gnu++17 -Itools/sink_bench -Itools/log_bench -Iinclude tools/sink_bench/sink_bench.cpp \
+ *         src/log_sink.cpp src/logging.cpp -lpthread -o sink_bench
+ *     ./sink_bench [seconds per rate] [write ms] [write us per KiB]
+ *
+ * The real src/logging.cpp and src/log_sink.cpp run with the sink task on
+ * its own thread. Every File::write() on the fake card sleeps for a fixed
+ * latency (default 8 ms) plus a per-KiB cost (default 512 us, 2 MB/s), so a
+ * full LOG_SINK_BATCH_BYTES batch takes about 10 ms. The main thread logs
+ * ~50-byte lines at a series of steady rates; after each one the sink is
+ * flushed and allowed to catch up. The report gives, per offered rate, the
+ * lines that reached the card, the lines dropped because the ring wrapped
+ * first, and the longest Logger.log() call, which must stay short however
+ * far behind the sink is. The last lines check the rotated files against
+ * LOG_SINK_MAX_FILE_BYTES and LOG_SINK_MAX_FILES.
+ *
+ * @date 2025
+ */
+
+#include "log_sink.h"
+#include "logging.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+
+/**
+ * @brief Wait until the sink has written or dropped every record logged so far
+ * @return false if it did not catch up within timeoutMs
+ */
+static bool waitForSink(uint32_t timeoutMs)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        flushLogSink();
+        LogSinkStats stats = getLogSinkStats();
+        if (stats.records + stats.dropped >= Logger.getLastSequence())
+        {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+    hostSdWriteMs = argc > 2 ? atof(argv[2]) : hostSdWriteMs;
+    hostSdWriteUsPerKiB = argc > 3 ? atof(argv[3]) : hostSdWriteUsPerKiB;
+    if (seconds <= 0)
+    {
+        fprintf(stderr, "usage: %s [seconds per rate] [write ms] [write us per KiB]\n", argv[0]);
+        return 2;
+    }
+
+    initLogSink();
+    waitForSink(5000);
+
+    const uint32_t rates[] = {500, 1000, 2000, 3000, 4000, 6000, 8000, 12000, 16000};
+    printf("fake SD: %.1f ms + %.0f us/KiB per write; ring %d bytes, batch %d bytes, %.1f s per rate\n",
+           hostSdWriteMs, hostSdWriteUsPerKiB, LOG_RING_BYTES, LOG_SINK_BATCH_BYTES, seconds);
+    printf("  %8s %10s %10s %8s %8s %12s\n", "offered", "written/s", "dropped", "drop%", "writes", "max log() us");
+
+    uint32_t sustained = 0;
+    uint32_t line = 0;
+    for (uint32_t rate : rates)
+    {
+        LogSinkStats before = getLogSinkStats();
+        auto start = std::chrono::steady_clock::now();
+        auto end = start + std::chrono::microseconds((long long)(seconds * 1e6));
+        uint64_t issued = 0;
+        int64_t worstLogNs = 0;
+
+        // Issue every line that is due, then sleep 1 ms, so the rate holds on average
+        for (auto now = start; now < end; now = std::chrono::steady_clock::now())
+        {
+            uint64_t due = (uint64_t)(std::chrono::duration<double>(now - start).count() * rate);
+            while (issued < due)
+            {
+                auto callStart = std::chrono::steady_clock::now();
+                Logger.log(LOG_MODULE_AUDIO, LOG_LEVEL_INFO, "🎵 Starting audio playback: /audio/yes/clip_%u.mp3",
+                           (unsigned)line++);
+                int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::steady_clock::now() - callStart).count();
+                worstLogNs = ns > worstLogNs ? ns : worstLogNs;
+                issued++;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!waitForSink(10000))
+        {
+            fprintf(stderr, "sink did not catch up at %u lines/s\n", (unsigned)rate);
+            return 1;
+        }
+
+        LogSinkStats after = getLogSinkStats();
+        uint32_t written = after.records - before.records;
+        uint32_t dropped = after.dropped - before.dropped;
+        printf("  %8u %10.0f %10u %7.2f%% %8u %12.1f\n", (unsigned)rate, written / elapsed, (unsigned)dropped,
+               100.0 * dropped / (issued ? issued : 1), (unsigned)(after.writes - before.writes), worstLogNs / 1000.0);
+        if (dropped == 0)
+        {
+            sustained = rate;
+        }
+    }
+
+    LogSinkStats stats = getLogSinkStats();
+    printf("highest rate with no drops: %u lines/s; longest SD write %.1f ms; %u rotations, %u write errors\n",
+           (unsigned)sustained, stats.maxWriteUs / 1000.0, (unsigned)stats.rotations, (unsigned)stats.writeErrors);
+
+    // Rotation must keep every file under the cap and no more than LOG_SINK_MAX_FILES of them
+    bool ok = stats.writeErrors == 0;
+    std::lock_guard<std::mutex> hold(hostFileSystem.lock);
+    for (const auto& file : hostFileSystem.files)
+    {
+        printf("  %-14s %8zu bytes\n", file.first.c_str(), file.second.size());
+        ok = ok && file.second.size() <= LOG_SINK_MAX_FILE_BYTES;
+    }
+    ok = ok && hostFileSystem.files.size() <= LOG_SINK_MAX_FILES;
+    printf("%s\n", ok ? "rotation ok" : "rotation FAILED");
+    return ok ? 0 : 1;
+}
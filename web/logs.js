@@ -0,0 +1,16 @@
+var last=0,max=500,busy=false,again=false,es=null,box=document.getElementById('logs'),stats=document.getElementById('stats');
+function add(e){var d=document.createElement('div');d.className='log l'+e.level;
+d.textContent=e.t+'ms: '+e.msg;box.insertBefore(d,box.firstChild);last=e.seq;
+while(box.childNodes.length>max&&box.lastChild)box.removeChild(box.lastChild);}
+function poll(){if(busy){again=true;return;}busy=true;
+fetch('/logs.json?since='+last).then(function(r){return r.status==200?r.json():null;}).then(function(j){
+if(!j)return;
+if(j.last<last)box.innerHTML='';
+j.logs.forEach(add);max=Math.max(j.count,1);
+while(box.childNodes.length>max&&box.lastChild)box.removeChild(box.lastChild);
+last=j.last;stats.textContent='Total Messages: '+j.count+' | Free RAM: '+j.freeRam+' bytes';
+}).catch(function(){}).then(function(){busy=false;if(again){again=false;poll();}else if(!es)setTimeout(poll,5000);});}
+if(window.EventSource){es=new EventSource('/events');
+es.addEventListener('log',function(m){var e=JSON.parse(m.data);if(busy||e.seq>last+1)poll();else if(e.seq>last)add(e);});
+es.onerror=function(){if(es.readyState==2){es=null;poll();}};}
+poll();